@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#include "UBBenchmark.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+
+#include "adaptors/UBExportFullPDF.h"
+#include "adaptors/UBExportPDF.h"
+#include "adaptors/UBSvgSubsetAdaptor.h"
+#include "adaptors/UBThumbnailAdaptor.h"
+#include "core/UBImageCache.h"
+#include "core/UBSceneCache.h"
+#include "document/UBDocumentProxy.h"
+#include "domain/UBGraphicsScene.h"
+#include "domain/UBGraphicsStrokeItem.h"
+#include "frameworks/UBGeometryUtils.h"
+
+namespace
+{
+    // width of the images the pages are rendered to, a full HD board
+    constexpr int cRenderWidth{1920};
+
+    // the eraser sweeps the page in rows, with the segment length of a fast tablet stroke
+    constexpr qreal cEraserWidth{30};
+    constexpr qreal cEraserRowSpacing{60};
+    constexpr qreal cEraserStep{20};
+
+    // strokes of the eraser check, with a fixed seed so that a failure can be reproduced
+    constexpr int cCheckedStrokes{20};
+    constexpr int cCheckedPointsPerStroke{50};
+    constexpr quint32 cCheckSeed{42};
+
+    double milliseconds(qint64 nanoseconds)
+    {
+        return nanoseconds / 1e6;
+    }
+}
+
+UBBenchmark::UBBenchmark(std::shared_ptr<UBDocumentProxy> proxy, int iterations)
+    : mProxy{proxy}
+    , mIterations{iterations}
+{
+}
+
+void UBBenchmark::run()
+{
+    benchmarkLoad();
+    benchmarkSave();
+    benchmarkSceneCache();
+    benchmarkRender();
+    benchmarkThumbnails();
+    benchmarkExport();
+    benchmarkEraser();
+}
+
+bool UBBenchmark::check() const
+{
+    return checkEraser();
+}
+
+void UBBenchmark::report(QTextStream& out) const
+{
+    out << QString("%1 %2 %3 %4 %5 %6")
+           .arg("case", -20)
+           .arg("items", 6)
+           .arg("min (ms)", 12)
+           .arg("median (ms)", 12)
+           .arg("max (ms)", 12)
+           .arg("median/item", 12)
+        << "\n";
+
+    for (const Measurement& measurement : mMeasurements)
+    {
+        const qint64 median = measurement.durations.at(measurement.durations.size() / 2);
+
+        out << QString("%1 %2 %3 %4 %5 %6")
+               .arg(measurement.name, -20)
+               .arg(measurement.itemCount, 6)
+               .arg(milliseconds(measurement.durations.first()), 12, 'f', 2)
+               .arg(milliseconds(median), 12, 'f', 2)
+               .arg(milliseconds(measurement.durations.last()), 12, 'f', 2)
+               .arg(milliseconds(median) / qMax(1, measurement.itemCount), 12, 'f', 3)
+            << "\n";
+    }
+}
+
+bool UBBenchmark::writeCsv(const QString& fileName) const
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "case,items,iterations,min_ms,median_ms,max_ms\n";
+
+    for (const Measurement& measurement : mMeasurements)
+    {
+        const qint64 median = measurement.durations.at(measurement.durations.size() / 2);
+
+        out << measurement.name << ","
+            << measurement.itemCount << ","
+            << measurement.durations.size() << ","
+            << milliseconds(measurement.durations.first()) << ","
+            << milliseconds(median) << ","
+            << milliseconds(measurement.durations.last()) << "\n";
+    }
+
+    return true;
+}
+
+void UBBenchmark::measure(const QString& name, int itemCount, const std::function<void()>& prepare, const std::function<void()>& operation)
+{
+    qInfo().noquote() << "Measuring" << name;
+
+    Measurement measurement{name, itemCount, {}};
+    QElapsedTimer timer;
+
+    for (int i = 0; i < mIterations; ++i)
+    {
+        if (prepare)
+        {
+            prepare();
+        }
+
+        timer.start();
+        operation();
+        measurement.durations << timer.nsecsElapsed();
+
+        // deferred deletions and queued callbacks of the iteration are not part of the measurement
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCoreApplication::processEvents();
+    }
+
+    std::sort(measurement.durations.begin(), measurement.durations.end());
+    mMeasurements << measurement;
+}
+
+/**
+ * @brief Open the document again, the caches keyed on the document then start empty.
+ */
+std::shared_ptr<UBDocumentProxy> UBBenchmark::openDocument() const
+{
+    auto proxy = std::make_shared<UBDocumentProxy>(mProxy->persistencePath());
+    proxy->setPageCount(mProxy->pageCount());
+    return proxy;
+}
+
+QList<std::shared_ptr<UBGraphicsScene>> UBBenchmark::loadScenes() const
+{
+    QList<std::shared_ptr<UBGraphicsScene>> scenes;
+
+    for (int pageIndex = 0; pageIndex < mProxy->pageCount(); ++pageIndex)
+    {
+        // include the decoding of the images, which the board does in the background
+        std::shared_ptr<UBGraphicsScene> scene = UBSvgSubsetAdaptor::loadScene(mProxy, pageIndex);
+        scene->finishImageLoading();
+        scenes << scene;
+    }
+
+    return scenes;
+}
+
+void UBBenchmark::benchmarkLoad()
+{
+    measure("load", mProxy->pageCount(), [](){
+        UBImageCache::instance().clear();
+    }, [this](){
+        loadScenes();
+    });
+}
+
+void UBBenchmark::benchmarkSave()
+{
+    const QList<std::shared_ptr<UBGraphicsScene>> scenes = loadScenes();
+
+    measure("save", scenes.size(), nullptr, [this, &scenes](){
+        for (int pageIndex = 0; pageIndex < scenes.size(); ++pageIndex)
+        {
+            UBSvgSubsetAdaptor::persistScene(mProxy, scenes.at(pageIndex), pageIndex);
+        }
+    });
+}
+
+void UBBenchmark::benchmarkSceneCache()
+{
+    UBSceneCache cache;
+    const std::shared_ptr<UBDocumentProxy> proxy = openDocument();
+
+    // the same calls as the persistence manager, a page which is still cached is not loaded again
+    const auto loadPages = [&cache, proxy](){
+        for (int pageIndex = 0; pageIndex < proxy->pageCount(); ++pageIndex)
+        {
+            cache.prepareLoading(proxy, pageIndex);
+            cache.value(proxy, pageIndex);
+        }
+    };
+
+    measure("scene cache miss", proxy->pageCount(), [&cache, proxy](){
+        UBImageCache::instance().clear();
+        cache.removeAllScenes(proxy);
+    }, loadPages);
+
+    measure("scene cache hit", proxy->pageCount(), nullptr, loadPages);
+
+    cache.removeAllScenes(proxy);
+}
+
+void UBBenchmark::benchmarkRender()
+{
+    const QList<std::shared_ptr<UBGraphicsScene>> scenes = loadScenes();
+
+    if (scenes.isEmpty())
+    {
+        return;
+    }
+
+    const QSizeF nominalSize = scenes.first()->nominalSize();
+    const QSizeF size(cRenderWidth, cRenderWidth * nominalSize.height() / nominalSize.width());
+    QImage image(size.toSize(), QImage::Format_ARGB32_Premultiplied);
+
+    measure("render", scenes.size(), nullptr, [&scenes, &image, size](){
+        for (const auto& scene : scenes)
+        {
+            UBThumbnailAdaptor::renderScene(scene, &image, size);
+        }
+    });
+}
+
+void UBBenchmark::benchmarkThumbnails()
+{
+    const QList<std::shared_ptr<UBGraphicsScene>> scenes = loadScenes();
+
+    // the thumbnails are saved like the application does, the scene is rendered on this thread
+    // and the image is written by the thumbnail pool, an iteration lasts until all files are written
+    const auto prepare = [&scenes](){
+        for (const auto& scene : scenes)
+        {
+            scene->setModified(true);
+        }
+    };
+
+    measure("thumbnails", scenes.size(), prepare, [this, &scenes](){
+        for (int pageIndex = 0; pageIndex < scenes.size(); ++pageIndex)
+        {
+            UBThumbnailAdaptor::persistSceneInBackground(mProxy, scenes.at(pageIndex), pageIndex);
+        }
+
+        for (int pageIndex = 0; pageIndex < scenes.size(); ++pageIndex)
+        {
+            UBThumbnailAdaptor::waitForPendingThumbnail(mProxy->thumbnailFilePath(pageIndex));
+        }
+    });
+}
+
+void UBBenchmark::benchmarkExport()
+{
+    QTemporaryDir exportDirectory;
+    const QString fileName = exportDirectory.filePath("export.pdf");
+    std::shared_ptr<UBDocumentProxy> proxy;
+
+    // a new proxy for each iteration, so that the pages are not taken from the scene cache
+    const auto prepare = [this, &proxy](){
+        UBImageCache::instance().clear();
+        proxy = openDocument();
+    };
+
+    measure("export PDF", mProxy->pageCount(), prepare, [&proxy, &fileName](){
+        UBExportPDF exporter;
+        exporter.persistsDocument(proxy, fileName);
+    });
+
+    measure("export full PDF", mProxy->pageCount(), prepare, [&proxy, &fileName](){
+        UBExportFullPDF exporter;
+        exporter.persistsDocument(proxy, fileName);
+    });
+}
+
+void UBBenchmark::benchmarkEraser()
+{
+    if (mProxy->pageCount() == 0)
+    {
+        return;
+    }
+
+    std::shared_ptr<UBGraphicsScene> scene = UBSvgSubsetAdaptor::loadScene(mProxy, 0);
+    const QSizeF nominalSize = scene->nominalSize();
+    const QRectF rect(QPointF(-nominalSize.width() / 2, -nominalSize.height() / 2), nominalSize);
+
+    int lineCount = 0;
+
+    for (qreal y = rect.top() + cEraserRowSpacing / 2; y < rect.bottom(); y += cEraserRowSpacing)
+    {
+        for (qreal x = rect.left() + cEraserStep; x < rect.right(); x += cEraserStep)
+        {
+            ++lineCount;
+        }
+    }
+
+    // each iteration erases a freshly loaded first page
+    measure("eraser", lineCount, [this, &scene](){
+        scene = UBSvgSubsetAdaptor::loadScene(mProxy, 0);
+    }, [&scene, rect](){
+        for (qreal y = rect.top() + cEraserRowSpacing / 2; y < rect.bottom(); y += cEraserRowSpacing)
+        {
+            scene->moveTo(QPointF(rect.left(), y));
+
+            for (qreal x = rect.left() + cEraserStep; x < rect.right(); x += cEraserStep)
+            {
+                scene->eraseLineTo(QPointF(x, y), cEraserWidth);
+            }
+        }
+    });
+}
+
+bool UBBenchmark::checkEraser() const
+{
+    // the outline of a whole stroke intersects itself, it must still be erased
+    // without falling back on QPainterPath, as well as each of its segments
+    QRandomGenerator random(cCheckSeed);
+    int subtracted = 0;
+    int unsupported = 0;
+
+    for (int i = 0; i < cCheckedStrokes; ++i)
+    {
+        QList<QPair<QPointF, qreal> > points;
+        QPointF point;
+        const qreal width = 2 + random.bounded(8.0);
+        const bool pressure = i % 2 != 0;
+
+        for (int j = 0; j < cCheckedPointsPerStroke; ++j)
+        {
+            points << qMakePair(point, pressure ? width * (0.5 + random.bounded(1.0)) : width);
+            point += QPointF(random.bounded(40.0) - 20, random.bounded(40.0) - 20);
+        }
+
+        const UBGraphicsStrokeItem strokeItem(points);
+        QList<QPolygonF> subjects{strokeItem.polygon()};
+
+        for (int j = 0; j < points.size() - 1; ++j)
+        {
+            subjects << strokeItem.segmentPolygon(j);
+        }
+
+        const QRectF rect = strokeItem.polygon().boundingRect();
+
+        for (qreal y = rect.top(); y < rect.bottom(); y += cEraserWidth)
+        {
+            const QPolygonF eraser = UBGeometryUtils::lineToPolygon(QLineF(rect.left(), y, rect.right(), y + cEraserWidth), cEraserWidth);
+
+            for (const QPolygonF& subject : std::as_const(subjects))
+            {
+                QList<QPolygonF> parts;
+
+                switch (UBGeometryUtils::subtractConvexPolygon(subject, eraser, parts))
+                {
+                case UBGeometryUtils::Subtracted:
+                    ++subtracted;
+                    break;
+
+                case UBGeometryUtils::Unsupported:
+                    ++unsupported;
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+    }
+
+    if (unsupported > 0 || subtracted == 0)
+    {
+        qCritical() << "eraser check:" << unsupported << "polygons fall back on QPainterPath," << subtracted << "subtracted";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+class UBDocumentProxy;
+class UBGraphicsScene;
+class QTextStream;
+
+/**
+ * @brief The UBBenchmark class measures the main document operations on a document.
+ *
+ * Each case runs a number of iterations, with an untimed preparation before each of them,
+ * and keeps the duration of every iteration. The report gives the minimum, median and maximum
+ * durations, the median is the value to compare between builds. The checks verify that the
+ * measured code takes the paths it is meant to take, as a regression there would only show
+ * up as slower measurements.
+ */
+class UBBenchmark
+{
+public:
+    UBBenchmark(std::shared_ptr<UBDocumentProxy> proxy, int iterations);
+
+    void run();
+    bool check() const;
+
+    void report(QTextStream& out) const;
+    bool writeCsv(const QString& fileName) const;
+
+private:
+    struct Measurement
+    {
+        QString name;
+        int itemCount;              // pages or lines processed by each iteration
+        QList<qint64> durations;    // nanoseconds, sorted
+    };
+
+    void measure(const QString& name, int itemCount, const std::function<void()>& prepare, const std::function<void()>& operation);
+
+    std::shared_ptr<UBDocumentProxy> openDocument() const;
+    QList<std::shared_ptr<UBGraphicsScene>> loadScenes() const;
+
+    void benchmarkLoad();
+    void benchmarkSave();
+    void benchmarkSceneCache();
+    void benchmarkRender();
+    void benchmarkThumbnails();
+    void benchmarkExport();
+    void benchmarkEraser();
+
+    bool checkEraser() const;
+
+    std::shared_ptr<UBDocumentProxy> mProxy;
+    int mIterations;
+    QList<Measurement> mMeasurements;
+};
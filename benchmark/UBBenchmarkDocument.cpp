@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#include "UBBenchmarkDocument.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QRandomGenerator>
+#include <QUuid>
+
+#include "adaptors/UBImportPDF.h"
+#include "adaptors/UBMetadataDcSubsetAdaptor.h"
+#include "adaptors/UBSvgSubsetAdaptor.h"
+#include "core/UB.h"
+#include "core/UBSettings.h"
+#include "document/UBDocumentProxy.h"
+#include "domain/UBGraphicsScene.h"
+#include "domain/UBGraphicsStroke.h"
+#include "domain/UBGraphicsStrokeItem.h"
+#include "domain/UBGraphicsStrokesGroup.h"
+#include "frameworks/UBStringUtils.h"
+
+namespace
+{
+    // size of the generated images, large enough to make decoding and mip levels measurable
+    constexpr int cImageWidth{1600};
+    constexpr int cImageHeight{1200};
+
+    QRectF pageRect(std::shared_ptr<UBGraphicsScene> scene)
+    {
+        const QSizeF size = scene->nominalSize();
+        return QRectF(QPointF(-size.width() / 2, -size.height() / 2), size);
+    }
+
+    QPointF randomPoint(QRandomGenerator& random, const QRectF& rect)
+    {
+        return QPointF(rect.left() + random.bounded(rect.width()), rect.top() + random.bounded(rect.height()));
+    }
+
+    QColor randomColor(QRandomGenerator& random)
+    {
+        return QColor::fromHsv(random.bounded(360), 200, 200);
+    }
+}
+
+/**
+ * @brief Generate a document in an empty directory.
+ * @return the document, or nullptr if the directory cannot be created
+ */
+std::shared_ptr<UBDocumentProxy> UBBenchmarkDocument::generate(const QString& path, const Parameters& parameters)
+{
+    if (!QDir().mkpath(path))
+    {
+        return nullptr;
+    }
+
+    auto proxy = std::make_shared<UBDocumentProxy>(path);
+    const QString now = UBStringUtils::toUtcIsoDateTime(QDateTime::currentDateTime());
+
+    proxy->setMetaData(UBSettings::documentName, "Benchmark");
+    proxy->setMetaData(UBSettings::documentVersion, UBSettings::currentFileVersion);
+    proxy->setMetaData(UBSettings::documentUpdatedAt, now);
+    proxy->setMetaData(UBSettings::documentDate, now);
+
+    QRandomGenerator random(parameters.seed);
+
+    // the backgrounds are imported from a temporary PDF, persisting the pages embeds it in the document
+    UBImportPDF pdfImporter;
+    QList<UBGraphicsItem*> pdfPages;
+    const QString pdfFileName = path + "/background.pdf";
+
+    if (parameters.pdfBackground)
+    {
+        writeBackgroundPdf(pdfFileName, parameters.pages, proxy->defaultDocumentSize());
+        pdfPages = pdfImporter.import(QUuid::createUuid(), pdfFileName);
+    }
+
+    for (int pageIndex = 0; pageIndex < parameters.pages; ++pageIndex)
+    {
+        auto scene = std::make_shared<UBGraphicsScene>(proxy, false);
+        scene->setNominalSize(proxy->defaultDocumentSize());
+
+        if (pageIndex < pdfPages.size())
+        {
+            pdfImporter.placeImportedItemToScene(scene, pdfPages.at(pageIndex));
+        }
+
+        addImages(scene, parameters, random);
+        addTexts(scene, parameters, random);
+        addStrokes(scene, parameters, random);
+        scene->deselectAllItems();
+
+        UBSvgSubsetAdaptor::persistScene(proxy, scene, pageIndex);
+        proxy->incPageCount();
+    }
+
+    UBMetadataDcSubsetAdaptor::persist(proxy);
+    QFile::remove(pdfFileName);
+
+    return proxy;
+}
+
+void UBBenchmarkDocument::writeBackgroundPdf(const QString& fileName, int pageCount, const QSize& pageSize)
+{
+    QPdfWriter pdfWriter(fileName);
+    pdfWriter.setResolution(72);
+    pdfWriter.setPageMargins(QMarginsF());
+    pdfWriter.setPageSize(QPageSize(QSizeF(pageSize), QPageSize::Point));
+
+    QPainter painter(&pdfWriter);
+    QFont font = painter.font();
+    font.setPointSize(24);
+    painter.setFont(font);
+
+    for (int pageIndex = 0; pageIndex < pageCount; ++pageIndex)
+    {
+        if (pageIndex > 0)
+        {
+            pdfWriter.newPage();
+        }
+
+        // a lined sheet with a title, like a typical worksheet
+        painter.setPen(QPen(Qt::lightGray, 1));
+
+        for (int y = 120; y < pageSize.height(); y += 40)
+        {
+            painter.drawLine(60, y, pageSize.width() - 60, y);
+        }
+
+        painter.setPen(Qt::black);
+        painter.drawText(QRect(60, 30, pageSize.width() - 120, 60), Qt::AlignLeft | Qt::AlignVCenter,
+                         QString("Benchmark worksheet %1").arg(pageIndex + 1));
+    }
+}
+
+void UBBenchmarkDocument::addStrokes(std::shared_ptr<UBGraphicsScene> scene, const Parameters& parameters, QRandomGenerator& random)
+{
+    const QRectF rect = pageRect(scene);
+
+    for (int i = 0; i < parameters.strokesPerPage; ++i)
+    {
+        // a random walk looks enough like handwriting for the polygon code, every other
+        // stroke is drawn with a varying pressure
+        QList<QPair<QPointF, qreal> > points;
+        QPointF point = randomPoint(random, rect);
+        const qreal width = 2 + random.bounded(8.0);
+        const bool pressure = i % 2 != 0;
+
+        for (int j = 0; j < parameters.pointsPerStroke; ++j)
+        {
+            points << qMakePair(point, pressure ? width * (0.5 + random.bounded(1.0)) : width);
+            point += QPointF(random.bounded(40.0) - 20, random.bounded(40.0) - 20);
+        }
+
+        UBGraphicsStrokeItem* polygonItem = new UBGraphicsStrokeItem(points);
+        const QColor color = randomColor(random);
+
+        polygonItem->setColorOnDarkBackground(color);
+        polygonItem->setColorOnLightBackground(color);
+        polygonItem->setColor(color);
+        polygonItem->setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Graphic));
+
+        UBGraphicsStrokesGroup* group = new UBGraphicsStrokesGroup();
+        polygonItem->setStrokesGroup(group);
+        polygonItem->setStroke(new UBGraphicsStroke());
+        group->addToGroup(polygonItem);
+
+        scene->addItem(group);
+    }
+}
+
+void UBBenchmarkDocument::addImages(std::shared_ptr<UBGraphicsScene> scene, const Parameters& parameters, QRandomGenerator& random)
+{
+    const QRectF rect = pageRect(scene);
+
+    for (int i = 0; i < parameters.imagesPerPage; ++i)
+    {
+        QImage image(cImageWidth, cImageHeight, QImage::Format_RGB32);
+
+        {
+            QLinearGradient gradient(0, 0, cImageWidth, cImageHeight);
+            gradient.setColorAt(0, randomColor(random));
+            gradient.setColorAt(1, randomColor(random));
+
+            QPainter painter(&image);
+            painter.fillRect(image.rect(), gradient);
+            painter.setPen(Qt::NoPen);
+
+            // some detail, so that the images do not compress to nothing
+            for (int j = 0; j < 200; ++j)
+            {
+                const int radius = 10 + random.bounded(90);
+                painter.setBrush(randomColor(random));
+                painter.drawEllipse(randomPoint(random, image.rect()), radius, radius);
+            }
+        }
+
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "JPG", 85);
+
+        const qreal scaleFactor = rect.width() / 3 / cImageWidth;
+        scene->addImage(data, nullptr, randomPoint(random, rect), scaleFactor, false, true);
+    }
+}
+
+void UBBenchmarkDocument::addTexts(std::shared_ptr<UBGraphicsScene> scene, const Parameters& parameters, QRandomGenerator& random)
+{
+    const QRectF rect = pageRect(scene);
+
+    for (int i = 0; i < parameters.textsPerPage; ++i)
+    {
+        scene->addTextWithFont(QString("Synthetic text item %1, with a few words to lay out").arg(i + 1),
+                               randomPoint(random, rect), 12 + random.bounded(24));
+    }
+}
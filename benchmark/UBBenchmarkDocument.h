@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#pragma once
+
+#include <QSize>
+#include <QString>
+
+#include <memory>
+
+class UBDocumentProxy;
+class UBGraphicsScene;
+class QRandomGenerator;
+
+/**
+ * @brief The UBBenchmarkDocument class generates the synthetic document measured by the benchmark.
+ *
+ * The pages are built with the same items the board creates: strokes, images, texts and an
+ * optional PDF background, and are persisted with the regular adaptors. The content only depends
+ * on the parameters, so that measurements of different builds can be compared.
+ */
+class UBBenchmarkDocument
+{
+public:
+    struct Parameters
+    {
+        int pages{20};
+        int strokesPerPage{200};
+        int pointsPerStroke{40};
+        int imagesPerPage{2};
+        int textsPerPage{10};
+        bool pdfBackground{true};
+        quint32 seed{1};
+    };
+
+    static std::shared_ptr<UBDocumentProxy> generate(const QString& path, const Parameters& parameters);
+
+private:
+    static void writeBackgroundPdf(const QString& fileName, int pageCount, const QSize& pageSize);
+    static void addStrokes(std::shared_ptr<UBGraphicsScene> scene, const Parameters& parameters, QRandomGenerator& random);
+    static void addImages(std::shared_ptr<UBGraphicsScene> scene, const Parameters& parameters, QRandomGenerator& random);
+    static void addTexts(std::shared_ptr<UBGraphicsScene> scene, const Parameters& parameters, QRandomGenerator& random);
+};
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QLoggingCategory>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "core/UBApplication.h"
+#include "document/UBDocumentProxy.h"
+
+#include "UBBenchmark.h"
+#include "UBBenchmarkDocument.h"
+
+/**
+ * openboard-bench generates a synthetic document and measures loading, saving, rendering,
+ * thumbnails, PDF export and the eraser on it. It runs headless by default:
+ *
+ *     openboard-bench --pages 50 --iterations 5 --csv results.csv
+ *
+ * It also checks that the eraser subtracts real stroke outlines without QPainterPath,
+ * and exits with 1 if a check fails.
+ */
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    // keep the settings and documents of the user out of the measurements
+    QStandardPaths::setTestModeEnabled(true);
+
+    Q_INIT_RESOURCE(OpenBoard);
+
+    // same requirement as the application, QtWebEngine is created by the controllers
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
+    UBApplication app("OpenBoard", argc, argv);
+
+    UBBenchmarkDocument::Parameters parameters;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the document operations of OpenBoard on a synthetic document.");
+    parser.addHelpOption();
+
+    const QCommandLineOption pagesOption("pages", "Number of pages.", "count", QString::number(parameters.pages));
+    const QCommandLineOption strokesOption("strokes", "Strokes per page.", "count", QString::number(parameters.strokesPerPage));
+    const QCommandLineOption pointsOption("points", "Points per stroke.", "count", QString::number(parameters.pointsPerStroke));
+    const QCommandLineOption imagesOption("images", "Images per page.", "count", QString::number(parameters.imagesPerPage));
+    const QCommandLineOption textsOption("texts", "Text items per page.", "count", QString::number(parameters.textsPerPage));
+    const QCommandLineOption noPdfOption("no-pdf", "Do not add PDF backgrounds.");
+    const QCommandLineOption iterationsOption("iterations", "Iterations of each case.", "count", "5");
+    const QCommandLineOption csvOption("csv", "Also write the results to a CSV file.", "file");
+    const QCommandLineOption verboseOption("verbose", "Show the debug output of the application.");
+
+    parser.addOptions({pagesOption, strokesOption, pointsOption, imagesOption, textsOption,
+                       noPdfOption, iterationsOption, csvOption, verboseOption});
+    parser.process(app);
+
+    parameters.pages = qMax(1, parser.value(pagesOption).toInt());
+    parameters.strokesPerPage = qMax(0, parser.value(strokesOption).toInt());
+    parameters.pointsPerStroke = qMax(2, parser.value(pointsOption).toInt());
+    parameters.imagesPerPage = qMax(0, parser.value(imagesOption).toInt());
+    parameters.textsPerPage = qMax(0, parser.value(textsOption).toInt());
+    parameters.pdfBackground = !parser.isSet(noPdfOption);
+
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    if (!parser.isSet(verboseOption))
+        QLoggingCategory::setFilterRules("*.debug=false");
+
+    app.setup(QString());
+
+    QTemporaryDir documentDirectory;
+    std::shared_ptr<UBDocumentProxy> proxy = UBBenchmarkDocument::generate(documentDirectory.filePath("document"), parameters);
+
+    if (!proxy)
+    {
+        qCritical() << "cannot create the benchmark document in" << documentDirectory.path();
+        return 1;
+    }
+
+    UBBenchmark benchmark(proxy, iterations);
+
+    int result = 0;
+
+    if (!benchmark.check())
+    {
+        result = 1;
+    }
+
+    benchmark.run();
+
+    QTextStream out(stdout);
+    out << parameters.pages << " pages, " << parameters.strokesPerPage << " strokes, "
+        << parameters.imagesPerPage << " images and " << parameters.textsPerPage << " texts per page"
+        << (parameters.pdfBackground ? ", PDF backgrounds" : "") << ", "
+        << iterations << " iterations\n\n";
+    benchmark.report(out);
+    out.flush();
+
+    if (parser.isSet(csvOption) && !benchmark.writeCsv(parser.value(csvOption)))
+    {
+        qCritical() << "cannot write" << parser.value(csvOption);
+        result = 1;
+    }
+
+    app.cleanup();
+
+    return result;
+}
@@ -29,13 +29,16 @@
 #include "UBExportCFF.h"
 #include "UBCFFAdaptor.h"
 #include "document/UBDocumentProxy.h"
+#include "frameworks/UBFileSystemUtils.h"
 #include "core/UBDocumentManager.h"
 #include "core/UBApplication.h"
+#include "core/UBPersistenceManager.h"
 #include "core/memcheck.h"
 #include "document/UBDocumentController.h"
 
 #include <QModelIndex>
 #include <QObject>
+#include <QTemporaryDir>
 
 
 UBExportCFF::UBExportCFF(QObject *parent)
@@ -74,6 +77,16 @@ void UBExportCFF::persist(std::shared_ptr<UBDocumentProxy> pDocument)
         if (mIsVerbose)
             UBApplication::showMessage(tr("Exporting document..."));
 
+            // the converter only knows the legacy page file names
+            QTemporaryDir legacyCopy;
+
+            if (pDocument->hasPageManifest() && legacyCopy.isValid()
+                    && UBFileSystemUtils::copyDir(src, legacyCopy.path())
+                    && UBPersistenceManager::convertToLegacyLayout(legacyCopy.path()))
+            {
+                src = legacyCopy.path();
+            }
+
             UBCFFAdaptor toIWBExporter;
             if (toIWBExporter.convertUBZToIWB(src, filename))
             {
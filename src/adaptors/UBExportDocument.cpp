@@ -33,6 +33,7 @@
 
 #include "core/UBDocumentManager.h"
 #include "core/UBApplication.h"
+#include "core/UBPersistenceManager.h"
 
 #include "document/UBDocumentProxy.h"
 #include "document/UBDocumentController.h"
@@ -79,7 +80,9 @@ bool UBExportDocument::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocume
     QDir documentDir = QDir(pDocumentProxy->persistencePath());
 
     QuaZipFile outFile(&zip);
-    UBFileSystemUtils::compressDirInZip(documentDir, "", &outFile, true, this);
+    // documents with a page manifest are exported with the legacy page file names
+    UBFileSystemUtils::compressDirInZip(documentDir, "", &outFile, true, this,
+                                        UBPersistenceManager::legacyPageFileNames(pDocumentProxy));
 
     zip.close();
 
@@ -116,7 +116,8 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
 
             bool sceneHasPDFBackground = false;
 
-            // set high res rendering
+            // set high res rendering, with all the images decoded
+            scene->finishImageLoading();
             scene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
             scene->setRenderingContext(UBGraphicsScene::PdfExport);
 
@@ -137,6 +138,9 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
                 sceneHasPDFBackground = false;
             }
 
+            // the page is loaded only once, so take the merge geometry now
+            mMergeInfo.push_back(mergePageDescription(pDocumentProxy, scene, pageIndex));
+
             QPageSize size(pageSize, QPageSize::Point);
             pdfPrinter.setPageSize(size);
 
@@ -180,6 +184,85 @@ void UBExportFullPDF::saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentP
 }
 
 
+merge_lib::MergePageDescription UBExportFullPDF::mergePageDescription(std::shared_ptr<UBDocumentProxy> pDocumentProxy, std::shared_ptr<UBGraphicsScene> scene, int pageIndex) const
+{
+    // factor between scene coordinates and PDF coordinates
+    double dpiScale = 72. / pDocumentProxy->pageDpi();
+
+    UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
+
+    if (pdfItem)
+    {
+        QString pdfName = UBPersistenceManager::objectDirectory + "/" + pdfItem->fileUuid().toString() + ".pdf";
+        QString backgroundPath = pDocumentProxy->persistencePath() + "/" + pdfName;
+
+        // Original data in scene coordinates, annotationsRect always contains pdfSceneRect
+        QRectF pdfSceneRect = pdfItem->sceneBoundingRect();
+        QRectF annotationsRect = scene->normalizedSceneRect();
+
+        double xAnnotation = annotationsRect.x();
+        double yAnnotation = annotationsRect.y();
+        double xPdf = pdfSceneRect.x();
+        double yPdf = pdfSceneRect.y();
+        double hPdf = pdfSceneRect.height();
+
+        // Exportation-transformed data, scaleFactor always <= 1
+        double hScaleFactor = pdfSceneRect.width() / annotationsRect.width();
+        double vScaleFactor = pdfSceneRect.height() / annotationsRect.height();
+        double scaleFactor = qMin(hScaleFactor, vScaleFactor);
+
+        double xAnnotationsOffset = 0;
+        double yAnnotationsOffset = 0;
+        double hPdfTransformed = hPdf * scaleFactor;
+
+        // Compute scaling of PDF on the scene
+        // If the PDF was scaled when added to the scene (e.g if it was loaded from a document with a different DPI
+        // than the current one), it should also be scaled here.
+        QSizeF pageSize = pdfItem->pageSize();
+        double pdfScale = pdfSceneRect.width() / pageSize.width() * dpiScale;
+
+        // Offsets are calculated in the PDF coordinate system.
+        // It has its origin at the lower left corner and is measured in points of 1/72 inch.
+        // Here, we force the PDF page to be on the topleft corner of the page
+        double xPdfOffset = 0;
+        double yPdfOffset = (hPdf - hPdfTransformed) * dpiScale / pdfScale;
+
+        // Now we align the items
+        xPdfOffset += (xPdf - xAnnotation) * scaleFactor * dpiScale / pdfScale;
+        yPdfOffset -= (yPdf - yAnnotation) * scaleFactor * dpiScale / pdfScale;
+
+        TransformationDescription pdfTransform(xPdfOffset, yPdfOffset, scaleFactor, 0);
+        TransformationDescription annotationTransform(xAnnotationsOffset, yAnnotationsOffset, 1, 0);
+
+        MergePageDescription pageDescription(pageSize.width(),
+                                             pageSize.height(),
+                                             pdfItem->pageNumber(),
+                                             QFile::encodeName(backgroundPath).constData(),
+                                             pdfTransform,
+                                             pageIndex + 1,
+                                             annotationTransform,
+                                             false, false);
+
+        return pageDescription;
+    }
+    else
+    {
+        QSizeF pageSize = scene->nominalSize() * mScaleFactor;
+
+        MergePageDescription pageDescription(pageSize.width(),
+                 pageSize.height(),
+                 0,
+                 "",
+                 TransformationDescription(),
+                 pageIndex + 1,
+                 TransformationDescription(),
+                 false, true);
+
+        return pageDescription;
+    }
+}
+
+
 void UBExportFullPDF::persist(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
 {
     persistLocally(pDocumentProxy, tr("Export as PDF File"));
@@ -199,7 +282,9 @@ bool UBExportFullPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumen
         previousOverlay.remove();
 
     mHasPDFBackgrounds = false;
+    mMergeInfo.clear();
 
+    // renders the overlay and collects the merge description in a single pass over the pages
     saveOverlayPdf(pDocumentProxy, overlayName);
 
     if (!mHasPDFBackgrounds)
@@ -209,99 +294,25 @@ bool UBExportFullPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumen
     }
     else
     {
-        Merger merger;
         try
         {
+            // the merger keeps the documents it parsed memory-mapped, it must be gone when the
+            // overlay is removed below or the raster export runs
+            Merger merger;
             merger.addOverlayDocument(QFile::encodeName(overlayName).constData());
 
-            MergeDescription mergeInfo;
-
-            // factor between scene coordinates and PDF coordinates
-            double dpiScale = 72. / pDocumentProxy->pageDpi();
-
-            int existingPageCount = pDocumentProxy->pageCount();
-
-            for(int pageIndex = 0 ; pageIndex < existingPageCount; pageIndex++)
+            for (const MergePageDescription& pageDescription : mMergeInfo)
             {
-                std::shared_ptr<UBGraphicsScene> scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex);
-                UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
-
-                if (pdfItem)
-                {
-                    QString pdfName = UBPersistenceManager::objectDirectory + "/" + pdfItem->fileUuid().toString() + ".pdf";
-                    QString backgroundPath = pDocumentProxy->persistencePath() + "/" + pdfName;
-
-                    // Original data in scene coordinates, annotationsRect always contains pdfSceneRect
-                    QRectF pdfSceneRect = pdfItem->sceneBoundingRect();
-                    QRectF annotationsRect = scene->normalizedSceneRect();
-
-                    double xAnnotation = annotationsRect.x();
-                    double yAnnotation = annotationsRect.y();
-                    double xPdf = pdfSceneRect.x();
-                    double yPdf = pdfSceneRect.y();
-                    double hPdf = pdfSceneRect.height();
-
-                    // Exportation-transformed data, scaleFactor always <= 1
-                    double hScaleFactor = pdfSceneRect.width() / annotationsRect.width();
-                    double vScaleFactor = pdfSceneRect.height() / annotationsRect.height();
-                    double scaleFactor = qMin(hScaleFactor, vScaleFactor);
-
-                    double xAnnotationsOffset = 0;
-                    double yAnnotationsOffset = 0;
-                    double hPdfTransformed = hPdf * scaleFactor;
-
-                    // Compute scaling of PDF on the scene
-                    // If the PDF was scaled when added to the scene (e.g if it was loaded from a document with a different DPI
-                    // than the current one), it should also be scaled here.
-                    QSizeF pageSize = pdfItem->pageSize();
-                    double pdfScale = pdfSceneRect.width() / pageSize.width() * dpiScale;
-
-                    // Offsets are calculated in the PDF coordinate system.
-                    // It has its origin at the lower left corner and is measured in points of 1/72 inch.
-                    // Here, we force the PDF page to be on the topleft corner of the page
-                    double xPdfOffset = 0;
-                    double yPdfOffset = (hPdf - hPdfTransformed) * dpiScale / pdfScale;
-
-                    // Now we align the items
-                    xPdfOffset += (xPdf - xAnnotation) * scaleFactor * dpiScale / pdfScale;
-                    yPdfOffset -= (yPdf - yAnnotation) * scaleFactor * dpiScale / pdfScale;
-
-                    TransformationDescription pdfTransform(xPdfOffset, yPdfOffset, scaleFactor, 0);
-                    TransformationDescription annotationTransform(xAnnotationsOffset, yAnnotationsOffset, 1, 0);
-
-                    MergePageDescription pageDescription(pageSize.width(),
-                                                         pageSize.height(),
-                                                         pdfItem->pageNumber(),
-                                                         QFile::encodeName(backgroundPath).constData(),
-                                                         pdfTransform,
-                                                         pageIndex + 1,
-                                                         annotationTransform,
-                                                         false, false);
-
-                    mergeInfo.push_back(pageDescription);
-
-                    merger.addBaseDocument(QFile::encodeName(backgroundPath).constData());
-                }
-                else
+                if (!pageDescription.skipBasePage)
                 {
-                    QSizeF pageSize = scene->nominalSize() * mScaleFactor;
-
-                    MergePageDescription pageDescription(pageSize.width(),
-                             pageSize.height(),
-                             0,
-                             "",
-                             TransformationDescription(),
-                             pageIndex + 1,
-                             TransformationDescription(),
-                             false, true);
-
-                    mergeInfo.push_back(pageDescription);
+                    merger.addBaseDocument(pageDescription.baseDocumentName.c_str());
                 }
             }
 
-            merger.merge(QFile::encodeName(overlayName).constData(), mergeInfo);
+            merger.merge(QFile::encodeName(overlayName).constData(), mMergeInfo);
 
-            merger.saveMergedDocumentsAs(QFile::encodeName(filename).constData());
+            merger.saveMergedDocumentsAs(QFile::encodeName(filename).constData(),
+                                         UBSettings::settings()->pdfCompressObjectStreams->get().toBool());
 
         }
         catch(const std::exception& e)
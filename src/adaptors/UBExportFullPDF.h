@@ -34,7 +34,10 @@
 #include "UBExportAdaptor.h"
 #include "UBExportPDF.h"
 
+#include <MergePageDescription.h>
+
 class UBDocumentProxy;
+class UBGraphicsScene;
 
 class UBExportFullPDF : public UBExportAdaptor
 {
@@ -55,8 +58,11 @@ class UBExportFullPDF : public UBExportAdaptor
         void saveOverlayPdf(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const QString& filename);
 
     private:
+        merge_lib::MergePageDescription mergePageDescription(std::shared_ptr<UBDocumentProxy> pDocumentProxy, std::shared_ptr<UBGraphicsScene> scene, int pageIndex) const;
+
         float mScaleFactor;
         bool mHasPDFBackgrounds;
+        merge_lib::MergeDescription mMergeInfo;
 
         UBExportPDF * mSimpleExporter;
 };
@@ -123,7 +123,8 @@ bool UBExportPDF::persistsDocument(std::shared_ptr<UBDocumentProxy> pDocumentPro
         // of the scene overflow from the boundaries, they will be scaled down.
         QSize pageSize = scene->sceneSize();
 
-        // set high res rendering
+        // set high res rendering, with all the images decoded
+        scene->finishImageLoading();
         scene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
         scene->setRenderingContext(UBGraphicsScene::NonScreen);
 
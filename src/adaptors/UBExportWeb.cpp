@@ -34,6 +34,7 @@
 
 #include "core/UBDocumentManager.h"
 #include "core/UBApplication.h"
+#include "core/UBPersistenceManager.h"
 
 #include "document/UBDocumentProxy.h"
 
@@ -69,7 +70,8 @@ void UBExportWeb::persist(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
         UBApplication::showMessage(tr("Exporting document..."));
 
-        if(UBFileSystemUtils::copyDir(pDocumentProxy->persistencePath(), dirName))
+        if(UBFileSystemUtils::copyDir(pDocumentProxy->persistencePath(), dirName)
+                && UBPersistenceManager::convertToLegacyLayout(dirName))
         {
             QString htmlPath = dirName + "/index.html";
 
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBSvgPageDescription.h"
+
+#include <QDebug>
+#include <QFile>
+
+std::shared_ptr<const UBSvgPageDescription> UBSvgPageDescription::fromData(const QByteArray& xmlData)
+{
+    auto description = std::make_shared<UBSvgPageDescription>();
+    QXmlStreamReader xml(xmlData);
+
+    while (!xml.atEnd())
+    {
+        Token token;
+        token.type = xml.readNext();
+
+        switch (token.type)
+        {
+        case QXmlStreamReader::StartElement:
+            token.name = xml.name().toString();
+            token.attributes = xml.attributes();
+            break;
+
+        case QXmlStreamReader::EndElement:
+            token.name = xml.name().toString();
+            break;
+
+        case QXmlStreamReader::Characters:
+        case QXmlStreamReader::EntityReference:
+            token.name = xml.name().toString();
+            token.text = xml.text().toString();
+            break;
+
+        case QXmlStreamReader::Invalid:
+            description->mErrorString = xml.errorString();
+            break;
+
+        default:
+            break;
+        }
+
+        description->mTokens << token;
+    }
+
+    return description;
+}
+
+std::shared_ptr<const UBSvgPageDescription> UBSvgPageDescription::fromFile(const QString& fileName)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot open file " << fileName << " for reading ...";
+        return fromData(QByteArray());
+    }
+
+    return fromData(file.readAll());
+}
+
+
+UBSvgPageDescriptionReader::UBSvgPageDescriptionReader(std::shared_ptr<const UBSvgPageDescription> description)
+    : mDescription(description)
+{
+    // NOOP
+}
+
+QXmlStreamReader::TokenType UBSvgPageDescriptionReader::readNext()
+{
+    // reading beyond the end of the document is an error, as for QXmlStreamReader
+    if (mPosition < mDescription->tokens().size())
+    {
+        ++mPosition;
+    }
+
+    return tokenType();
+}
+
+QXmlStreamReader::TokenType UBSvgPageDescriptionReader::tokenType() const
+{
+    return current().type;
+}
+
+bool UBSvgPageDescriptionReader::atEnd() const
+{
+    // the last token of a description is always the end of the document or an error
+    return mPosition >= mDescription->tokens().size() - 1;
+}
+
+bool UBSvgPageDescriptionReader::isStartElement() const
+{
+    return tokenType() == QXmlStreamReader::StartElement;
+}
+
+bool UBSvgPageDescriptionReader::isEndElement() const
+{
+    return tokenType() == QXmlStreamReader::EndElement;
+}
+
+QStringView UBSvgPageDescriptionReader::name() const
+{
+    return current().name;
+}
+
+QStringView UBSvgPageDescriptionReader::text() const
+{
+    return current().text;
+}
+
+const QXmlStreamAttributes& UBSvgPageDescriptionReader::attributes() const
+{
+    return current().attributes;
+}
+
+QString UBSvgPageDescriptionReader::readElementText()
+{
+    QString result;
+
+    if (!isStartElement())
+    {
+        return result;
+    }
+
+    int depth = 1;
+
+    while (depth > 0 && !atEnd())
+    {
+        switch (readNext())
+        {
+        case QXmlStreamReader::StartElement:
+            ++depth;
+            break;
+
+        case QXmlStreamReader::EndElement:
+            --depth;
+            break;
+
+        case QXmlStreamReader::Characters:
+        case QXmlStreamReader::EntityReference:
+            if (depth == 1)
+                result += current().text;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return result;
+}
+
+void UBSvgPageDescriptionReader::skipCurrentElement()
+{
+    int depth = 1;
+
+    while (depth > 0 && !atEnd())
+    {
+        switch (readNext())
+        {
+        case QXmlStreamReader::StartElement:
+            ++depth;
+            break;
+
+        case QXmlStreamReader::EndElement:
+            --depth;
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+bool UBSvgPageDescriptionReader::hasError() const
+{
+    return tokenType() == QXmlStreamReader::Invalid;
+}
+
+QString UBSvgPageDescriptionReader::errorString() const
+{
+    return mDescription->errorString();
+}
+
+const UBSvgPageDescription::Token& UBSvgPageDescriptionReader::current() const
+{
+    static const UBSvgPageDescription::Token noToken;
+    static const UBSvgPageDescription::Token invalidToken{QXmlStreamReader::Invalid};
+
+    if (mPosition < 0)
+    {
+        return noToken;
+    }
+
+    if (mPosition >= mDescription->tokens().size())
+    {
+        return invalidToken;
+    }
+
+    return mDescription->tokens().at(mPosition);
+}
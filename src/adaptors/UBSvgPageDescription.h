@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QXmlStreamReader>
+
+#include <memory>
+
+/**
+ * @brief GUI independent description of a page file.
+ *
+ * The description holds the token stream of the SVG document of a page. It does not
+ * reference any graphics object, so it can be created on a worker thread. The page is
+ * then built on the GUI thread by replaying the tokens with a UBSvgPageDescriptionReader.
+ */
+class UBSvgPageDescription
+{
+public:
+    struct Token
+    {
+        QXmlStreamReader::TokenType type = QXmlStreamReader::NoToken;
+        QString name;
+        QString text;
+        QXmlStreamAttributes attributes;
+    };
+
+    static std::shared_ptr<const UBSvgPageDescription> fromData(const QByteArray& xmlData);
+    static std::shared_ptr<const UBSvgPageDescription> fromFile(const QString& fileName);
+
+    const QVector<Token>& tokens() const
+    {
+        return mTokens;
+    }
+
+    QString errorString() const
+    {
+        return mErrorString;
+    }
+
+private:
+    QVector<Token> mTokens;
+    QString mErrorString;
+};
+
+/**
+ * @brief Cursor over a UBSvgPageDescription
+ *
+ * Offers the subset of the QXmlStreamReader interface used by the SVG reader.
+ */
+class UBSvgPageDescriptionReader
+{
+public:
+    explicit UBSvgPageDescriptionReader(std::shared_ptr<const UBSvgPageDescription> description);
+
+    QXmlStreamReader::TokenType readNext();
+    QXmlStreamReader::TokenType tokenType() const;
+
+    bool atEnd() const;
+    bool isStartElement() const;
+    bool isEndElement() const;
+
+    QStringView name() const;
+    QStringView text() const;
+    const QXmlStreamAttributes& attributes() const;
+
+    QString readElementText();
+    void skipCurrentElement();
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    const UBSvgPageDescription::Token& current() const;
+
+    std::shared_ptr<const UBSvgPageDescription> mDescription;
+    int mPosition = -1;
+};
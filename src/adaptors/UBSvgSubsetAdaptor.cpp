@@ -37,6 +37,8 @@
 #include <QGraphicsVideoItem>
 #include <QElapsedTimer>
 
+#include <cmath>
+
 #include "domain/UBGraphicsSvgItem.h"
 #include "domain/UBGraphicsPixmapItem.h"
 #include "domain/UBGraphicsPolygonItem.h"
@@ -46,6 +48,7 @@
 #include "domain/UBGraphicsTextItem.h"
 #include "domain/UBGraphicsTextItemDelegate.h"
 #include "domain/UBGraphicsStroke.h"
+#include "domain/UBGraphicsStrokeItem.h"
 #include "domain/UBGraphicsStrokesGroup.h"
 #include "domain/UBGraphicsGroupContainerItem.h"
 #include "domain/UBGraphicsGroupContainerItemDelegate.h"
@@ -98,6 +101,255 @@ const QString tStrokeGroup = "strokeGroup";
 const QString tGroups = "groups";
 const QString aId = "id";
 
+namespace
+{
+    const double sPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    /*
+     * Parse a number in the C locale, as QString::toDouble does, but without allocating.
+     * Like toDouble, an invalid number gives 0.
+     */
+    double parseSvgNumber(const char* it, const char* end)
+    {
+        bool negative = false;
+
+        if (it != end && (*it == '+' || *it == '-'))
+            negative = *it++ == '-';
+
+        quint64 mantissa = 0;
+        int significantDigits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+
+        for (; it != end && *it >= '0' && *it <= '9'; ++it)
+        {
+            hasDigits = true;
+
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (*it - '0');
+                significantDigits += mantissa ? 1 : 0;
+            }
+            else
+            {
+                ++exponent;
+            }
+        }
+
+        if (it != end && *it == '.')
+        {
+            for (++it; it != end && *it >= '0' && *it <= '9'; ++it)
+            {
+                hasDigits = true;
+
+                if (significantDigits < 19)
+                {
+                    mantissa = mantissa * 10 + (*it - '0');
+                    significantDigits += mantissa ? 1 : 0;
+                    --exponent;
+                }
+            }
+        }
+
+        if (!hasDigits)
+            return 0.;
+
+        if (it != end && (*it == 'e' || *it == 'E'))
+        {
+            bool negativeExponent = false;
+
+            if (++it != end && (*it == '+' || *it == '-'))
+                negativeExponent = *it++ == '-';
+
+            if (it == end)
+                return 0.;
+
+            int explicitExponent = 0;
+
+            for (; it != end && *it >= '0' && *it <= '9'; ++it)
+                explicitExponent = qMin(explicitExponent * 10 + (*it - '0'), 9999);
+
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (it != end)
+            return 0.;
+
+        double value = mantissa;
+
+        if (exponent > 0)
+            value *= exponent <= 22 ? sPowersOfTen[exponent] : std::pow(10., exponent);
+        else if (exponent < 0)
+            value /= -exponent <= 22 ? sPowersOfTen[-exponent] : std::pow(10., -exponent);
+
+        return negative ? -value : value;
+    }
+
+    /*
+     * Parse the "points" attribute of a polygon or polyline: pairs of coordinates
+     * separated by a comma, the pairs being separated by whitespace. Old documents written
+     * on systems using a comma as decimal separator contain "x1,x2,y1,y2" pairs.
+     */
+    template <typename Container>
+    void parseSvgPoints(QStringView svgPoints, Container& points)
+    {
+        const int length = svgPoints.size();
+        int pos = 0;
+
+        while (pos < length)
+        {
+            while (pos < length && svgPoints.at(pos).isSpace())
+                ++pos;
+
+            const int start = pos;
+
+            while (pos < length && !svgPoints.at(pos).isSpace())
+                ++pos;
+
+            if (start == pos)
+                break;
+
+            // split the point on commas, skipping empty parts
+            char buffer[2][64];
+            int partLength[4] = {0, 0, 0, 0};
+            int partStart[4] = {0, 0, 0, 0};
+            char chars[128];
+            int partCount = 0;
+            int charCount = 0;
+            bool inPart = false;
+            bool tooLong = pos - start > int(sizeof(chars));
+
+            for (int i = start; i < pos && !tooLong; ++i)
+            {
+                const QChar c = svgPoints.at(i);
+
+                if (c == QLatin1Char(','))
+                {
+                    inPart = false;
+                    continue;
+                }
+
+                if (!inPart)
+                {
+                    inPart = true;
+
+                    if (partCount++ < 4)
+                        partStart[partCount - 1] = charCount;
+                }
+
+                // non-Latin-1 characters make the number invalid, as for toDouble
+                chars[charCount++] = c.unicode() < 0x80 ? char(c.unicode()) : '?';
+
+                if (partCount <= 4)
+                    ++partLength[partCount - 1];
+            }
+
+            if (tooLong || (partCount != 2 && partCount != 4))
+            {
+                qWarning() << "cannot make sense of a 'point' value" << svgPoints.mid(start, pos - start);
+                continue;
+            }
+
+            double coordinates[2];
+
+            for (int i = 0; i < 2; ++i)
+            {
+                if (partCount == 2)
+                {
+                    const char* part = chars + partStart[i];
+                    coordinates[i] = parseSvgNumber(part, part + partLength[i]);
+                }
+                else
+                {
+                    // This is the case on system were the "," is used to seperate decimal
+                    const int integral = qMin(partLength[2 * i], 31);
+                    const int fraction = qMin(partLength[2 * i + 1], 31);
+                    memcpy(buffer[i], chars + partStart[2 * i], integral);
+                    buffer[i][integral] = '.';
+                    memcpy(buffer[i] + integral + 1, chars + partStart[2 * i + 1], fraction);
+                    coordinates[i] = parseSvgNumber(buffer[i], buffer[i] + integral + 1 + fraction);
+                }
+            }
+
+            // the coordinates were always read as float
+            points << QPointF(float(coordinates[0]), float(coordinates[1]));
+        }
+    }
+
+    /*
+     * Append a coordinate with 6 significant digits, as QString::arg(double) does.
+     * Coordinates needing an exponent are left to QString::number.
+     */
+    void appendSvgNumber(QString& target, float number)
+    {
+        const double value = number;
+        const double magnitude = std::fabs(value);
+
+        if (magnitude == 0.)
+        {
+            target += QLatin1Char('0');
+            return;
+        }
+
+        if (!std::isfinite(value) || magnitude < 1e-4 || magnitude >= 1e6)
+        {
+            target += QString::number(value, 'g', 6);
+            return;
+        }
+
+        int decimals = 5 - int(std::floor(std::log10(magnitude)));
+        // round half to even, as printf does for exact ties
+        quint64 scaled = quint64(std::nearbyint(magnitude * sPowersOfTen[decimals]));
+
+        if (scaled >= 1000000)
+        {
+            // rounding added a digit
+            if (decimals == 0)
+            {
+                target += QString::number(value, 'g', 6);
+                return;
+            }
+
+            --decimals;
+            scaled = (scaled + 5) / 10;
+        }
+
+        // digits in reverse order
+        char digits[24];
+        int digitCount = 0;
+
+        do
+        {
+            digits[digitCount++] = char('0' + scaled % 10);
+            scaled /= 10;
+        }
+        while (scaled > 0 || digitCount <= decimals);
+
+        // strip trailing zeros of the fraction
+        int first = 0;
+
+        while (first < decimals && digits[first] == '0')
+            ++first;
+
+        char text[32];
+        int length = 0;
+
+        if (value < 0)
+            text[length++] = '-';
+
+        for (int i = digitCount - 1; i >= first; --i)
+        {
+            if (i == decimals - 1)
+                text[length++] = '.';
+
+            text[length++] = digits[i];
+        }
+
+        target += QLatin1String(text, length);
+    }
+}
+
 
 QString UBSvgSubsetAdaptor::toSvgTransform(const QTransform& matrix)
 {
@@ -164,7 +416,7 @@ void UBSvgSubsetAdaptor::upgradeScene(std::shared_ptr<UBDocumentProxy> proxy, co
 
 QDomDocument UBSvgSubsetAdaptor::loadSceneDocument(std::shared_ptr<UBDocumentProxy> proxy, const int pPageIndex)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",pPageIndex);
+    QString fileName = proxy->pageFilePath(pPageIndex);
 
     QFile file(fileName);
     QDomDocument doc("page");
@@ -187,7 +439,7 @@ QDomDocument UBSvgSubsetAdaptor::loadSceneDocument(std::shared_ptr<UBDocumentPro
 
 void UBSvgSubsetAdaptor::setSceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex, QUuid pUuid)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",pageIndex);
+    QString fileName = proxy->pageFilePath(pageIndex);
 
     QFile file(fileName);
 
@@ -245,7 +497,7 @@ QString UBSvgSubsetAdaptor::uniboardDocumentNamespaceUriFromVersion(int mFileVer
 std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::loadScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
     UBApplication::showMessage(QObject::tr("Loading scene (%1/%2)").arg(pageIndex+1).arg(proxy->pageCount()));
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+    QString fileName = proxy->pageFilePath(pageIndex);
     qInfo() << "loading scene. Filename is : " << fileName;
     QFile file(fileName);
 
@@ -270,7 +522,7 @@ std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::loadScene(std::shared_ptr<U
 
 QByteArray UBSvgSubsetAdaptor::loadSceneAsText(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+    QString fileName = proxy->pageFilePath(pageIndex);
     qDebug() << fileName;
     QFile file(fileName);
 
@@ -293,7 +545,7 @@ QByteArray UBSvgSubsetAdaptor::loadSceneAsText(std::shared_ptr<UBDocumentProxy>
 
 QUuid UBSvgSubsetAdaptor::sceneUuid(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex);
+    QString fileName = proxy->pageFilePath(pageIndex);
 
     QFile file(fileName);
 
@@ -347,12 +599,23 @@ std::shared_ptr<UBGraphicsScene> UBSvgSubsetAdaptor::loadScene(std::shared_ptr<U
 std::shared_ptr<UBSvgSubsetAdaptor::UBSvgReaderContext> UBSvgSubsetAdaptor::prepareLoadingScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
 {
     const auto fileContent = loadSceneAsText(proxy, pageIndex);
-    auto context = std::make_shared<UBSvgReaderContext>(proxy, fileContent);
+    auto context = std::make_shared<UBSvgReaderContext>(proxy, UBSvgPageDescription::fromData(fileContent));
     return context;
 }
 
+QString UBSvgSubsetAdaptor::sceneFileName(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex)
+{
+    return proxy->pageFilePath(pageIndex);
+}
+
 UBSvgSubsetAdaptor::UBSvgSubsetReader::UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> pProxy, const QByteArray& pXmlData)
-    : mXmlReader(pXmlData)
+    : UBSvgSubsetReader(pProxy, UBSvgPageDescription::fromData(pXmlData))
+{
+    // NOOP
+}
+
+UBSvgSubsetAdaptor::UBSvgSubsetReader::UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> pProxy, std::shared_ptr<const UBSvgPageDescription> description)
+    : mXmlReader(description)
     , mProxy(pProxy)
     , mDocumentPath(pProxy->persistencePath())
     , mGroupHasInfo(false)
@@ -652,7 +915,7 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
         }
         else if (name == "polyline")
         {
-            QList<UBGraphicsPolygonItem*> polygonItems = polygonItemsFromPolylineSvg(mScene->isDarkBackground() ? Qt::white : Qt::black);
+            UBGraphicsStrokeItem* polygonItem = strokeItemFromPolylineSvg(mScene->isDarkBackground() ? Qt::white : Qt::black);
 
             QString parentId = mXmlReader.attributes().value(mNamespaceUri, "parent").toString();
 
@@ -662,7 +925,7 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::processElement()
             if(parentId.isEmpty())
                 parentId = QUuid::createUuid().toString();
 
-            foreach(UBGraphicsPolygonItem* polygonItem, polygonItems)
+            if (polygonItem)
             {
                 polygonItem->setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Graphic));
 
@@ -1096,12 +1359,12 @@ UBGraphicsGroupContainerItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::readGroup()
             break;
         }
         else if (mXmlReader.isStartElement()) {
-            if (mXmlReader.name() == tGroup) {
+            if (mXmlReader.name().toString() == tGroup) {
                 UBGraphicsGroupContainerItem *curGroup = readGroup();
                 if (curGroup)
                     groupContainer.append(curGroup);
             }
-            else if (mXmlReader.name() == tElement && !shouldSkipSubElements) {
+            else if (mXmlReader.name().toString() == tElement && !shouldSkipSubElements) {
                 QString id = mXmlReader.attributes().value(aId).toString();
                 QGraphicsItem *curItem = readElementFromGroup();
 
@@ -1143,7 +1406,7 @@ void UBSvgSubsetAdaptor::UBSvgSubsetReader::readGroupRoot()
             break;
         }
         else if (mXmlReader.isStartElement()) {
-            if (mXmlReader.name() == tGroup) {
+            if (mXmlReader.name().toString() == tGroup) {
 
                 UBGraphicsGroupContainerItem *curGroup = readGroup();
 
@@ -1187,6 +1450,7 @@ void UBSvgSubsetAdaptor::persistScene(std::shared_ptr<UBDocumentProxy> proxy, st
 UBSvgSubsetAdaptor::UBSvgSubsetWriter::UBSvgSubsetWriter(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, const int pageIndex)
     : mScene(pScene)
     , mDocumentPath(proxy->persistencePath())
+    , mPageFilePath(proxy->pageFilePath(pageIndex))
     , mPageIndex(pageIndex)
 
 {
@@ -1550,7 +1814,7 @@ bool UBSvgSubsetAdaptor::UBSvgSubsetWriter::persistScene(std::shared_ptr<UBDocum
     }
 
     mXmlWriter.writeEndDocument();
-    QString fileName = mDocumentPath + UBFileSystemUtils::digitFileFormat("/page%1.svg", mPageIndex);
+    QString fileName = mPageFilePath;
     QFile file(fileName);
 
     if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
@@ -1651,12 +1915,22 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::strokeToSvgPolyline(UBGraphicsStroke
         mXmlWriter.writeStartElement("polyline");
         QVector<QPointF> points;
 
-        foreach(UBGraphicsPolygonItem* polygon, pols)
+        UBGraphicsStrokeItem* strokeItem = dynamic_cast<UBGraphicsStrokeItem*>(pols.at(0));
+
+        if (pols.length() == 1 && strokeItem)
         {
-            points << polygon->originalLine().p1();
+            for (const QPair<QPointF, qreal>& point : strokeItem->points())
+                points << point.first;
         }
+        else
+        {
+            foreach(UBGraphicsPolygonItem* polygon, pols)
+            {
+                points << polygon->originalLine().p1();
+            }
 
-        points << pols.last()->originalLine().p2();
+            points << pols.last()->originalLine().p2();
+        }
 
         // SVG renderers (Chrome) do not like line withe where x1/y1 == x2/y2
         if (points.size() == 2 && (points.at(0) == points.at(1)))
@@ -1786,33 +2060,7 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromPol
 
     if (!svgPoints.isNull())
     {
-        QStringList ts = svgPoints.toString().split(QLatin1Char(' '), UB::SplitBehavior::SkipEmptyParts);
-
-        foreach(const QString sPoint, ts)
-        {
-            QStringList sCoord = sPoint.split(QLatin1Char(','), UB::SplitBehavior::SkipEmptyParts);
-
-            if (sCoord.size() == 2)
-            {
-                QPointF point;
-                point.setX(sCoord.at(0).toFloat());
-                point.setY(sCoord.at(1).toFloat());
-                polygon << point;
-            }
-            else if (sCoord.size() == 4){
-                //This is the case on system were the "," is used to seperate decimal
-                QPointF point;
-                QString x = sCoord.at(0) + "." + sCoord.at(1);
-                QString y = sCoord.at(2) + "." + sCoord.at(3);
-                point.setX(x.toFloat());
-                point.setY(y.toFloat());
-                polygon << point;
-            }
-            else
-            {
-                qWarning() << "cannot make sense of a 'point' value" << sCoord;
-            }
-        }
+        parseSvgPoints(QStringView(svgPoints), polygon);
     }
     else
     {
@@ -2011,7 +2259,7 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromLin
     return polygonItem;
 }
 
-QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemsFromPolylineSvg(const QColor& pDefaultColor)
+UBGraphicsStrokeItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::strokeItemFromPolylineSvg(const QColor& pDefaultColor)
 {
     auto strokeWidth = mXmlReader.attributes().value("stroke-width");
 
@@ -2088,50 +2336,25 @@ QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItem
 
     auto svgPoints = mXmlReader.attributes().value("points");
 
-    QList<UBGraphicsPolygonItem*> polygonItems;
+    UBGraphicsStrokeItem* strokeItem = nullptr;
 
     if (!svgPoints.isNull())
     {
-        QStringList ts = svgPoints.toString().split(QLatin1Char(' '),
-                                                    UB::SplitBehavior::SkipEmptyParts);
-
         QList<QPointF> points;
+        parseSvgPoints(QStringView(svgPoints), points);
 
-        foreach(const QString sPoint, ts)
+        if (points.size() > 1)
         {
-            QStringList sCoord = sPoint.split(QLatin1Char(','), UB::SplitBehavior::SkipEmptyParts);
+            QList<QPair<QPointF, qreal> > strokePoints;
 
-            if (sCoord.size() == 2)
-            {
-                QPointF point;
-                point.setX(sCoord.at(0).toFloat());
-                point.setY(sCoord.at(1).toFloat());
-                points << point;
-            }
-            else if (sCoord.size() == 4){
-                //This is the case on system were the "," is used to seperate decimal
-                QPointF point;
-                QString x = sCoord.at(0) + "." + sCoord.at(1);
-                QString y = sCoord.at(2) + "." + sCoord.at(3);
-                point.setX(x.toFloat());
-                point.setY(y.toFloat());
-                points << point;
-            }
-            else
-            {
-                qWarning() << "cannot make sense of a 'point' value" << sCoord;
-            }
-        }
+            foreach(const QPointF& point, points)
+                strokePoints << QPair<QPointF, qreal>(point, lineWidth);
 
-        for (int i = 0; i < points.size() - 1; i++)
-        {
-            UBGraphicsPolygonItem* polygonItem = new UBGraphicsPolygonItem(QLineF(points.at(i), points.at(i + 1)), lineWidth);
-            polygonItem->setColor(brushColor);
-            UBGraphicsItem::assignZValue(polygonItem, zValue);
-            polygonItem->setColorOnDarkBackground(colorOnDarkBackground);
-            polygonItem->setColorOnLightBackground(colorOnLightBackground);
-
-            polygonItems <<polygonItem;
+            strokeItem = new UBGraphicsStrokeItem(strokePoints);
+            strokeItem->setColor(brushColor);
+            UBGraphicsItem::assignZValue(strokeItem, zValue);
+            strokeItem->setColorOnDarkBackground(colorOnDarkBackground);
+            strokeItem->setColorOnLightBackground(colorOnLightBackground);
         }
     }
     else
@@ -2139,12 +2362,32 @@ QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItem
         qWarning() << "cannot make sense of 'points' value " << svgPoints.toString();
     }
 
-    return polygonItems;
+    return strokeItem;
 }
 
 
 
 
+QString UBSvgSubsetAdaptor::UBSvgSubsetWriter::pointsToSvgPointsAttribute(QVector<QPointF> points)
+{
+    UBGeometryUtils::crashPointList(points);
+
+    QString svgPoints;
+    svgPoints.reserve(points.size() * 16);
+
+    for (const QPointF& point : std::as_const(points))
+    {
+        // coordinates are stored as float
+        appendSvgNumber(svgPoints, point.x());
+        svgPoints += QLatin1Char(',');
+        appendSvgNumber(svgPoints, point.y());
+        svgPoints += QLatin1Char(' ');
+    }
+
+    return svgPoints;
+}
+
+
 void UBSvgSubsetAdaptor::UBSvgSubsetWriter::pixmapItemToLinkedImage(UBGraphicsPixmapItem* pixmapItem)
 {
     // find image file
@@ -2176,11 +2419,9 @@ UBGraphicsPixmapItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::pixmapItemFromSvg()
     {
         pixmapItem = new UBGraphicsPixmapItem();
         QString href = imageHref.toString();
-        QImageReader rdr(mDocumentPath + "/" + UBFileSystemUtils::normalizeFilePath(href));
-        rdr.setAutoTransform(true);
-        QImage img = rdr.read();
-        QPixmap pix = QPixmap::fromImage(img);
-        pixmapItem->setPixmap(pix);
+
+        // large images are decoded in the background, pages showing the same file share the decoded image
+        pixmapItem->loadImage(mDocumentPath + "/" + UBFileSystemUtils::normalizeFilePath(href));
         graphicsItemFromSvg(pixmapItem);
     }
     else
@@ -3505,9 +3746,9 @@ void UBSvgSubsetAdaptor::convertSvgImagesToImages(std::shared_ptr<UBDocumentProx
     }
 }
 
-UBSvgSubsetAdaptor::UBSvgReaderContext::UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pXmlData)
+UBSvgSubsetAdaptor::UBSvgReaderContext::UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<const UBSvgPageDescription> description)
 {
-    reader = new UBSvgSubsetReader(proxy, pXmlData);
+    reader = new UBSvgSubsetReader(proxy, description);
     reader->start();
 }
 
@@ -36,6 +36,8 @@
 
 #include "frameworks/UBGeometryUtils.h"
 
+#include "UBSvgPageDescription.h"
+
 class UBGraphicsSvgItem;
 class UBGraphicsPolygonItem;
 class UBGraphicsPixmapItem;
@@ -55,6 +57,7 @@ class UBGraphicsProtractor;
 class UBGraphicsScene;
 class UBDocumentProxy;
 class UBGraphicsStroke;
+class UBGraphicsStrokeItem;
 class UBPersistenceManager;
 class UBGraphicsTriangle;
 class UBGraphicsCache;
@@ -73,7 +76,7 @@ class UBSvgSubsetAdaptor
         class UBSvgReaderContext
         {
         public:
-            UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pXmlData);
+            UBSvgReaderContext(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<const UBSvgPageDescription> description);
             ~UBSvgReaderContext();
             bool isFinished() const;
             void step();
@@ -87,6 +90,7 @@ class UBSvgSubsetAdaptor
         static QByteArray loadSceneAsText(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
         static std::shared_ptr<UBGraphicsScene> loadScene(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pArray);
         static std::shared_ptr<UBSvgReaderContext> prepareLoadingScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
+        static QString sceneFileName(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
 
         static void persistScene(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, const int pageIndex);
         static void upgradeScene(std::shared_ptr<UBDocumentProxy> proxy, const int pageIndex);
@@ -126,6 +130,7 @@ class UBSvgSubsetAdaptor
             public:
 
                 UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> proxy, const QByteArray& pXmlData);
+                UBSvgSubsetReader(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<const UBSvgPageDescription> description);
 
                 virtual ~UBSvgSubsetReader(){}
 
@@ -142,7 +147,7 @@ class UBSvgSubsetAdaptor
 
                 UBGraphicsPolygonItem* polygonItemFromPolygonSvg(const QColor& pDefaultBrushColor);
 
-                QList<UBGraphicsPolygonItem*> polygonItemsFromPolylineSvg(const QColor& pDefaultColor);
+                UBGraphicsStrokeItem* strokeItemFromPolylineSvg(const QColor& pDefaultColor);
 
                 UBGraphicsPixmapItem* pixmapItemFromSvg();
 
@@ -182,7 +187,7 @@ class UBSvgSubsetAdaptor
 
                 qreal normalizedZValue(bool* hasValue);
 
-                QXmlStreamReader mXmlReader;
+                UBSvgPageDescriptionReader mXmlReader;
                 int mFileVersion;
                 std::shared_ptr<UBDocumentProxy> mProxy;
                 QString mDocumentPath;
@@ -224,34 +229,7 @@ class UBSvgSubsetAdaptor
                 void strokeToSvgPolyline(UBGraphicsStroke* stroke, bool groupHoldsInfo);
                 void strokeToSvgPolygon(UBGraphicsStroke* stroke, bool groupHoldsInfo);
 
-                inline QString pointsToSvgPointsAttribute(QVector<QPointF> points)
-                {
-                    UBGeometryUtils::crashPointList(points);
-
-                    int pointsCount = points.size();
-                    QString svgPoints;
-
-                    int length = 0;
-                    QString sBuf;
-
-                    for(int j = 0; j < pointsCount; j++)
-                    {
-                        sBuf = "%1,%2 ";
-                        const QPointF & point = points.at(j);
-
-                        QString temp1 =  "%1", temp2 = "%2";
-
-                        temp1 = temp1.arg(point.x());
-                        temp2 = temp2.arg(point.y());
-
-                        QLocale loc(QLocale::C);
-                        sBuf = sBuf.arg(loc.toFloat(temp1)).arg(loc.toFloat(temp2));
-
-                        svgPoints.insert(length, sBuf);
-                        length += sBuf.length();
-                    }
-                    return svgPoints;
-                }
+                QString pointsToSvgPointsAttribute(QVector<QPointF> points);
 
                 inline qreal trickAlpha(qreal alpha)
                 {
@@ -288,6 +266,7 @@ class UBSvgSubsetAdaptor
                 std::shared_ptr<UBGraphicsScene> mScene;
                 QXmlStreamWriter mXmlWriter;
                 QString mDocumentPath;
+                QString mPageFilePath;
                 int mPageIndex;
 
         };
@@ -30,6 +30,8 @@
 #include "UBThumbnailAdaptor.h"
 
 #include <QtCore>
+#include <QSaveFile>
+#include <QtConcurrent>
 
 #include "frameworks/UBFileSystemUtils.h"
 
@@ -48,13 +50,34 @@
 
 #include "core/memcheck.h"
 
+namespace
+{
+    // rendered thumbnail waiting to be encoded and written by the thumbnail pool
+    struct ThumbnailJob
+    {
+        QImage image;
+        std::function<void()> persisted;
+    };
+
+    QMutex sThumbnailJobsMutex;
+    QWaitCondition sThumbnailJobsFinished;
+    QHash<QString, ThumbnailJob> sPendingThumbnailJobs;
+    QSet<QString> sRunningThumbnailJobs;
+
+    QThreadPool* thumbnailPool()
+    {
+        static QThreadPool pool;
+        return &pool;
+    }
+}
+
 void UBThumbnailAdaptor::generateMissingThumbnails(std::shared_ptr<UBDocumentProxy> proxy)
 {
     int existingPageCount = proxy->pageCount();
 
     for (int iPageNo = 0; iPageNo < existingPageCount; ++iPageNo)
     {
-        QString thumbFileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", iPageNo);
+        QString thumbFileName = proxy->thumbnailFilePath(iPageNo);
 
         QFile thumbFile(thumbFileName);
 
@@ -85,7 +108,9 @@ void UBThumbnailAdaptor::generateMissingThumbnails(std::shared_ptr<UBDocumentPro
 
 QPixmap UBThumbnailAdaptor::generateMissingThumbnail(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
 {
-    QString thumbFileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
+    QString thumbFileName = proxy->thumbnailFilePath(pageIndex);
+
+    waitForPendingThumbnail(thumbFileName);
 
     QFile thumbFile(thumbFileName);
 
@@ -106,7 +131,9 @@ QPixmap UBThumbnailAdaptor::generateMissingThumbnail(std::shared_ptr<UBDocumentP
 
 QPixmap UBThumbnailAdaptor::get(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
+    QString fileName = proxy->thumbnailFilePath(pageIndex);
+
+    waitForPendingThumbnail(fileName);
 
     QFile file(fileName);
     if (!file.exists())
@@ -134,53 +161,163 @@ void UBThumbnailAdaptor::load(std::shared_ptr<UBDocumentProxy> proxy, QList<std:
 
 void UBThumbnailAdaptor::persistScene(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, int pageIndex, bool overrideModified)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
+    QString fileName = proxy->thumbnailFilePath(pageIndex);
+
+    // a pending thumbnail of the page would overwrite this one
+    waitForPendingThumbnail(fileName);
 
     QFile thumbFile(fileName);
 
     if (pScene->isModified() || overrideModified || !thumbFile.exists())
     {
-        qreal nominalWidth = pScene->nominalSize().width();
-        qreal nominalHeight = pScene->nominalSize().height();
-        qreal ratio = nominalWidth / nominalHeight;
-        QRectF sceneRect = pScene->normalizedSceneRect(ratio);
+        const QSizeF size = thumbnailSize(pScene);
+        QImage thumb(size.toSize(), QImage::Format_ARGB32);
 
-        qreal width = UBSettings::maxThumbnailWidth;
-        qreal height = width / ratio;
+        renderScene(pScene, &thumb, size);
 
-        QImage thumb(width, height, QImage::Format_ARGB32);
+        thumb.save(fileName, "JPG");
+    }
+}
 
-        QRectF imageRect(0, 0, width, height);
+/**
+ * @brief Persist the thumbnail of a scene without blocking the GUI thread
+ *
+ * The scene is rendered here, as its items and their pixmaps belong to the GUI thread, but
+ * the encoding and writing of the image, which take most of the time, are done on the
+ * thumbnail pool. A thumbnail saved again while its previous version is still waiting
+ * replaces it, so that repeated saves of the same page are only written once.
+ *
+ * @param persisted Optional function called on the GUI thread when the file is written.
+ */
+void UBThumbnailAdaptor::persistSceneInBackground(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, int pageIndex, std::function<void()> persisted)
+{
+    QString fileName = proxy->thumbnailFilePath(pageIndex);
 
-        QPainter painter(&thumb);
-        painter.setRenderHint(QPainter::Antialiasing, true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    if (!pScene->isModified() && QFile::exists(fileName))
+    {
+        return;
+    }
+
+    ThumbnailJob job;
+    const QSizeF size = thumbnailSize(pScene);
+    job.image = QImage(size.toSize(), QImage::Format_ARGB32);
+    job.persisted = persisted;
+
+    renderScene(pScene, &job.image, size);
+
+    QMutexLocker locker(&sThumbnailJobsMutex);
+    sPendingThumbnailJobs.insert(fileName, job);
+
+    if (!sRunningThumbnailJobs.contains(fileName))
+    {
+        sRunningThumbnailJobs.insert(fileName);
+        QtConcurrent::run(thumbnailPool(), &UBThumbnailAdaptor::processThumbnailJobs, fileName);
+    }
+}
+
+/**
+ * @brief Wait until the pending thumbnail of a file is written
+ *
+ * To be called before the thumbnail file is read, renamed, copied or removed.
+ */
+void UBThumbnailAdaptor::waitForPendingThumbnail(const QString& fileName)
+{
+    QMutexLocker locker(&sThumbnailJobsMutex);
+
+    while (sRunningThumbnailJobs.contains(fileName))
+    {
+        sThumbnailJobsFinished.wait(&sThumbnailJobsMutex);
+    }
+}
+
+/**
+ * @brief Wait until all pending thumbnails are written, when the application closes
+ */
+void UBThumbnailAdaptor::waitForPendingThumbnails()
+{
+    thumbnailPool()->waitForDone();
+}
+
+QSizeF UBThumbnailAdaptor::thumbnailSize(std::shared_ptr<UBGraphicsScene> pScene)
+{
+    qreal nominalWidth = pScene->nominalSize().width();
+    qreal nominalHeight = pScene->nominalSize().height();
+    qreal ratio = nominalWidth / nominalHeight;
+
+    qreal width = UBSettings::maxThumbnailWidth;
+    qreal height = width / ratio;
+
+    return QSizeF(width, height);
+}
+
+void UBThumbnailAdaptor::renderScene(std::shared_ptr<UBGraphicsScene> pScene, QPaintDevice* device, const QSizeF& size)
+{
+    qreal ratio = size.width() / size.height();
+    QRectF sceneRect = pScene->normalizedSceneRect(ratio);
+
+    QRectF imageRect(QPointF(0, 0), size);
+
+    QPainter painter(device);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    if (pScene->isDarkBackground())
+    {
+        painter.fillRect(imageRect, Qt::black);
+    }
+    else
+    {
+        painter.fillRect(imageRect, Qt::white);
+    }
+
+    pScene->finishImageLoading();
+    pScene->setRenderingContext(UBGraphicsScene::NonScreen);
+    pScene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
+
+    pScene->render(&painter, imageRect, sceneRect, Qt::KeepAspectRatio);
+
+    pScene->setRenderingContext(UBGraphicsScene::Screen);
+    pScene->setRenderingQuality(UBItem::RenderingQualityNormal, UBItem::CacheAllowed);
+}
+
+void UBThumbnailAdaptor::processThumbnailJobs(const QString& fileName)
+{
+    forever
+    {
+        ThumbnailJob job;
 
-        if (pScene->isDarkBackground())
-        {
-            painter.fillRect(imageRect, Qt::black);
-        }
-        else
         {
-            painter.fillRect(imageRect, Qt::white);
-        }
+            QMutexLocker locker(&sThumbnailJobsMutex);
 
-        pScene->setRenderingContext(UBGraphicsScene::NonScreen);
-        pScene->setRenderingQuality(UBItem::RenderingQualityHigh, UBItem::CacheNotAllowed);
+            if (!sPendingThumbnailJobs.contains(fileName))
+            {
+                sRunningThumbnailJobs.remove(fileName);
+                sThumbnailJobsFinished.wakeAll();
+                return;
+            }
+
+            job = sPendingThumbnailJobs.take(fileName);
+        }
 
-        pScene->render(&painter, imageRect, sceneRect, Qt::KeepAspectRatio);
+        // the thumbnail loaders must never see a partially written file
+        QSaveFile file(fileName);
 
-        pScene->setRenderingContext(UBGraphicsScene::Screen);
-        pScene->setRenderingQuality(UBItem::RenderingQualityNormal, UBItem::CacheAllowed);
+        if (!file.open(QIODevice::WriteOnly) || !job.image.save(&file, "JPG") || !file.commit())
+        {
+            qWarning() << "Cannot write thumbnail" << fileName;
+        }
 
-        thumb.scaled(width, height, Qt::KeepAspectRatio, Qt::SmoothTransformation).save(fileName, "JPG");
+        if (job.persisted)
+        {
+            QMetaObject::invokeMethod(qApp, job.persisted, Qt::QueuedConnection);
+        }
     }
 }
 
 
 QUrl UBThumbnailAdaptor::thumbnailUrl(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
 {
-    QString fileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex);
+    QString fileName = proxy->thumbnailFilePath(pageIndex);
 
     return QUrl::fromLocalFile(fileName);
 }
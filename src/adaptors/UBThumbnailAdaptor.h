@@ -32,6 +32,9 @@
 
 #include <QtCore>
 
+#include <functional>
+
+class QPaintDevice;
 class UBDocument;
 class UBDocumentProxy;
 class UBGraphicsScene;
@@ -44,13 +47,19 @@ public:
     static QUrl thumbnailUrl(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
 
     static void persistScene(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, int pageIndex, bool overrideModified = false);
+    static void persistSceneInBackground(std::shared_ptr<UBDocumentProxy> proxy, std::shared_ptr<UBGraphicsScene> pScene, int pageIndex, std::function<void()> persisted = nullptr);
+    static void waitForPendingThumbnail(const QString& fileName);
+    static void waitForPendingThumbnails();
 
     static QPixmap get(std::shared_ptr<UBDocumentProxy> proxy, int index);
     static void load(std::shared_ptr<UBDocumentProxy> proxy, QList<std::shared_ptr<QPixmap>>& list);
     static QPixmap generateMissingThumbnail(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex);
+    static void renderScene(std::shared_ptr<UBGraphicsScene> pScene, QPaintDevice* device, const QSizeF& size);
 
 private:
     static void generateMissingThumbnails(std::shared_ptr<UBDocumentProxy> proxy);
+    static QSizeF thumbnailSize(std::shared_ptr<UBGraphicsScene> pScene);
+    static void processThumbnailJobs(const QString& fileName);
 
     UBThumbnailAdaptor() {}
 };
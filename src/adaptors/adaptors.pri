@@ -4,6 +4,7 @@ HEADERS      += src/adaptors/UBExportAdaptor.h\
                 src/adaptors/UBExportPDF.h \
                 src/adaptors/UBExportFullPDF.h \
                 src/adaptors/UBExportDocument.h \
+                src/adaptors/UBSvgPageDescription.h \
                 src/adaptors/UBSvgSubsetAdaptor.h \
                 src/adaptors/UBMetadataDcSubsetAdaptor.h \
                 src/adaptors/UBImportAdaptor.h \
@@ -24,6 +25,7 @@ SOURCES      += src/adaptors/UBExportAdaptor.cpp\
                 src/adaptors/UBExportPDF.cpp \
                 src/adaptors/UBExportFullPDF.cpp \
                 src/adaptors/UBExportDocument.cpp \
+                src/adaptors/UBSvgPageDescription.cpp \
                 src/adaptors/UBSvgSubsetAdaptor.cpp \
                 src/adaptors/UBMetadataDcSubsetAdaptor.cpp \
                 src/adaptors/UBImportAdaptor.cpp \
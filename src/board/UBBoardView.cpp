@@ -2028,9 +2028,9 @@ void UBBoardView::settingChanged (QVariant newValue)
 {
     Q_UNUSED (newValue);
 
-    mPenPressureSensitive = UBSettings::settings ()->boardPenPressureSensitive->get ().toBool ();
-    mMarkerPressureSensitive = UBSettings::settings ()->boardMarkerPressureSensitive->get ().toBool ();
-    mUseHighResTabletEvent = UBSettings::settings ()->boardUseHighResTabletEvent->get ().toBool ();
+    mPenPressureSensitive = UBSettings::settings ()->boardPenPressureSensitive->value();
+    mMarkerPressureSensitive = UBSettings::settings ()->boardMarkerPressureSensitive->value();
+    mUseHighResTabletEvent = UBSettings::settings ()->boardUseHighResTabletEvent->value();
 }
 
 void UBBoardView::virtualKeyboardActivated(bool b)
@@ -64,13 +64,17 @@ const QString UBFeaturesController::favoritePath = rootPath + "/Favorites";
 const QString UBFeaturesController::webSearchPath = rootPath + "/Web search";
 
 
-void UBFeaturesComputingThread::scanFS(const QUrl & currentPath, const QString & currVirtualPath, const QSet<QUrl> &pFavoriteSet)
+struct UBFeaturesComputingThread::ScanEntry
 {
-//    Q_ASSERT(QFileInfo(currentPath.toLocalFile()).exists());
-//    if(QFileInfo(currentPath.toLocalFile()).exists())
-//        return;
+    QFileInfo fileInfo;
+    UBFeatureElementType type;
+    QString virtualPath;
+    int category;
+};
 
-    QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(currentPath.toLocalFile());
+void UBFeaturesComputingThread::listFS(const QString &currentPath, const QString &currVirtualPath, int category, QList<ScanEntry> &entries)
+{
+    QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(currentPath);
 
     QFileInfoList::iterator fileInfo;
     for ( fileInfo = fileInfoList.begin(); fileInfo != fileInfoList.end(); fileInfo +=  1) {
@@ -79,76 +83,158 @@ void UBFeaturesComputingThread::scanFS(const QUrl & currentPath, const QString &
         }
 
         QString fullFileName = fileInfo->absoluteFilePath();
-        UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
-        QString fileName = fileInfo->fileName();
-
-        QImage icon = UBFeaturesController::getIcon(fullFileName, featureType);
 
         if ( fullFileName.contains(".thumbnail."))
             continue;
 
-        UBFeature testFeature(currVirtualPath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
-
-        emit sendFeature(testFeature);
-        emit featureSent();
-        emit scanPath(fullFileName);
+        UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
 
-        if ( pFavoriteSet.find(QUrl::fromLocalFile(fullFileName)) != pFavoriteSet.end()) {
-            //TODO send favoritePath from the controller or make favoritePath public and static
-            emit sendFeature(UBFeature( UBFeaturesController::favoritePath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType));
-        }
+        entries << ScanEntry{*fileInfo, featureType, currVirtualPath, category};
 
         if (featureType == FEATURE_FOLDER) {
-            scanFS(QUrl::fromLocalFile(fullFileName), currVirtualPath + "/" + fileName, pFavoriteSet);
+            listFS(fullFileName, currVirtualPath + "/" + fileInfo->fileName(), category, entries);
         }
     }
 }
 
 void UBFeaturesComputingThread::scanAll(QList<QPair<QUrl, UBFeature> > pScanningData, const QSet<QUrl> &pFavoriteSet)
 {
+    // list the whole tree once, the number of entries gives the progress bar range
+    QList<ScanEntry> entries;
+
     for (int i = 0; i < pScanningData.count(); i++) {
         if (abort) {
             return;
         }
         QPair<QUrl, UBFeature> curPair = pScanningData.at(i);
 
-        emit scanCategory(curPair.second.getDisplayName());
-        scanFS(curPair.first, curPair.second.getFullVirtualPath(), pFavoriteSet);
+        listFS(curPair.first.toLocalFile(), curPair.second.getFullVirtualPath(), i, entries);
+    }
+
+    emit maxFilesCountEvaluated(entries.size());
+    emit scanStarted();
+
+    int currentCategory = -1;
+
+    for (const ScanEntry &entry : std::as_const(entries)) {
+        if (abort) {
+            return;
+        }
+
+        if (entry.category != currentCategory) {
+            currentCategory = entry.category;
+            emit scanCategory(pScanningData.at(currentCategory).second.getDisplayName());
+        }
+
+        QString fullFileName = entry.fileInfo.absoluteFilePath();
+        UBFeatureElementType featureType = entry.type;
+        QString fileName = entry.fileInfo.fileName();
+
+        QImage icon = UBFeaturesController::getIcon(fullFileName, featureType);
+
+        UBFeature testFeature(entry.virtualPath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType);
+
+        emit sendFeature(testFeature);
+        emit featureSent();
+        emit scanPath(fullFileName);
+
+        if ( pFavoriteSet.find(QUrl::fromLocalFile(fullFileName)) != pFavoriteSet.end()) {
+            //TODO send favoritePath from the controller or make favoritePath public and static
+            emit sendFeature(UBFeature( UBFeaturesController::favoritePath + "/" + fileName, icon, fileName, QUrl::fromLocalFile(fullFileName), featureType));
+        }
+    }
+
+    // drop the cached icons of the images removed or modified since the last scan
+    QHash<QString, QFileInfoList> directoryImages;
+
+    for (int i = 0; i < pScanningData.count(); i++) {
+        directoryImages.insert(QFileInfo(pScanningData.at(i).first.toLocalFile()).absoluteFilePath(), QFileInfoList());
+    }
+
+    for (const ScanEntry &entry : std::as_const(entries)) {
+        if (entry.type == FEATURE_FOLDER) {
+            // a folder is listed before its content
+            directoryImages.insert(entry.fileInfo.absoluteFilePath(), QFileInfoList());
+        } else if (entry.type == FEATURE_IMAGE) {
+            directoryImages[entry.fileInfo.absolutePath()] << entry.fileInfo;
+        }
+    }
+
+    UBFeaturesController::pruneIconCache(directoryImages, true);
+
+    // watch the directories only after their features were sent, so that a change is not applied twice
+    for (int i = 0; i < pScanningData.count(); i++) {
+        emit directoryScanned(pScanningData.at(i).first.toLocalFile(), pScanningData.at(i).second.getFullVirtualPath());
+    }
+
+    for (const ScanEntry &entry : std::as_const(entries)) {
+        if (entry.type == FEATURE_FOLDER) {
+            emit directoryScanned(entry.fileInfo.absoluteFilePath(), entry.virtualPath + "/" + entry.fileInfo.fileName());
+        }
     }
 }
 
-int UBFeaturesComputingThread::featuresCount(const QUrl &pPath)
+/**
+ * @brief List a watched directory again, the icons of its new files are read here instead of the GUI thread.
+ *
+ * A new folder is listed with all its content. The files already in the model are only reported in the
+ * current files, so that the controller can remove the features of the missing ones.
+ */
+void UBFeaturesComputingThread::scanDirectory(const DirectoryUpdate &pUpdate)
 {
-    int noItems = 0;
+    QList<ScanEntry> entries;
+    QStringList currentFiles;
+    QHash<QString, QFileInfoList> directoryImages;
 
-    QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(pPath.toLocalFile());
+    directoryImages.insert(QFileInfo(pUpdate.path).absoluteFilePath(), QFileInfoList());
+
+    const QFileInfoList fileInfoList = UBFileSystemUtils::allElementsInDirectory(pUpdate.path);
+
+    for (const QFileInfo &fileInfo : fileInfoList) {
+        if (abort) {
+            return;
+        }
+
+        QString fullFileName = fileInfo.absoluteFilePath();
+
+        if ( fullFileName.contains(".thumbnail."))
+            continue;
 
-    QFileInfoList::iterator fileInfo;
-    for ( fileInfo = fileInfoList.begin(); fileInfo != fileInfoList.end(); fileInfo +=  1) {
-        QString fullFileName = fileInfo->absoluteFilePath();
         UBFeatureElementType featureType = UBFeaturesController::fileTypeFromUrl(fullFileName);
 
-        if (featureType != FEATURE_INVALID && !fullFileName.contains(".thumbnail.")) {
-            noItems++;
+        currentFiles << fullFileName;
+
+        if (featureType == FEATURE_IMAGE) {
+            directoryImages[fileInfo.absolutePath()] << fileInfo;
         }
 
+        if (pUpdate.listedFiles.contains(fullFileName)) {
+            continue;
+        }
+
+        entries << ScanEntry{fileInfo, featureType, pUpdate.virtualPath, 0};
+
         if (featureType == FEATURE_FOLDER) {
-            noItems += featuresCount(QUrl::fromLocalFile(fullFileName));
+            listFS(fullFileName, pUpdate.virtualPath + "/" + fileInfo.fileName(), 0, entries);
         }
     }
 
-    return noItems;
-}
+    QList<UBFeature> newFeatures;
 
-int UBFeaturesComputingThread::featuresCountAll(QList<QPair<QUrl, UBFeature> > pScanningData)
-{
-    int noItems = 0;
-    for (int i = 0; i < pScanningData.count(); i++) {
-        QPair<QUrl, UBFeature> curPair = pScanningData.at(i);
-        noItems += featuresCount(curPair.first);
+    for (const ScanEntry &entry : std::as_const(entries)) {
+        if (abort) {
+            return;
+        }
+
+        QString fullFileName = entry.fileInfo.absoluteFilePath();
+        QString fileName = entry.fileInfo.fileName();
+
+        newFeatures << UBFeature(entry.virtualPath + "/" + fileName, UBFeaturesController::getIcon(fullFileName, entry.type), fileName, QUrl::fromLocalFile(fullFileName), entry.type);
     }
 
-    return noItems;
+    UBFeaturesController::pruneIconCache(directoryImages, false);
+
+    emit directoryUpdated(pUpdate.path, pUpdate.virtualPath, newFeatures, currentFiles);
 }
 
 UBFeaturesComputingThread::UBFeaturesComputingThread(QObject *parent) :
@@ -164,11 +250,40 @@ void UBFeaturesComputingThread::compute(const QList<QPair<QUrl, UBFeature> > &pS
 
     mScanningData = pScanningData;
     mFavoriteSet = *pFavoritesSet;
+    restart = true;
+
+    // the whole scan also covers the directories waiting for an update
+    mDirectoryUpdates.clear();
+
+    if (!isRunning()) {
+        start(LowPriority);
+    } else {
+        mWaitCondition.wakeOne();
+    }
+}
+
+void UBFeaturesComputingThread::update(const QString &path, const QString &virtualPath, const QSet<QString> &listedFiles)
+{
+    QMutexLocker curLocker(&mMutex);
+
+    bool queued = false;
+
+    // several changes of a directory before it is listed again need a single update
+    for (DirectoryUpdate &directoryUpdate : mDirectoryUpdates) {
+        if (directoryUpdate.path == path) {
+            directoryUpdate.virtualPath = virtualPath;
+            directoryUpdate.listedFiles = listedFiles;
+            queued = true;
+        }
+    }
+
+    if (!queued) {
+        mDirectoryUpdates << DirectoryUpdate{path, virtualPath, listedFiles};
+    }
 
     if (!isRunning()) {
         start(LowPriority);
     } else {
-        restart = true;
         mWaitCondition.wakeOne();
     }
 }
@@ -179,37 +294,32 @@ void UBFeaturesComputingThread::run()
 //        qDebug() << "Custom thread started execution";
 
         mMutex.lock();
-        QList<QPair<QUrl, UBFeature> > searchData = mScanningData;
-        QSet<QUrl> favoriteSet = mFavoriteSet;
-        mMutex.unlock();
+        while (!abort && !restart && mDirectoryUpdates.isEmpty()) {
+            mWaitCondition.wait(&mMutex);
+        }
 
         if (abort) {
+            mMutex.unlock();
             return;
         }
-        if (restart) {
-            break;
-        }
-
-//        QTime curTime = QTime::currentTime();
-        int fsCnt = featuresCountAll(searchData);
-//        int msecsto = curTime.msecsTo(QTime::currentTime());
-//        qDebug() << "time on evaluation" << msecsto;
 
-        emit maxFilesCountEvaluated(fsCnt);
+        if (!restart) {
+            DirectoryUpdate directoryUpdate = mDirectoryUpdates.takeFirst();
+            mMutex.unlock();
 
-        emit scanStarted();
-//        curTime = QTime::currentTime();
-        scanAll(searchData, favoriteSet);
-//        qDebug() << "Time on finishing" << curTime.msecsTo(QTime::currentTime());
-        emit scanFinished();
-
-        mMutex.lock();
-        if (!abort) {
-            mWaitCondition.wait(&mMutex);
+            scanDirectory(directoryUpdate);
+            continue;
         }
+
+        QList<QPair<QUrl, UBFeature> > searchData = mScanningData;
+        QSet<QUrl> favoriteSet = mFavoriteSet;
         restart = false;
         mMutex.unlock();
 
+//        QTime curTime = QTime::currentTime();
+        scanAll(searchData, favoriteSet);
+//        qDebug() << "Time on finishing" << curTime.msecsTo(QTime::currentTime());
+        emit scanFinished();
     }
 }
 
@@ -374,6 +484,9 @@ UBFeaturesController::UBFeaturesController(QWidget *pParentWidget) :
     connect(&mCThread, SIGNAL(maxFilesCountEvaluated(int)), this, SIGNAL(maxFilesCountEvaluated(int)));
     connect(&mCThread, SIGNAL(scanCategory(QString)), this, SIGNAL(scanCategory(QString)));
     connect(&mCThread, SIGNAL(scanPath(QString)), this, SIGNAL(scanPath(QString)));
+    connect(&mCThread, SIGNAL(directoryScanned(QString,QString)), this, SLOT(watchDirectory(QString,QString)));
+    connect(&mCThread, SIGNAL(directoryUpdated(QString,QString,QList<UBFeature>,QStringList)), this, SLOT(applyDirectoryUpdate(QString,QString,QList<UBFeature>,QStringList)));
+    connect(&mDirectoryWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(updateDirectory(QString)));
     connect(UBApplication::boardController, SIGNAL(npapiWidgetCreated(QString)), this, SLOT(createNpApiFeature(QString)));
 
     QTimer::singleShot(0, this, SLOT(startThread()));
@@ -412,6 +525,141 @@ void UBFeaturesController::createNpApiFeature(const QString &str)
     featuresModel->addItem(UBFeature(QString(appPath + "/Web/" + widgetName), QImage(UBGraphicsWidgetItem::iconFilePath(QUrl::fromLocalFile(str))), widgetName, QUrl::fromLocalFile(str), FEATURE_INTERACTIVE));
 }
 
+void UBFeaturesController::watchDirectory(const QString &path, const QString &virtualPath)
+{
+    const QString directory = QFileInfo(path).absoluteFilePath();
+
+    if (!mWatchedDirectories.contains(directory) && QFileInfo(directory).isDir()) {
+        mWatchedDirectories.insert(directory, virtualPath);
+        mDirectoryWatcher.addPath(directory);
+    }
+}
+
+/**
+ * @brief Ask the scanning thread to list a watched directory again, without scanning the whole library.
+ */
+void UBFeaturesController::updateDirectory(const QString &path)
+{
+    const QString virtualPath = mWatchedDirectories.value(path);
+
+    if (virtualPath.isNull()) {
+        return;
+    }
+
+    if (!QFileInfo(path).isDir()) {
+        // the feature of a removed folder is removed with the changes of its parent
+        mWatchedDirectories.remove(path);
+        mDirectoryWatcher.removePath(path);
+        return;
+    }
+
+    const QHash<QString, UBFeature> listedFeatures = directoryFeatures(path, virtualPath);
+    QSet<QString> listedFiles;
+
+    for (auto it = listedFeatures.cbegin(); it != listedFeatures.cend(); ++it) {
+        listedFiles.insert(it.key());
+    }
+
+    // the icons of the new files are read by the scanning thread, see applyDirectoryUpdate
+    mCThread.update(path, virtualPath, listedFiles);
+}
+
+/**
+ * @brief Apply the changes of a watched directory to the model, once the scanning thread listed it.
+ *
+ * Only files added or removed are detected, a modified file keeps its icon until the next rescan.
+ */
+void UBFeaturesController::applyDirectoryUpdate(const QString &path, const QString &virtualPath, const QList<UBFeature> &newFeatures, const QStringList &currentFiles)
+{
+    if (mWatchedDirectories.value(path) != virtualPath) {
+        // the directory was removed or the library rescanned in the meantime
+        return;
+    }
+
+    const QHash<QString, UBFeature> listedFeatures = directoryFeatures(path, virtualPath);
+    QStringList listedFolders;
+
+    for (const UBFeature &feature : newFeatures) {
+        const QString fullFileName = feature.getFullPath().toLocalFile();
+        bool listed = listedFeatures.contains(fullFileName);
+
+        // a previous update may already have added a new folder with its content
+        for (const QString &folder : std::as_const(listedFolders)) {
+            listed = listed || fullFileName.startsWith(folder + "/");
+        }
+
+        if (listed) {
+            if (feature.getType() == FEATURE_FOLDER) {
+                listedFolders << fullFileName;
+            }
+            continue;
+        }
+
+        featuresModel->addItem(feature);
+
+        if (feature.getType() == FEATURE_FOLDER) {
+            // a new folder is watched the same way
+            watchDirectory(fullFileName, feature.getFullVirtualPath());
+        }
+    }
+
+    QSet<QString> files;
+
+    for (const QString &file : currentFiles) {
+        files.insert(file);
+    }
+
+    for (auto it = listedFeatures.cbegin(); it != listedFeatures.cend(); ++it) {
+        if (!files.contains(it.key())) {
+            if (it.value().getType() == FEATURE_FOLDER) {
+                removeDirectoryFeatures(it.value());
+            }
+
+            featuresModel->deleteItem(it.value());
+        }
+    }
+
+    refreshModels();
+}
+
+QHash<QString, UBFeature> UBFeaturesController::directoryFeatures(const QString &path, const QString &virtualPath) const
+{
+    QHash<QString, UBFeature> features;
+
+    for (const UBFeature &feature : std::as_const(*featuresList)) {
+        if (feature.getVirtualPath() == virtualPath && feature.getFullPath().isLocalFile()
+                && feature.getFullPath().toLocalFile().section('/', 0, -2) == path) {
+            features.insert(feature.getFullPath().toLocalFile(), feature);
+        }
+    }
+
+    return features;
+}
+
+void UBFeaturesController::removeDirectoryFeatures(const UBFeature &folder)
+{
+    const QString folderPath = folder.getFullPath().toLocalFile() + "/";
+    const QString folderVirtualPath = folder.getFullVirtualPath();
+
+    for (int i = featuresList->size() - 1; i >= 0; --i) {
+        const UBFeature &feature = featuresList->at(i);
+
+        if (feature.getFullPath().toLocalFile().startsWith(folderPath)
+                && (feature.getVirtualPath() + "/").startsWith(folderVirtualPath + "/")) {
+            featuresModel->removeRow(i);
+        }
+    }
+
+    for (auto it = mWatchedDirectories.begin(); it != mWatchedDirectories.end();) {
+        if ((it.key() + "/").startsWith(folderPath)) {
+            mDirectoryWatcher.removePath(it.key());
+            it = mWatchedDirectories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void UBFeaturesController::scanFS()
 {
     featuresList->clear();
@@ -820,39 +1068,169 @@ UBFeatureElementType UBFeaturesController::fileTypeFromUrl(const QString &path)
 QImage UBFeaturesController::getIcon(const QString &path, UBFeatureElementType pFType = FEATURE_INVALID)
 {
     if (pFType == FEATURE_FOLDER) {
-        return QImage(":images/libpalette/folder.svg");
+        return resourceIcon(":images/libpalette/folder.svg");
     } else if (pFType == FEATURE_DOCUMENT) {
-        return QImage(":images/openboard-document.png");
+        return resourceIcon(":images/openboard-document.png");
     } else if (pFType == FEATURE_INTERACTIVE || pFType == FEATURE_SEARCH) {
         return QImage(UBGraphicsWidgetItem::iconFilePath(QUrl::fromLocalFile(path)));
     } else if (pFType == FEATURE_INTERNAL) {
         return QImage(UBToolsManager::manager()->iconFromToolId(path));
     } else if (pFType == FEATURE_FLASH) {
-        return QImage(":images/libpalette/FlashIcon.svg");
+        return resourceIcon(":images/libpalette/FlashIcon.svg");
     } else if (pFType == FEATURE_AUDIO) {
-        return QImage(":images/libpalette/soundIcon.svg");
+        return resourceIcon(":images/libpalette/soundIcon.svg");
     } else if (pFType == FEATURE_VIDEO) {
-        return QImage(":images/libpalette/movieIcon.svg");
+        return resourceIcon(":images/libpalette/movieIcon.svg");
     } else if (pFType == FEATURE_IMAGE) {
-        QFile file(path);
-        QImage pix;
-
-        if (file.open(QFile::ReadOnly))
-        {
-            QImageReader imageReader(&file);
-            imageReader.setAutoTransform(true);
-            pix = imageReader.read();
-        }
+        QImage pix = imageIcon(path);
 
         if (pix.isNull()) {
-            pix = QImage(":images/libpalette/notFound.png");
-        } else {
-            pix = pix.scaledToWidth(qMin(UBSettings::maxThumbnailWidth, pix.width()));
+            pix = resourceIcon(":images/libpalette/notFound.png");
         }
         return pix;
     }
 
-    return QImage(":images/libpalette/notFound.png");
+    return resourceIcon(":images/libpalette/notFound.png");
+}
+
+/**
+ * @brief Icon from the resources, rendered only once as the scanning thread asks for it for every file.
+ */
+QImage UBFeaturesController::resourceIcon(const QString &path)
+{
+    static QMutex mutex;
+    static QHash<QString, QImage> icons;
+
+    QMutexLocker locker(&mutex);
+
+    auto it = icons.constFind(path);
+
+    if (it == icons.constEnd()) {
+        it = icons.insert(path, QImage(path));
+    }
+
+    return *it;
+}
+
+/**
+ * @brief Thumbnail of a library image, kept in an icon cache on disk.
+ *
+ * The cache entry is named after the name, size and modification time of the image, so that a
+ * modified file gets a new thumbnail. Only a missing entry requires to decode the image, which
+ * is then read directly at the thumbnail size.
+ *
+ * @return a null image if the file cannot be read.
+ */
+QImage UBFeaturesController::imageIcon(const QString &path)
+{
+    QFileInfo fileInfo(path);
+    QString cacheDirectory = iconCacheDirectory(fileInfo.absolutePath());
+    QString cachePath = cacheDirectory + "/" + iconCacheName(fileInfo);
+
+    QImage pix(cachePath);
+
+    if (!pix.isNull()) {
+        return pix;
+    }
+
+    QImageReader imageReader(path);
+    imageReader.setAutoTransform(true);
+
+    QSize size = imageReader.size();
+    bool rotated = imageReader.transformation() & QImageIOHandler::TransformationRotate90;
+    int width = rotated ? size.height() : size.width();
+
+    if (width > UBSettings::maxThumbnailWidth) {
+        // the JPEG decoder skips most of the work when reading at a reduced size
+        imageReader.setScaledSize(size * UBSettings::maxThumbnailWidth / width);
+    }
+
+    pix = imageReader.read();
+
+    if (pix.isNull()) {
+        return pix;
+    }
+
+    if (pix.width() > UBSettings::maxThumbnailWidth) {
+        pix = pix.scaledToWidth(UBSettings::maxThumbnailWidth);
+    }
+
+    QDir().mkpath(cacheDirectory);
+    QSaveFile cacheFile(cachePath);
+
+    if (cacheFile.open(QIODevice::WriteOnly) && pix.save(&cacheFile, "PNG")) {
+        cacheFile.commit();
+    }
+
+    return pix;
+}
+
+/**
+ * @brief Folder of the icon cache holding the thumbnails of the images of a directory.
+ */
+QString UBFeaturesController::iconCacheDirectory(const QString &directory)
+{
+    static const QString cacheDirectory = UBSettings::userLibraryIconCacheDirectory();
+
+    return cacheDirectory + "/" + QCryptographicHash::hash(directory.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+QString UBFeaturesController::iconCacheName(const QFileInfo &fileInfo)
+{
+    QByteArray key = fileInfo.fileName().toUtf8()
+            + '\n' + QByteArray::number(fileInfo.size())
+            + '\n' + QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch());
+
+    return QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()) + ".png";
+}
+
+/**
+ * @brief Remove the cached thumbnails that no longer match an image of the scanned directories.
+ *
+ * @param directoryImages the images found in each scanned directory
+ * @param allDirectories also remove the thumbnails of the directories that were not scanned
+ */
+void UBFeaturesController::pruneIconCache(const QHash<QString, QFileInfoList> &directoryImages, bool allDirectories)
+{
+    QSet<QString> cacheDirectories;
+
+    for (auto it = directoryImages.cbegin(); it != directoryImages.cend(); ++it) {
+        const QString cacheDirectory = iconCacheDirectory(it.key());
+        QSet<QString> cacheNames;
+
+        for (const QFileInfo &fileInfo : it.value()) {
+            cacheNames.insert(iconCacheName(fileInfo));
+        }
+
+        const QStringList cacheFiles = QDir(cacheDirectory).entryList(QDir::Files);
+
+        for (const QString &cacheFile : cacheFiles) {
+            if (!cacheNames.contains(cacheFile)) {
+                QFile::remove(cacheDirectory + "/" + cacheFile);
+            }
+        }
+
+        if (cacheNames.isEmpty()) {
+            QDir().rmdir(cacheDirectory);
+        }
+
+        cacheDirectories.insert(QFileInfo(cacheDirectory).fileName());
+    }
+
+    if (!allDirectories) {
+        return;
+    }
+
+    const QFileInfoList cacheEntries = QDir(UBSettings::userLibraryIconCacheDirectory()).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+
+    for (const QFileInfo &cacheEntry : cacheEntries) {
+        if (!cacheEntry.isDir()) {
+            // thumbnail of the former layout, without a folder per directory
+            QFile::remove(cacheEntry.absoluteFilePath());
+        } else if (!cacheDirectories.contains(cacheEntry.fileName())) {
+            QDir(cacheEntry.absoluteFilePath()).removeRecursively();
+        }
+    }
 }
 
 bool UBFeaturesController::isDeletable( const QUrl &url )
@@ -1115,9 +1493,15 @@ void UBFeaturesController::rescanModel()
 {
     featuresModel->removeRows(0, featuresList->count());
 
-    //Could implement infolder scanning for better perfomance
+    // directories are watched again once their features are sent
+    if (!mWatchedDirectories.isEmpty()) {
+        mDirectoryWatcher.removePaths(mWatchedDirectories.keys());
+        mWatchedDirectories.clear();
+    }
+
     scanFS();
     refreshModels();
+    startThread();
 }
 
 void UBFeaturesController::siftElements(const QString &pSiftValue)
@@ -46,6 +46,8 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QListView>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
 
 class UBFeaturesModel;
 class UBFeaturesItemDelegate;
@@ -64,6 +66,7 @@ public:
     explicit UBFeaturesComputingThread(QObject *parent = 0);
     virtual ~UBFeaturesComputingThread();
         void compute(const QList<QPair<QUrl, UBFeature> > &pScanningData, QSet<QUrl> *pFavoritesSet);
+    void update(const QString &path, const QString &virtualPath, const QSet<QString> &listedFiles);
 
 protected:
     void run();
@@ -76,14 +79,25 @@ signals:
     void maxFilesCountEvaluated(int max);
     void scanCategory(const QString &str);
     void scanPath(const QString &str);
+    void directoryScanned(const QString &path, const QString &virtualPath);
+    void directoryUpdated(const QString &path, const QString &virtualPath, const QList<UBFeature> &newFeatures, const QStringList &currentFiles);
 
 public slots:
 
 private:
-    void scanFS(const QUrl & currentPath, const QString & currVirtualPath, const QSet<QUrl> &pFavoriteSet);
+    struct ScanEntry;
+
+    // a watched directory to list again, the files already in the model are not sent back
+    struct DirectoryUpdate
+    {
+        QString path;
+        QString virtualPath;
+        QSet<QString> listedFiles;
+    };
+
+    void listFS(const QString &currentPath, const QString &currVirtualPath, int category, QList<ScanEntry> &entries);
     void scanAll(QList<QPair<QUrl, UBFeature> > pScanningData, const QSet<QUrl> &pFavoriteSet);
-    int featuresCount(const QUrl &pPath);
-    int featuresCountAll(QList<QPair<QUrl, UBFeature> > pScanningData);
+    void scanDirectory(const DirectoryUpdate &pUpdate);
 
 private:
     QMutex mMutex;
@@ -92,6 +106,7 @@ private:
     QString mScanningVirtualPath;
     QList<QPair<QUrl, UBFeature> > mScanningData;
     QSet<QUrl> mFavoriteSet;
+    QList<DirectoryUpdate> mDirectoryUpdates;
     bool restart;
     bool abort;
 };
@@ -211,6 +226,7 @@ public:
 
     static QString fileNameFromUrl( const QUrl &url );
     static QImage getIcon( const QString &path, UBFeatureElementType pFType );
+    static void pruneIconCache(const QHash<QString, QFileInfoList> &directoryImages, bool allDirectories);
     static bool isDeletable( const QUrl &url );
     static char featureTypeSplitter() {return ':';}
     static QString categoryNameForVirtualPath(const QString &str);
@@ -249,6 +265,9 @@ private slots:
     void addNewFolder(QString name);
     void startThread();
     void createNpApiFeature(const QString &str);
+    void watchDirectory(const QString &path, const QString &virtualPath);
+    void updateDirectory(const QString &path);
+    void applyDirectoryUpdate(const QString &path, const QString &virtualPath, const QList<UBFeature> &newFeatures, const QStringList &currentFiles);
 
 private:
 
@@ -266,6 +285,12 @@ private:
 private:
 
     static QImage createThumbnail(const QString &path);
+    static QImage resourceIcon(const QString &path);
+    static QImage imageIcon(const QString &path);
+    static QString iconCacheDirectory(const QString &directory);
+    static QString iconCacheName(const QFileInfo &fileInfo);
+    QHash<QString, UBFeature> directoryFeatures(const QString &path, const QString &virtualPath) const;
+    void removeDirectoryFeatures(const UBFeature &folder);
     //void addImageToCurrentPage( const QString &path );
     void loadFavoriteList();
     void saveFavoriteList();
@@ -292,6 +317,10 @@ private:
     QUrl trashDirectoryPath;
     QUrl mLibSearchDirectoryPath;
 
+    // scanned directories and their virtual path, refreshed when their content changes
+    QFileSystemWatcher mDirectoryWatcher;
+    QHash<QString, QString> mWatchedDirectories;
+
 
 
     int mLastItemOffsetIndex;
@@ -44,6 +44,7 @@
 #include "UBDocumentManager.h"
 #include "UBPreferencesController.h"
 #include "UBIdleTimer.h"
+#include "UBImageCache.h"
 #include "UBApplicationController.h"
 #include "UBShortcutManager.h"
 
@@ -166,6 +167,8 @@ UBApplication::~UBApplication()
 
     UBPersistenceManager::destroy();
 
+    UBImageCache::instance().clear();
+
     UBDownloadManager::destroy();
 
     UBDrawingController::destroy();
@@ -302,7 +305,11 @@ void UBApplication::setupTranslators(QStringList args)
     qDebug() << "Running application in:" << language;
 }
 
-int UBApplication::exec(const QString& pFileToImport)
+/**
+ * Create the main window and the controllers. exec() calls this before entering the event loop,
+ * the benchmark calls it directly to work on the same environment as the application.
+ */
+void UBApplication::setup(const QString& pFileToImport)
 {
     QPixmapCache::setCacheLimit(1024 * 100);
 
@@ -421,6 +428,12 @@ int UBApplication::exec(const QString& pFileToImport)
 
     onScreenCountChanged(displayManager->numScreens());
     connect(displayManager, SIGNAL(availableScreenCountChanged(int)), this, SLOT(onScreenCountChanged(int)));
+}
+
+int UBApplication::exec(const QString& pFileToImport)
+{
+    setup(pFileToImport);
+
     return QApplication::exec();
 }
 
@@ -64,6 +64,7 @@ class UBApplication : public SingleApplication
         UBApplication(const QString &id, int &argc, char **argv);
         virtual ~UBApplication();
 
+        void setup(const QString& pFileToImport);
         int exec(const QString& pFileToImport);
 
         void cleanup();
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "UBDocumentIndex.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include "adaptors/UBMetadataDcSubsetAdaptor.h"
+#include "core/UBPersistenceManager.h"
+#include "document/UBDocumentProxy.h"
+
+namespace
+{
+    constexpr quint32 cIndexMagic{0x55424449}; // "UBDI"
+    constexpr quint32 cIndexVersion{2};
+
+    QDataStream& operator<<(QDataStream& stream, const UBDocumentIndex::Entry& entry)
+    {
+        return stream << entry.folderName << entry.folderModified << entry.metadataModified << qint32(entry.pageCount) << entry.metadata
+                      << entry.hasPageManifest << entry.pageIds;
+    }
+
+    QDataStream& operator>>(QDataStream& stream, UBDocumentIndex::Entry& entry)
+    {
+        qint32 pageCount{0};
+        stream >> entry.folderName >> entry.folderModified >> entry.metadataModified >> pageCount >> entry.metadata
+               >> entry.hasPageManifest >> entry.pageIds;
+        entry.pageCount = pageCount;
+        return stream;
+    }
+
+    QDateTime metadataModified(const QFileInfo& folder)
+    {
+        return QFileInfo(folder.absoluteFilePath() + "/" + UBMetadataDcSubsetAdaptor::metadataFilename).lastModified();
+    }
+}
+
+UBDocumentIndex::UBDocumentIndex(const QString& fileName)
+    : mFileName{fileName}
+{
+}
+
+void UBDocumentIndex::load()
+{
+    mLoadedEntries.clear();
+
+    QFile file{mFileName};
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic{0};
+    quint32 version{0};
+    quint32 count{0};
+    stream >> magic >> version >> count;
+
+    if (magic != cIndexMagic || version != cIndexVersion)
+    {
+        qDebug() << "Ignoring document index" << mFileName << "with unknown format";
+        return;
+    }
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        Entry entry;
+        stream >> entry;
+
+        if (stream.status() == QDataStream::Ok)
+        {
+            mLoadedEntries.insert(entry.folderName, entry);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        qWarning() << "Document index" << mFileName << "is corrupted, rescanning all documents";
+        mLoadedEntries.clear();
+    }
+}
+
+/**
+ * @brief Write the entries of all documents found since loading.
+ *
+ * Entries of deleted documents and outdated entries are dropped.
+ */
+void UBDocumentIndex::save() const
+{
+    QSaveFile file{mFileName};
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Cannot write document index" << mFileName;
+        return;
+    }
+
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << cIndexMagic << cIndexVersion << quint32(mEntries.size());
+
+    for (const auto& entry : mEntries)
+    {
+        stream << entry;
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+    {
+        qWarning() << "Cannot write document index" << mFileName;
+    }
+}
+
+/**
+ * @brief Create the proxy of a document folder from the index.
+ * @return nullptr if the folder is not indexed or was modified since.
+ */
+std::shared_ptr<UBDocumentProxy> UBDocumentIndex::proxy(const QFileInfo& folder)
+{
+    const auto it = mLoadedEntries.constFind(folder.fileName());
+
+    if (it == mLoadedEntries.constEnd()
+            || it->folderModified != folder.lastModified()
+            || it->metadataModified != metadataModified(folder))
+    {
+        return nullptr;
+    }
+
+    mEntries.insert(it->folderName, *it);
+    return createProxy(folder.absolutePath(), *it);
+}
+
+void UBDocumentIndex::insert(const Entry& entry)
+{
+    mEntries.insert(entry.folderName, entry);
+}
+
+/**
+ * @brief Read the metadata and count the pages of a document folder.
+ *
+ * This function is thread safe. The modification times are taken first, so that
+ * modifications done while scanning invalidate the entry.
+ */
+UBDocumentIndex::Entry UBDocumentIndex::scan(const QFileInfo& folder)
+{
+    Entry entry;
+    entry.folderName = folder.fileName();
+    entry.folderModified = folder.lastModified();
+    entry.metadataModified = metadataModified(folder);
+
+    const auto proxy = UBPersistenceManager::createDocumentProxyStructure(folder);
+    entry.pageCount = proxy->pageCount();
+    entry.metadata = proxy->metaDatas();
+    entry.hasPageManifest = proxy->hasPageManifest();
+    entry.pageIds = proxy->pageIds();
+
+    return entry;
+}
+
+std::shared_ptr<UBDocumentProxy> UBDocumentIndex::createProxy(const QString& repositoryPath, const Entry& entry)
+{
+    auto proxy = std::make_shared<UBDocumentProxy>(repositoryPath + "/" + entry.folderName);
+
+    for (auto it = entry.metadata.constBegin(); it != entry.metadata.constEnd(); ++it)
+    {
+        proxy->setMetaData(it.key(), it.value());
+    }
+
+    proxy->setPageCount(entry.pageCount);
+
+    if (entry.hasPageManifest)
+    {
+        proxy->setPageIds(entry.pageIds);
+    }
+
+    return proxy;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+#include <QVariant>
+
+#include <memory>
+
+class UBDocumentProxy;
+
+/**
+ * @brief The UBDocumentIndex class caches the information needed to list the documents.
+ *
+ * Reading the metadata and counting the pages of every document folder is slow for large
+ * repositories. The index stores this information in a single file. An entry is only used
+ * if neither the folder nor its metadata file was modified since the entry was created.
+ */
+class UBDocumentIndex
+{
+public:
+    struct Entry
+    {
+        QString folderName;
+        QDateTime folderModified;
+        QDateTime metadataModified;
+        int pageCount{0};
+        QMap<QString, QVariant> metadata;
+        bool hasPageManifest{false};
+        QStringList pageIds{};
+    };
+
+    explicit UBDocumentIndex(const QString& fileName);
+
+    void load();
+    void save() const;
+
+    std::shared_ptr<UBDocumentProxy> proxy(const QFileInfo& folder);
+    void insert(const Entry& entry);
+
+    static Entry scan(const QFileInfo& folder);
+    static std::shared_ptr<UBDocumentProxy> createProxy(const QString& repositoryPath, const Entry& entry);
+
+private:
+    QString mFileName;
+    QHash<QString, Entry> mLoadedEntries{};
+    QHash<QString, Entry> mEntries{};
+};
@@ -481,15 +481,16 @@ private:
 class PageCopier
 {
 public:
-    void copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex)
+    void copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex, const QString &fromPage, const QString &toPage)
     {
         mFromDir = fromDir.toLocalFile();
         mToDir = toDir.toLocalFile();
         mFromIndex = fromIndex;
         mToIndex = toIndex;
 
-        QString svgFrom = mFromDir + "/" + svgPageName(fromIndex);
-        QString svgTo = toDir.toLocalFile() + "/" + svgPageName(toIndex);
+        // documents with a page manifest pass the file names of their pages
+        QString svgFrom = mFromDir + "/" + (fromPage.isEmpty() ? svgPageName(fromIndex) : fromPage);
+        QString svgTo = toDir.toLocalFile() + "/" + (toPage.isEmpty() ? svgPageName(toIndex) : toPage);
         QDomDocument dd = createDomFromSvg(svgFrom);
         QFile fl(svgTo);
         if (!fl.open(QIODevice::WriteOnly)) {
@@ -608,10 +609,10 @@ public:
         cleaner = 0;
     }
 
-    void copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex)
+    void copyPage (const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex, const QString &fromPage, const QString &toPage)
     {
         PageCopier *copier = new PageCopier;
-        copier->copyPage(fromDir, fromIndex, toDir, toIndex);
+        copier->copyPage(fromDir, fromIndex, toDir, toIndex, fromPage, toPage);
         delete copier;
         copier = 0;
     }
@@ -644,8 +645,8 @@ void UBForeighnObjectsHandler::cure(const QUrl &dir)
     d->cure(dir);
 }
 
-void UBForeighnObjectsHandler::copyPage(const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex)
+void UBForeighnObjectsHandler::copyPage(const QUrl &fromDir, int fromIndex, const QUrl &toDir, int toIndex, const QString &fromPage, const QString &toPage)
 {
-    d->copyPage(fromDir, fromIndex, toDir, toIndex);
+    d->copyPage(fromDir, fromIndex, toDir, toIndex, fromPage, toPage);
 }
 
@@ -28,6 +28,7 @@
 #define UBFOREIGHNOBJECTSHANDLER_H
 
 #include <QList>
+#include <QString>
 #include <QUrl>
 #include <algorithm>
 
@@ -43,7 +44,8 @@ public:
     void cure(const QUrl &dir);
 
     void copyPage(const QUrl &fromDir, int fromIndex,
-                  const QUrl &toDir, int toIndex);
+                  const QUrl &toDir, int toIndex,
+                  const QString &fromPage = QString(), const QString &toPage = QString());
 
 private:
     UBForeighnObjectsHandlerPrivate *d;
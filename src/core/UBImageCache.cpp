@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include "UBImageCache.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QtConcurrent>
+
+#include "core/UBApplication.h"
+#include "core/UBSettings.h"
+
+namespace
+{
+    // no mip level smaller than this is created
+    constexpr int cMinimumLevelSize{32};
+}
+
+UBImageCache::Image::Image(const QString& path, const QDateTime& modified, const QPixmap& pixmap)
+    : mPath{path}
+    , mModified{modified}
+    , mPixmap{pixmap}
+{
+    // account for all the mip levels at once, the cache size then does not change when they are created
+    int width = mPixmap.width();
+    int height = mPixmap.height();
+    int extent = qMin(width, height);
+    mByteSize = qint64(width) * height * mPixmap.depth() / 8;
+
+    while (extent / 2 >= cMinimumLevelSize)
+    {
+        width /= 2;
+        height /= 2;
+        extent /= 2;
+        mByteSize += qint64(width) * height * mPixmap.depth() / 8;
+    }
+}
+
+const QPixmap& UBImageCache::Image::pixmap() const
+{
+    return mPixmap;
+}
+
+/**
+ * @brief Get a mip level, creating the missing levels from the next larger one.
+ */
+const QPixmap& UBImageCache::Image::level(int level) const
+{
+    if (level <= 0)
+    {
+        return mPixmap;
+    }
+
+    while (mLevels.size() < level)
+    {
+        const QPixmap& larger = mLevels.isEmpty() ? mPixmap : mLevels.last();
+        mLevels.append(larger.scaled(larger.size() / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+
+    return mLevels.at(level - 1);
+}
+
+/**
+ * @brief Smallest mip level which is still drawn at least at its own resolution.
+ * @param scale number of device pixels per pixel of the image
+ */
+int UBImageCache::Image::levelForScale(qreal scale) const
+{
+    int level = 0;
+    int extent = qMin(mPixmap.width(), mPixmap.height());
+
+    while (scale <= 0.5 && extent / 2 >= cMinimumLevelSize)
+    {
+        scale *= 2;
+        extent /= 2;
+        ++level;
+    }
+
+    return level;
+}
+
+/**
+ * @brief Memory used by the image with all the mip levels it can create.
+ */
+qint64 UBImageCache::Image::byteSize() const
+{
+    return mByteSize;
+}
+
+UBImageCache::UBImageCache()
+{
+    // leave one core to the GUI thread
+    mDecoderPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
+}
+
+UBImageCache& UBImageCache::instance()
+{
+    static UBImageCache cache;
+    return cache;
+}
+
+/**
+ * @brief Size of the image in a file as it will be decoded, read from the file header only.
+ * @return an invalid size if the file cannot be read.
+ */
+QSize UBImageCache::imageSize(const QString& path)
+{
+    QImageReader reader{path};
+    reader.setAutoTransform(true);
+    QSize size = reader.size();
+
+    if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+    {
+        size.transpose();
+    }
+
+    return size;
+}
+
+/**
+ * @brief Get the decoded image of a file.
+ * @return nullptr if the file cannot be read.
+ */
+std::shared_ptr<const UBImageCache::Image> UBImageCache::image(const QString& path)
+{
+    auto image = cachedImage(path);
+
+    if (image)
+    {
+        return image;
+    }
+
+    const QFileInfo fileInfo{path};
+    return insert(fileInfo.absoluteFilePath(), fileInfo.lastModified(), readImage(path));
+}
+
+/**
+ * @brief Get the decoded image of a file only if it is already in the cache.
+ */
+std::shared_ptr<const UBImageCache::Image> UBImageCache::cachedImage(const QString& path)
+{
+    const QFileInfo fileInfo{path};
+    auto it = mImages.find(fileInfo.absoluteFilePath());
+
+    if (it == mImages.end())
+    {
+        return nullptr;
+    }
+
+    auto image = it->image.lock();
+
+    if (!image)
+    {
+        // the last item using the image is gone
+        mImages.erase(it);
+        return nullptr;
+    }
+
+    if (image->mModified != fileInfo.lastModified())
+    {
+        return nullptr;
+    }
+
+    touch(*it, image);
+    return image;
+}
+
+/**
+ * @brief Decode an image file in the background.
+ *
+ * Requests for a file already being decoded share the same decode. The callback is not
+ * invoked if the receiver is deleted in the meantime.
+ *
+ * @param callback invoked on the GUI thread with the image or nullptr if the file cannot be read,
+ * immediately when the image is already in the cache.
+ */
+void UBImageCache::requestImage(const QString& path, QObject* receiver, Callback callback)
+{
+    auto image = cachedImage(path);
+
+    if (image)
+    {
+        callback(image);
+        return;
+    }
+
+    const QFileInfo fileInfo{path};
+    const QString key = fileInfo.absoluteFilePath();
+    const QDateTime modified = fileInfo.lastModified();
+    const bool decoding = mPendingRequests.contains(key);
+
+    mPendingRequests[key].append({receiver, callback});
+
+    if (!decoding)
+    {
+        QtConcurrent::run(&mDecoderPool, [key, modified]() {
+            if (UBApplication::isClosing)
+            {
+                return;
+            }
+
+            const QImage decoded = readImage(key);
+
+            // QPixmap can only be created on the GUI thread
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [key, modified, decoded]() {
+                UBImageCache::instance().imageDecoded(key, modified, decoded);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void UBImageCache::clear()
+{
+    mDecoderPool.clear();
+    mDecoderPool.waitForDone();
+
+    mPendingRequests.clear();
+    mLru.clear();
+    mImages.clear();
+    mCacheSize = 0;
+}
+
+/**
+ * @brief Decode an image file, can be called from any thread.
+ */
+QImage UBImageCache::readImage(const QString& path)
+{
+    QImageReader reader{path};
+    reader.setAutoTransform(true);
+    const QImage decoded = reader.read();
+
+    if (decoded.isNull())
+    {
+        qWarning() << "Cannot read image" << path << reader.errorString();
+    }
+
+    return decoded;
+}
+
+std::shared_ptr<const UBImageCache::Image> UBImageCache::insert(const QString& key, const QDateTime& modified, const QImage& decoded)
+{
+    if (decoded.isNull())
+    {
+        return nullptr;
+    }
+
+    auto image = std::make_shared<const Image>(key, modified, QPixmap::fromImage(decoded));
+    auto it = mImages.find(key);
+
+    if (it == mImages.end())
+    {
+        it = mImages.insert(key, {image, mLru.end()});
+    }
+    else
+    {
+        // the file was modified, the previous image is only kept by its items
+        if (it->lru != mLru.end())
+        {
+            mCacheSize -= (*it->lru)->byteSize();
+            mLru.erase(it->lru);
+        }
+
+        *it = {image, mLru.end()};
+    }
+
+    touch(*it, image);
+
+    return image;
+}
+
+void UBImageCache::imageDecoded(const QString& key, const QDateTime& modified, const QImage& decoded)
+{
+    const auto requests = mPendingRequests.take(key);
+
+    if (requests.isEmpty())
+    {
+        // cache was cleared while decoding
+        return;
+    }
+
+    // a synchronous read may have been faster
+    auto it = mImages.constFind(key);
+    auto image = it != mImages.constEnd() ? it->image.lock() : nullptr;
+
+    if (!image || image->mModified != modified)
+    {
+        image = insert(key, modified, decoded);
+    }
+
+    for (const auto& request : requests)
+    {
+        if (request.first)
+        {
+            request.second(image);
+        }
+    }
+}
+
+void UBImageCache::touch(Entry& entry, const std::shared_ptr<const Image>& image)
+{
+    if (entry.lru != mLru.end())
+    {
+        mLru.splice(mLru.begin(), mLru, entry.lru);
+        return;
+    }
+
+    mLru.push_front(image);
+    entry.lru = mLru.begin();
+    mCacheSize += image->byteSize();
+
+    evict();
+}
+
+void UBImageCache::evict()
+{
+    const qint64 budget = UBSettings::settings()->imageCacheMemoryLimit->get().toLongLong() * 1024 * 1024;
+
+    // keep at least the image just used
+    while (mCacheSize > budget && mLru.size() > 1)
+    {
+        const std::shared_ptr<const Image> image = mLru.back();
+        mCacheSize -= image->byteSize();
+        mLru.pop_back();
+
+        auto it = mImages.find(image->mPath);
+
+        // images still used by an item stay shared, the others are freed
+        if (image.use_count() > 1)
+        {
+            it->lru = mLru.end();
+        }
+        else
+        {
+            mImages.erase(it);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QPixmap>
+#include <QPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include <functional>
+#include <list>
+#include <memory>
+
+/**
+ * @brief The UBImageCache class shares decoded image files between all items showing them.
+ *
+ * An image is identified by its file path and modification time, so that a replaced file is
+ * decoded again. Each image keeps downscaled copies (mip levels) which are created on demand,
+ * so that views with a small zoom factor like thumbnails or the display screen do not scale
+ * the full resolution image at every paint.
+ *
+ * Images stay in the cache as long as an item uses them. Unused images are kept from the
+ * most to the least recently used until the memory limit of the cache is reached.
+ *
+ * Images can also be requested asynchronously. They are then decoded on a worker pool and
+ * the callback is invoked on the GUI thread once the image is in the cache.
+ *
+ * All functions must be called from the GUI thread.
+ */
+class UBImageCache
+{
+public:
+    class Image
+    {
+    public:
+        Image(const QString& path, const QDateTime& modified, const QPixmap& pixmap);
+
+        const QPixmap& pixmap() const;
+        const QPixmap& level(int level) const;
+        int levelForScale(qreal scale) const;
+        qint64 byteSize() const;
+
+    private:
+        friend class UBImageCache;
+
+        QString mPath;
+        QDateTime mModified;
+        QPixmap mPixmap;
+        qint64 mByteSize;
+
+        // level n has half the size of level n - 1, level 0 is the pixmap itself
+        mutable QVector<QPixmap> mLevels;
+    };
+
+    typedef std::function<void(std::shared_ptr<const Image>)> Callback;
+
+    static UBImageCache& instance();
+    static QSize imageSize(const QString& path);
+
+    std::shared_ptr<const Image> image(const QString& path);
+    std::shared_ptr<const Image> cachedImage(const QString& path);
+    void requestImage(const QString& path, QObject* receiver, Callback callback);
+    void clear();
+
+private:
+    UBImageCache();
+
+    static QImage readImage(const QString& path);
+
+    typedef std::list<std::shared_ptr<const Image>> LruList;
+
+    struct Entry
+    {
+        std::weak_ptr<const Image> image;
+        LruList::iterator lru;          // mLru.end() if the image is only kept by its items
+    };
+
+    std::shared_ptr<const Image> insert(const QString& key, const QDateTime& modified, const QImage& decoded);
+    void imageDecoded(const QString& key, const QDateTime& modified, const QImage& decoded);
+    void touch(Entry& entry, const std::shared_ptr<const Image>& image);
+    void evict();
+
+    QHash<QString, Entry> mImages;
+
+    // unused images are kept alive by this list, most recently used first
+    LruList mLru;
+    qint64 mCacheSize{0};
+
+    // callbacks waiting for an image being decoded, by file path
+    QHash<QString, QList<std::pair<QPointer<QObject>, Callback>>> mPendingRequests;
+    QThreadPool mDecoderPool;
+};
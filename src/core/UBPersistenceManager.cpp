@@ -35,6 +35,7 @@
 #include <QXmlStreamWriter>
 #include <QModelIndex>
 #include <QtConcurrent>
+#include <QSaveFile>
 
 #include "frameworks/UBPlatformUtils.h"
 #include "frameworks/UBFileSystemUtils.h"
@@ -74,6 +75,8 @@ const QString UBPersistenceManager::myDocumentsName = "MyDocuments";
 const QString UBPersistenceManager::modelsName = "Models";
 const QString UBPersistenceManager::untitledDocumentsName = "UntitledDocuments";
 const QString UBPersistenceManager::fFolders = "folders.xml";
+const QString UBPersistenceManager::fDocumentIndex = "documents.index";
+const QString UBPersistenceManager::fPageManifest = "pages.manifest";
 const QString UBPersistenceManager::tFolder = "folder";
 const QString UBPersistenceManager::aName = "name";
 
@@ -83,9 +86,14 @@ UBPersistenceManager * UBPersistenceManager::sSingleton = 0;
 UBPersistenceManager::UBPersistenceManager(QObject *pParent)
     : QObject(pParent)
     , mHasPurgedDocuments(false)
+    , mDocumentIndex(nullptr)
+    , mDocumentIndexWatcher(nullptr)
     , mIsWorkerFinished(false)
     , mReplaceDialogReturnedReplaceAll(false)
     , mReplaceDialogReturnedCancel(false)
+    , mLastLoadedSceneIndex(-1)
+    , mNavigationDirection(0)
+    , mNavigationStreak(0)
 {
 
     xmlFolderStructureFilename = "model";
@@ -159,8 +167,20 @@ UBPersistenceManager::~UBPersistenceManager()
 
     while(!mIsWorkerFinished)
         QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+
+    UBThumbnailAdaptor::waitForPendingThumbnails();
     qDebug() << "stop waiting after " << t.elapsed() << " ms";
 
+    if (mDocumentIndexWatcher && mDocumentIndexWatcher->isRunning())
+    {
+        // keep the documents scanned so far
+        mDocumentIndexWatcher->cancel();
+        mDocumentIndexWatcher->waitForFinished();
+        mDocumentIndex->save();
+    }
+
+    delete mDocumentIndex;
+
     // to be sure that all the scenes are stored on disk
 }
 
@@ -192,16 +212,13 @@ void UBPersistenceManager::createDocumentProxiesStructure(const QFileInfoList &c
     {
         if (proxy)
         {
-            QString docGroupName = proxy->metaData(UBSettings::documentGroupName).toString();
-            QModelIndex parentIndex = mDocumentTreeStructureModel->goTo(docGroupName);
-            if (parentIndex.isValid())
+            if (!interactive)
             {
-                if (!interactive)
-                   mDocumentTreeStructureModel->addDocument(proxy, parentIndex);
-                else
-                {
-                   processInteractiveReplacementDialog(proxy, true);
-                }
+                addDocumentToTree(proxy);
+            }
+            else if (mDocumentTreeStructureModel->goTo(proxy->metaData(UBSettings::documentGroupName).toString()).isValid())
+            {
+                processInteractiveReplacementDialog(proxy, true);
             }
             else
             {
@@ -227,7 +244,14 @@ void UBPersistenceManager::createDocumentProxiesStructure(bool interactive)
     mProgress.setLabelText(tr("Retrieving all your documents (found : %1)").arg(contentInfoList.size()));
     mProgress.setCancelButton(nullptr);
 
-    createDocumentProxiesStructure(contentInfoList, interactive);
+    if (interactive)
+    {
+        createDocumentProxiesStructure(contentInfoList, interactive);
+    }
+    else
+    {
+        loadIndexedDocuments(contentInfoList);
+    }
 
     if (QFileInfo(mFoldersXmlStorageName).exists()) {
         QDomDocument xmlDom;
@@ -254,6 +278,76 @@ void UBPersistenceManager::createDocumentProxiesStructure(bool interactive)
     }
 }
 
+/**
+ * @brief Add the documents of the repository using the document index.
+ *
+ * Documents whose folder is unchanged since the index was written are added immediately.
+ * New and modified folders are scanned in the background and their documents are added
+ * as soon as they are available. The index is rewritten when the scan is finished.
+ */
+void UBPersistenceManager::loadIndexedDocuments(const QFileInfoList& contentInfoList)
+{
+    mDocumentIndex = new UBDocumentIndex(mDocumentRepositoryPath + "/" + fDocumentIndex);
+    mDocumentIndex->load();
+
+    QFileInfoList modifiedFolders;
+
+    for (const auto& contentInfo : contentInfoList)
+    {
+        std::shared_ptr<UBDocumentProxy> proxy = mDocumentIndex->proxy(contentInfo);
+
+        if (proxy)
+        {
+            addDocumentToTree(proxy);
+        }
+        else
+        {
+            modifiedFolders << contentInfo;
+        }
+    }
+
+    qDebug() << "Document index:" << contentInfoList.size() - modifiedFolders.size() << "documents indexed,"
+             << modifiedFolders.size() << "to scan";
+
+    if (modifiedFolders.isEmpty())
+    {
+        mDocumentIndex->save();
+        return;
+    }
+
+    mDocumentIndexWatcher = new QFutureWatcher<UBDocumentIndex::Entry>(this);
+
+    connect(mDocumentIndexWatcher, &QFutureWatcherBase::resultReadyAt, this, [this](int index){
+        const UBDocumentIndex::Entry entry = mDocumentIndexWatcher->resultAt(index);
+        mDocumentIndex->insert(entry);
+        addDocumentToTree(UBDocumentIndex::createProxy(mDocumentRepositoryPath, entry));
+    });
+
+    connect(mDocumentIndexWatcher, &QFutureWatcherBase::finished, this, [this](){
+        if (!mDocumentIndexWatcher->isCanceled())
+        {
+            mDocumentIndex->save();
+        }
+    });
+
+    mDocumentIndexWatcher->setFuture(QtConcurrent::mapped(modifiedFolders, &UBDocumentIndex::scan));
+}
+
+void UBPersistenceManager::addDocumentToTree(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
+{
+    QString docGroupName = pDocumentProxy->metaData(UBSettings::documentGroupName).toString();
+    QModelIndex parentIndex = mDocumentTreeStructureModel->goTo(docGroupName);
+
+    if (parentIndex.isValid())
+    {
+        mDocumentTreeStructureModel->addDocument(pDocumentProxy, parentIndex);
+    }
+    else
+    {
+        qDebug() << "something went wrong";
+    }
+}
+
 std::shared_ptr<UBDocumentProxy> UBPersistenceManager::createDocumentProxyStructure(const QFileInfo& contentInfo)
 {
     QString fullPath = contentInfo.absoluteFilePath();
@@ -596,6 +690,11 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::createDocument(const QStr
     doc->setMetaData(UBSettings::documentUpdatedAt,currentDate);
     doc->setMetaData(UBSettings::documentDate,currentDate);
 
+    if (directory.length() == 0 && UBSettings::settings()->documentUsePageManifest->get().toBool())
+    {
+        doc->setPageIds(QStringList());
+    }
+
     if (withEmptyPage)
     {
         createDocumentSceneAt(doc, 0);
@@ -608,6 +707,11 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::createDocument(const QStr
         {
             return nullptr; // if we can't create the path, abort function.
         }
+
+        if (doc->hasPageManifest())
+        {
+            writePageManifest(doc);
+        }
     }
 
     bool documentAdded = false;
@@ -751,7 +855,7 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::duplicateDocument(std::sh
 
     persistDocumentMetadata(copy);
 
-    copy->setPageCount(copy->pageCount());
+    copy->setPageCount(sceneCount(copy));
 
     emit documentCreated(copy);
 
@@ -783,67 +887,152 @@ void UBPersistenceManager::deleteDocumentScenes(std::shared_ptr<UBDocumentProxy>
     if (compactedIndexes.size() == 0)
         return;
 
+    const bool hasPageManifest = usesPageManifest(proxy);
+
+    auto scene = UBApplication::boardController->activeScene();
+
+    // save modified scene of the same document, the deleted pages are moved from disk
+    if (scene && scene->document() == proxy && scene->isModified())
+    {
+        auto page = UBApplication::boardController->activeSceneIndex();
+        persistDocumentScene(proxy, scene, page, false, true);
+    }
+
     QString sourceName = proxy->metaData(UBSettings::documentName).toString();
     std::shared_ptr<UBDocumentProxy> trashDocProxy = createDocument(UBSettings::trashedDocumentGroupNamePrefix/* + sourceGroupName*/, sourceName, false);
 
+    transferPages(proxy, compactedIndexes, trashDocProxy);
+
     foreach(int index, compactedIndexes)
     {
-        std::shared_ptr<UBGraphicsScene> scene = loadDocumentScene(proxy, index);
-        if (scene)
+        QFile::remove(proxy->pageFilePath(index));
+        UBThumbnailAdaptor::waitForPendingThumbnail(proxy->thumbnailFilePath(index));
+        QFile::remove(proxy->thumbnailFilePath(index));
+
+        proxy->decPageCount();
+    }
+
+    std::sort(compactedIndexes.begin(), compactedIndexes.end());
+
+    if (hasPageManifest)
+    {
+        // only the page order changes, the files of the following pages keep their names
+        for (int i = compactedIndexes.size() - 1; i >= 0; i--)
         {
-            //scene is about to move into new document
-            foreach (QUrl relativeFile, scene->relativeDependencies())
-            {
-                QString source = scene->document()->persistencePath() + "/" + relativeFile.toString();
-                QString target = trashDocProxy->persistencePath() + "/" + relativeFile.toString();
+            proxy->removePageId(compactedIndexes.at(i));
+        }
 
-                QFileInfo fi(target);
-                QDir d = fi.dir();
+        writePageManifest(proxy);
+    }
+    else
+    {
+        int offset = 1;
 
-                d.mkpath(d.absolutePath());
-                QFile::copy(source, target);
+        for (int i = compactedIndexes.at(0) + 1; i < pageCount; i++)
+        {
+            if(compactedIndexes.contains(i))
+            {
+                offset++;
+            }
+            else
+            {
+                renamePage(proxy, i , i - offset);
             }
-            insertDocumentSceneAt(trashDocProxy, scene, trashDocProxy->pageCount(), true, true);
         }
     }
 
-    for (int i = 1; i < indexes.size(); i++)
-    {
-        renamePage(trashDocProxy, i , i - 1);
-    }
+    mSceneCache.removeScenes(proxy, compactedIndexes);
+}
 
-    foreach(int index, compactedIndexes)
-    {
-        QString svgFileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", index);
 
-        QFile::remove(svgFileName);
+/**
+ * @brief Move pages to the end of another document without loading them.
+ *
+ * The page and thumbnail files are moved and only the scene uuid is rewritten. Media
+ * files referenced by the pages are copied, as other pages of the source document may
+ * still use them. The unreferenced ones are removed by the cleanup of the source document.
+ */
+void UBPersistenceManager::transferPages(std::shared_ptr<UBDocumentProxy> from, const QList<int>& indexes, std::shared_ptr<UBDocumentProxy> to)
+{
+    static const QRegularExpression uuidPattern("[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}");
 
-        QString thumbFileName = proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", index);
+    const bool hasPageManifest = usesPageManifest(to);
+    QSet<QString> references;
 
-        QFile::remove(thumbFileName);
+    for (int index : indexes)
+    {
+        const int targetIndex = to->pageCount();
+        const QString source = from->pageFilePath(index);
 
-        mSceneCache.removeScene(proxy, index);
+        QFile svgFile(source);
 
-        proxy->decPageCount();
+        if (svgFile.open(QFile::ReadOnly))
+        {
+            auto matches = uuidPattern.globalMatch(QString::fromUtf8(svgFile.readAll()));
 
-    }
+            while (matches.hasNext())
+            {
+                references << matches.next().captured().toLower();
+            }
 
-    std::sort(compactedIndexes.begin(), compactedIndexes.end());
+            svgFile.close();
+        }
 
-    int offset = 1;
+        if (hasPageManifest)
+        {
+            to->insertPageId(targetIndex);
+        }
 
-    for (int i = compactedIndexes.at(0) + 1; i < pageCount; i++)
-    {
-        if(compactedIndexes.contains(i))
+        if (!QFile::rename(source, to->pageFilePath(targetIndex)) && !QFile::copy(source, to->pageFilePath(targetIndex)))
         {
-            offset++;
+            qWarning() << "Cannot move page" << source << "to" << to->persistencePath();
+
+            if (hasPageManifest)
+            {
+                to->removePageId(targetIndex);
+            }
+
+            continue;
         }
-        else
+
+        // a missing thumbnail is generated again
+        UBThumbnailAdaptor::waitForPendingThumbnail(from->thumbnailFilePath(index));
+        UBThumbnailAdaptor::waitForPendingThumbnail(to->thumbnailFilePath(targetIndex));
+        QFile::rename(from->thumbnailFilePath(index), to->thumbnailFilePath(targetIndex));
+
+        UBSvgSubsetAdaptor::setSceneUuid(to, targetIndex, QUuid::createUuid());
+        to->incPageCount();
+    }
+
+    if (hasPageManifest)
+    {
+        writePageManifest(to);
+    }
+
+    for (const QString& folder : std::as_const(mDocumentSubDirectories))
+    {
+        const QFileInfoList entries = QDir(from->persistencePath() + "/" + folder).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+
+        for (const QFileInfo& entry : entries)
         {
-            renamePage(proxy, i , i - offset);
+            QRegularExpressionMatch match = uuidPattern.match(entry.fileName());
 
-            mSceneCache.moveScene(proxy, i, i - offset);
+            if (!match.hasMatch() || !references.contains(match.captured().toLower()))
+            {
+                continue;
+            }
 
+            const QString target = to->persistencePath() + "/" + folder + "/" + entry.fileName();
+            QDir().mkpath(QFileInfo(target).absolutePath());
+
+            if (entry.isDir())
+            {
+                UBFileSystemUtils::copyDir(entry.absoluteFilePath(), target);
+            }
+            else
+            {
+                QFile::copy(entry.absoluteFilePath(), target);
+            }
         }
     }
 }
@@ -862,13 +1051,21 @@ void UBPersistenceManager::duplicateDocumentScene(std::shared_ptr<UBDocumentProx
         persistDocumentScene(proxy, scene, page, false, true);
     }
 
-    for (int i = proxy->pageCount(); i > index + 1; i--)
+    if (usesPageManifest(proxy))
     {
-        renamePage(proxy, i - 1 , i);
-
-        mSceneCache.moveScene(proxy, i - 1, i);
+        proxy->insertPageId(index + 1);
+        writePageManifest(proxy);
+    }
+    else
+    {
+        for (int i = proxy->pageCount(); i > index + 1; i--)
+        {
+            renamePage(proxy, i - 1 , i);
+        }
     }
 
+    mSceneCache.shiftUpScenes(proxy, index + 1, proxy->pageCount() - 1);
+
     copyPage(proxy, index , index + 1);
 
     //TODO: write a proper way to handle object on disk
@@ -963,19 +1160,32 @@ void UBPersistenceManager::copyDocumentScene(std::shared_ptr<UBDocumentProxy> fr
 
     checkIfDocumentRepositoryExists();
 
-    for (int i = to->pageCount(); i > toIndex; i--) {
-        renamePage(to, i - 1, i);
-        mSceneCache.moveScene(to, i - 1, i);
+    if (usesPageManifest(to))
+    {
+        to->insertPageId(toIndex);
+        writePageManifest(to);
+    }
+    else
+    {
+        for (int i = to->pageCount(); i > toIndex; i--) {
+            renamePage(to, i - 1, i);
+        }
     }
 
+    mSceneCache.shiftUpScenes(to, toIndex, to->pageCount() - 1);
+
     UBForeighnObjectsHandler hl;
     hl.copyPage(QUrl::fromLocalFile(from->persistencePath()), fromIndex,
-                QUrl::fromLocalFile(to->persistencePath()), toIndex);
+                QUrl::fromLocalFile(to->persistencePath()), toIndex,
+                from->pageFileName(fromIndex), to->pageFileName(toIndex));
 
     to->incPageCount();
 
-    QString thumbTmp(from->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", fromIndex));
-    QString thumbTo(to->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", toIndex));
+    QString thumbTmp(from->thumbnailFilePath(fromIndex));
+    QString thumbTo(to->thumbnailFilePath(toIndex));
+
+    UBThumbnailAdaptor::waitForPendingThumbnail(thumbTmp);
+    UBThumbnailAdaptor::waitForPendingThumbnail(thumbTo);
 
     QFile::remove(thumbTo);
     QFile::copy(thumbTmp, thumbTo);
@@ -992,9 +1202,17 @@ std::shared_ptr<UBGraphicsScene> UBPersistenceManager::createDocumentSceneAt(std
 {
     int count = proxy->pageCount();
 
-    for(int i = count - 1; i >= index; i--)
+    if (usesPageManifest(proxy))
+    {
+        proxy->insertPageId(index);
+        writePageManifest(proxy);
+    }
+    else
     {
-        renamePage(proxy, i , i + 1);
+        for(int i = count - 1; i >= index; i--)
+        {
+            renamePage(proxy, i , i + 1);
+        }
     }
 
     mSceneCache.shiftUpScenes(proxy, index, count -1);
@@ -1020,9 +1238,17 @@ void UBPersistenceManager::insertDocumentSceneAt(std::shared_ptr<UBDocumentProxy
 
     int count = proxy->pageCount();
 
-    for(int i = count - 1; i >= index; i--)
+    if (usesPageManifest(proxy))
+    {
+        proxy->insertPageId(index);
+        writePageManifest(proxy);
+    }
+    else
     {
-        renamePage(proxy, i , i + 1);
+        for(int i = count - 1; i >= index; i--)
+        {
+            renamePage(proxy, i , i + 1);
+        }
     }
 
     mSceneCache.shiftUpScenes(proxy, index, count -1);
@@ -1054,9 +1280,19 @@ void UBPersistenceManager::moveSceneToIndex(std::shared_ptr<UBDocumentProxy> pro
         persistDocumentScene(proxy, scene, page, false, true);
     }
 
+    if (usesPageManifest(proxy))
+    {
+        proxy->movePageId(source, target);
+        writePageManifest(proxy);
+        mSceneCache.moveScene(proxy, source, target);
+        return;
+    }
+
     QFile svgTmp(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", source));
     svgTmp.rename(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.tmp", target));
 
+    UBThumbnailAdaptor::waitForPendingThumbnail(proxy->thumbnailFilePath(source));
+
     QFile thumbTmp(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", source));
     thumbTmp.rename(proxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.tmp", target));
 
@@ -1093,17 +1329,78 @@ std::shared_ptr<UBGraphicsScene> UBPersistenceManager::loadDocumentScene(std::sh
 
     if (cacheNeighboringScenes)
     {
-        if(sceneIndex + 1 < proxy->pageCount() &&  !mSceneCache.contains(proxy, sceneIndex + 1))
-            mSceneCache.prepareLoading(proxy,sceneIndex+1);
+        prefetchNeighboringScenes(proxy, sceneIndex);
+    }
 
-        if(sceneIndex + 2 < proxy->pageCount() &&  !mSceneCache.contains(proxy, sceneIndex + 2))
-            mSceneCache.prepareLoading(proxy,sceneIndex+2);
+    return scene;
+}
 
-        if(sceneIndex - 1 >= 0 &&  !mSceneCache.contains(proxy, sceneIndex - 1))
-            mSceneCache.prepareLoading(proxy,sceneIndex-1);
+/**
+ * @brief Load the neighbors of a page in the background
+ *
+ * Stepping through the pages in one direction prefetches more pages in this direction,
+ * the faster the user navigates the deeper. A jump to another page (e.g. with the thumbnails)
+ * resets the direction and only prefetches the direct neighbors. Loads which are no longer
+ * in the prefetched range are cancelled.
+ */
+void UBPersistenceManager::prefetchNeighboringScenes(std::shared_ptr<UBDocumentProxy> proxy, int sceneIndex)
+{
+    auto lastDocument = mLastLoadedDocument.lock();
+    const bool isFastNavigation = mNavigationTimer.isValid() && mNavigationTimer.elapsed() < 1000;
+
+    if (lastDocument && lastDocument != proxy)
+    {
+        mSceneCache.cancelLoading(lastDocument, 0, -1);
     }
 
-    return scene;
+    const int step = (lastDocument == proxy) ? sceneIndex - mLastLoadedSceneIndex : 0;
+
+    if (step == 1 || step == -1)
+    {
+        mNavigationStreak = (step == mNavigationDirection) ? mNavigationStreak + 1 : 0;
+        mNavigationDirection = step;
+    }
+    else if (step != 0)
+    {
+        mNavigationStreak = 0;
+        mNavigationDirection = 0;
+    }
+
+    mLastLoadedDocument = proxy;
+    mLastLoadedSceneIndex = sceneIndex;
+    mNavigationTimer.start();
+
+    int ahead = 2;
+    int behind = 1;
+
+    if (mNavigationDirection != 0)
+    {
+        const int maxDepth = qMax(ahead, UBSettings::settings()->pagePrefetchDepth->get().toInt());
+        ahead = qMin(maxDepth, ahead + mNavigationStreak + (isFastNavigation ? 1 : 0));
+    }
+
+    const int direction = mNavigationDirection < 0 ? -1 : 1;
+    const int first = qMax(0, sceneIndex - (direction > 0 ? behind : ahead));
+    const int last = qMin(proxy->pageCount() - 1, sceneIndex + (direction > 0 ? ahead : behind));
+
+    mSceneCache.cancelLoading(proxy, first, last);
+
+    // nearest pages in the direction of travel first
+    for (int distance = 1; distance <= ahead; ++distance)
+    {
+        const int index = sceneIndex + direction * distance;
+
+        if (index >= first && index <= last && !mSceneCache.contains(proxy, index))
+            mSceneCache.prepareLoading(proxy, index);
+
+        if (distance <= behind)
+        {
+            const int opposite = sceneIndex - direction * distance;
+
+            if (opposite >= first && opposite <= last && !mSceneCache.contains(proxy, opposite))
+                mSceneCache.prepareLoading(proxy, opposite);
+        }
+    }
 }
 
 std::shared_ptr<UBGraphicsScene> UBPersistenceManager::getDocumentScene(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex)
@@ -1141,7 +1438,17 @@ void UBPersistenceManager::persistDocumentScene(std::shared_ptr<UBDocumentProxy>
        mScenesToSave.append(copiedScene);
     }
 
-    UBThumbnailAdaptor::persistScene(pDocumentProxy, pScene, pSceneIndex);
+    if (forceImmediateSaving)
+    {
+        UBThumbnailAdaptor::persistScene(pDocumentProxy, pScene, pSceneIndex);
+    }
+    else
+    {
+        UBThumbnailAdaptor::persistSceneInBackground(pDocumentProxy, pScene, pSceneIndex, [this, pDocumentProxy, pSceneIndex](){
+            emit documentThumbnailPersisted(pDocumentProxy, pSceneIndex);
+        });
+    }
+
     pScene->setModified(false);
 
     mSceneCache.insert(pDocumentProxy, pSceneIndex, pScene);
@@ -1169,24 +1476,30 @@ std::shared_ptr<UBDocumentProxy> UBPersistenceManager::persistDocumentMetadata(s
 
 void UBPersistenceManager::renamePage(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const int sourceIndex, const int targetIndex)
 {
+    UBThumbnailAdaptor::waitForPendingThumbnail(pDocumentProxy->thumbnailFilePath(sourceIndex));
+    UBThumbnailAdaptor::waitForPendingThumbnail(pDocumentProxy->thumbnailFilePath(targetIndex));
+
     UBApplication::showMessage(tr("Renaming pages (%1/%2)").arg(sourceIndex).arg(pDocumentProxy->pageCount()));
-    QFile svg(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", sourceIndex));
-    svg.rename(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",  targetIndex));
+    QFile svg(pDocumentProxy->pageFilePath(sourceIndex));
+    svg.rename(pDocumentProxy->pageFilePath(targetIndex));
 
-    QFile thumb(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", sourceIndex));
-    thumb.rename(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", targetIndex));
+    QFile thumb(pDocumentProxy->thumbnailFilePath(sourceIndex));
+    thumb.rename(pDocumentProxy->thumbnailFilePath(targetIndex));
 }
 
 
 void UBPersistenceManager::copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy, const int sourceIndex, const int targetIndex)
 {
-    QFile svg(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg",sourceIndex));
-    svg.copy(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", targetIndex));
+    UBThumbnailAdaptor::waitForPendingThumbnail(pDocumentProxy->thumbnailFilePath(sourceIndex));
+    UBThumbnailAdaptor::waitForPendingThumbnail(pDocumentProxy->thumbnailFilePath(targetIndex));
+
+    QFile svg(pDocumentProxy->pageFilePath(sourceIndex));
+    svg.copy(pDocumentProxy->pageFilePath(targetIndex));
 
     UBSvgSubsetAdaptor::setSceneUuid(pDocumentProxy, targetIndex, QUuid::createUuid());
 
-    QFile thumb(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", sourceIndex));
-    thumb.copy(pDocumentProxy->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", targetIndex));
+    QFile thumb(pDocumentProxy->thumbnailFilePath(sourceIndex));
+    thumb.copy(pDocumentProxy->thumbnailFilePath(targetIndex));
 }
 
 
@@ -1194,6 +1507,27 @@ int UBPersistenceManager::sceneCount(const std::shared_ptr<UBDocumentProxy> prox
 {
     const QString pPath = proxy->persistencePath();
 
+    QStringList pageIds;
+
+    if (readPageManifest(pPath, pageIds))
+    {
+        proxy->setPageIds(pageIds);
+
+        // a page is only listed before its file is written, drop pages which were never persisted
+        for (int i = pageIds.size() - 1; i >= 0; i--)
+        {
+            if (!QFile::exists(proxy->pageFilePath(i)))
+            {
+                qWarning() << "Page" << pageIds.at(i) << "of the manifest not found in" << pPath;
+                proxy->removePageId(i);
+            }
+        }
+
+        return proxy->pageIds().size();
+    }
+
+    proxy->clearPageIds();
+
     int pageIndex = 0;
     bool moreToProcess = true;
     bool addedMissingZeroPage = false;
@@ -1225,10 +1559,203 @@ int UBPersistenceManager::sceneCount(const std::shared_ptr<UBDocumentProxy> prox
 
 QStringList UBPersistenceManager::getSceneFileNames(const QString& folder)
 {
+    QStringList pageIds;
+
+    if (readPageManifest(folder, pageIds))
+    {
+        QStringList fileNames;
+
+        for (const QString& pageId : pageIds)
+        {
+            fileNames << "page-" + pageId + ".svg";
+        }
+
+        return fileNames;
+    }
+
     QDir dir(folder, "page???.svg", QDir::Name, QDir::Files);
     return dir.entryList();
 }
 
+bool UBPersistenceManager::readPageManifest(const QString& documentFolder, QStringList& pageIds)
+{
+    QFile file(documentFolder + "/" + fPageManifest);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    pageIds.clear();
+
+    while (!file.atEnd())
+    {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+
+        if (!line.isEmpty() && !line.startsWith('#'))
+        {
+            pageIds << line;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the page order of a document with a page manifest.
+ *
+ * The manifest is written to a temporary file which replaces the old one, so
+ * that an interrupted write never leaves a document without page order.
+ */
+bool UBPersistenceManager::writePageManifest(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
+{
+    generatePathIfNeeded(pDocumentProxy);
+    QDir().mkpath(pDocumentProxy->persistencePath());
+
+    QSaveFile file(pDocumentProxy->persistencePath() + "/" + fPageManifest);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        qWarning() << "Cannot write page manifest of" << pDocumentProxy->persistencePath();
+        return false;
+    }
+
+    QByteArray content = "# OpenBoard page order\n";
+
+    for (const QString& pageId : pDocumentProxy->pageIds())
+    {
+        content += pageId.toUtf8() + '\n';
+    }
+
+    file.write(content);
+
+    if (!file.commit())
+    {
+        qWarning() << "Cannot write page manifest of" << pDocumentProxy->persistencePath();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check whether the pages of a document are ordered by a manifest.
+ *
+ * Legacy documents are converted when the page manifest is enabled in the settings,
+ * so that the renaming happens only once instead of at every page insertion.
+ */
+bool UBPersistenceManager::usesPageManifest(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
+{
+    if (!pDocumentProxy->hasPageManifest() && UBSettings::settings()->documentUsePageManifest->get().toBool())
+    {
+        convertToPageManifest(pDocumentProxy);
+    }
+
+    return pDocumentProxy->hasPageManifest();
+}
+
+bool UBPersistenceManager::convertToPageManifest(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
+{
+    const QString path = pDocumentProxy->persistencePath();
+    const int count = pDocumentProxy->pageCount();
+    QStringList legacyFileNames;
+
+    for (int i = 0; i < count; i++)
+    {
+        legacyFileNames << pDocumentProxy->pageFileName(i);
+    }
+
+    pDocumentProxy->setPageIds(QStringList());
+
+    for (int i = 0; i < count; i++)
+    {
+        const QString legacyThumbnail = path + "/" + UBFileSystemUtils::digitFileFormat("page%1.thumbnail.jpg", i);
+        UBThumbnailAdaptor::waitForPendingThumbnail(legacyThumbnail);
+        pDocumentProxy->insertPageId(i);
+
+        if (!QFile::rename(path + "/" + legacyFileNames.at(i), pDocumentProxy->pageFilePath(i)))
+        {
+            qWarning() << "Cannot convert" << path << "to a page manifest, failed to rename" << legacyFileNames.at(i);
+
+            for (int j = 0; j <= i; j++)
+            {
+                QFile::rename(pDocumentProxy->pageFilePath(j), path + "/" + legacyFileNames.at(j));
+                QFile::rename(pDocumentProxy->thumbnailFilePath(j), path + "/" + UBFileSystemUtils::digitFileFormat("page%1.thumbnail.jpg", j));
+            }
+
+            pDocumentProxy->clearPageIds();
+            return false;
+        }
+
+        // a missing thumbnail is generated again
+        QFile::rename(legacyThumbnail, pDocumentProxy->thumbnailFilePath(i));
+    }
+
+    return writePageManifest(pDocumentProxy);
+}
+
+/**
+ * @brief Archive file names of the page files of a document with a page manifest.
+ *
+ * Maps the file names in the document folder to the legacy pageNNN names, the manifest
+ * itself is mapped to an empty name. Empty if the document has the legacy layout.
+ */
+QMap<QString, QString> UBPersistenceManager::legacyPageFileNames(std::shared_ptr<UBDocumentProxy> pDocumentProxy)
+{
+    QMap<QString, QString> fileNames;
+
+    if (!pDocumentProxy->hasPageManifest())
+    {
+        return fileNames;
+    }
+
+    for (int i = 0; i < pDocumentProxy->pageCount(); i++)
+    {
+        fileNames.insert(pDocumentProxy->pageFileName(i), UBFileSystemUtils::digitFileFormat("page%1.svg", i));
+        fileNames.insert(pDocumentProxy->thumbnailFileName(i), UBFileSystemUtils::digitFileFormat("page%1.thumbnail.jpg", i));
+    }
+
+    fileNames.insert(fPageManifest, QString());
+
+    return fileNames;
+}
+
+/**
+ * @brief Rename the pages of a copied document folder to the legacy layout and remove its manifest.
+ */
+bool UBPersistenceManager::convertToLegacyLayout(const QString& documentFolder)
+{
+    QStringList pageIds;
+
+    if (!readPageManifest(documentFolder, pageIds))
+    {
+        return true;
+    }
+
+    int pageIndex = 0;
+
+    for (const QString& pageId : pageIds)
+    {
+        const QString page = documentFolder + "/page-" + pageId;
+
+        if (!QFile::exists(page + ".svg"))
+        {
+            continue;
+        }
+
+        if (!QFile::rename(page + ".svg", documentFolder + UBFileSystemUtils::digitFileFormat("/page%1.svg", pageIndex)))
+        {
+            qWarning() << "Cannot convert" << documentFolder << "to the legacy layout";
+            return false;
+        }
+
+        QFile::rename(page + ".thumbnail.jpg", documentFolder + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", pageIndex));
+        pageIndex++;
+    }
+
+    return QFile::remove(documentFolder + "/" + fPageManifest);
+}
+
 QString UBPersistenceManager::generateUniqueDocumentPath(const QString& baseFolder)
 {
     QDateTime now = QDateTime::currentDateTime();
@@ -1259,20 +1786,34 @@ bool UBPersistenceManager::addDirectoryContentToDocument(const QString& document
         return false;
 
     int targetPageCount = pDocument->pageCount();
+    const bool hasPageManifest = usesPageManifest(pDocument);
 
     for(int sourceIndex = 0 ; sourceIndex < sourceScenes.size(); sourceIndex++)
     {
         int targetIndex = targetPageCount + sourceIndex;
 
+        if (hasPageManifest)
+        {
+            pDocument->insertPageId(targetIndex);
+        }
+
         QFile svg(documentRootFolder + "/" + sourceScenes[sourceIndex]);
-        if (!svg.copy(pDocument->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", targetIndex)))
+        if (!svg.copy(pDocument->pageFilePath(targetIndex)))
             return false;
 
         UBSvgSubsetAdaptor::setSceneUuid(pDocument, targetIndex, QUuid::createUuid());
 
-        QFile thumb(documentRootFolder + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", sourceIndex));
+        QString thumbnailName = sourceScenes[sourceIndex];
+        thumbnailName.replace(QRegularExpression("\\.svg$"), ".thumbnail.jpg");
+
+        QFile thumb(documentRootFolder + "/" + thumbnailName);
         // We can ignore error in this case, thumbnail will be genarated
-        thumb.copy(pDocument->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.thumbnail.jpg", targetIndex));
+        thumb.copy(pDocument->thumbnailFilePath(targetIndex));
+    }
+
+    if (hasPageManifest)
+    {
+        writePageManifest(pDocument);
     }
 
     foreach(QString dir, mDocumentSubDirectories)
@@ -1285,7 +1826,7 @@ bool UBPersistenceManager::addDirectoryContentToDocument(const QString& document
                 return false;
     }
 
-    pDocument->setPageCount(pDocument->pageCount());
+    pDocument->setPageCount(sceneCount(pDocument));
 
     //issue NC - NNE - 20131213 : At this point, all is well done.
     return true;
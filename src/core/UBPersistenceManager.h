@@ -31,6 +31,7 @@
 
 #include <QtCore>
 
+#include "UBDocumentIndex.h"
 #include "UBSceneCache.h"
 #include "UBPersistenceWorker.h"
 
@@ -65,6 +66,8 @@ class UBPersistenceManager : public QObject
         static const QString modelsName;
         static const QString untitledDocumentsName;
         static const QString fFolders;
+        static const QString fDocumentIndex;
+        static const QString fPageManifest;
         static const QString tFolder;
         static const QString aName;
 
@@ -131,6 +134,9 @@ class UBPersistenceManager : public QObject
 
         bool addDirectoryContentToDocument(const QString& documentRootFolder, std::shared_ptr<UBDocumentProxy> pDocument);
 
+        static QMap<QString, QString> legacyPageFileNames(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
+        static bool convertToLegacyLayout(const QString& documentFolder);
+
         void createDocumentProxiesStructure(bool interactive = false);
         void createDocumentProxiesStructure(const QFileInfoList &contentInfoList, bool interactive = false);
         static std::shared_ptr<UBDocumentProxy> createDocumentProxyStructure(const QFileInfo &contentInfo);
@@ -160,6 +166,7 @@ class UBPersistenceManager : public QObject
     signals:
         void documentCreated(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         void documentMetadataChanged(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
+        void documentThumbnailPersisted(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int pIndex);
 
         // The following signals are emitted in UBDocument
         void documentSceneDuplicated(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int pIndex);
@@ -167,12 +174,19 @@ class UBPersistenceManager : public QObject
         void documentSceneDeleted(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int pIndex);
 
 private:
+        void loadIndexedDocuments(const QFileInfoList& contentInfoList);
+        void addDocumentToTree(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         static int sceneCount(const std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         static QStringList getSceneFileNames(const QString& folder);
         void renamePage(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
                         const int sourceIndex, const int targetIndex);
         void copyPage(std::shared_ptr<UBDocumentProxy> pDocumentProxy,
                       const int sourceIndex, const int targetIndex);
+        void transferPages(std::shared_ptr<UBDocumentProxy> from, const QList<int>& indexes, std::shared_ptr<UBDocumentProxy> to);
+        static bool readPageManifest(const QString& documentFolder, QStringList& pageIds);
+        bool writePageManifest(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
+        bool usesPageManifest(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
+        bool convertToPageManifest(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         void generatePathIfNeeded(std::shared_ptr<UBDocumentProxy> pDocumentProxy);
         void checkIfDocumentRepositoryExists();
 
@@ -181,6 +195,8 @@ private:
 
         void cleanupDocument(std::shared_ptr<UBDocumentProxy> pDocumentProxy) const;
 
+        void prefetchNeighboringScenes(std::shared_ptr<UBDocumentProxy> pDocumentProxy, int sceneIndex);
+
         QString xmlFolderStructureFilename;
 
         UBSceneCache mSceneCache;
@@ -191,6 +207,8 @@ private:
         QString mFoldersXmlStorageName;
         QProgressDialog mProgress;
         QFutureWatcher<void> futureWatcher;
+        UBDocumentIndex* mDocumentIndex;
+        QFutureWatcher<UBDocumentIndex::Entry>* mDocumentIndexWatcher;
         UBPersistenceWorker* mWorker;
         QList<std::shared_ptr<UBGraphicsScene>> mScenesToSave;
 
@@ -202,6 +220,13 @@ private:
         bool mReplaceDialogReturnedReplaceAll;
         bool mReplaceDialogReturnedCancel;
 
+        // navigation history, used to prefetch the pages in the direction of travel
+        std::weak_ptr<UBDocumentProxy> mLastLoadedDocument;
+        int mLastLoadedSceneIndex;
+        int mNavigationDirection;
+        int mNavigationStreak;
+        QElapsedTimer mNavigationTimer;
+
     private slots:
         void documentRepositoryChanged(const QString& path);
         void errorString(QString error);
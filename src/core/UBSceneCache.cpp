@@ -28,7 +28,14 @@
 
 #include "UBSceneCache.h"
 
+#include <QtConcurrent>
+
+#include <algorithm>
+
 #include "domain/UBGraphicsScene.h"
+#include "domain/UBGraphicsPixmapItem.h"
+#include "domain/UBGraphicsPolygonItem.h"
+#include "domain/UBGraphicsSvgItem.h"
 
 #include <adaptors/UBSvgSubsetAdaptor.h>
 
@@ -40,6 +47,52 @@
 
 #include "core/memcheck.h"
 
+/**
+ * @brief Rough estimation of the memory used by the items of a scene
+ *
+ * Only images, rendered PDF pages and strokes are taken into account, all other
+ * items are counted with a fixed overhead.
+ */
+static qint64 estimateSceneSize(UBGraphicsScene* scene)
+{
+    qint64 size = 0;
+
+    for (QGraphicsItem* item : scene->items())
+    {
+        switch (item->type())
+        {
+        case UBGraphicsItemType::PixmapItemType:
+        {
+            const QPixmap pixmap = qgraphicsitem_cast<UBGraphicsPixmapItem*>(item)->pixmap();
+            size += qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+            break;
+        }
+
+        case UBGraphicsItemType::SvgItemType:
+            size += qgraphicsitem_cast<UBGraphicsSvgItem*>(item)->fileData().size();
+            break;
+
+        case UBGraphicsItemType::PolygonItemType:
+            size += qgraphicsitem_cast<UBGraphicsPolygonItem*>(item)->polygon().size() * qint64(sizeof(QPointF));
+            break;
+
+        case UBGraphicsItemType::PDFItemType:
+        {
+            const QRectF rect = item->sceneBoundingRect();
+            size += qint64(rect.width() * rect.height() * 4);
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        size += 1024;
+    }
+
+    return size;
+}
+
 UBSceneCache::UBSceneCache()
 {
     // NOOP
@@ -89,8 +142,7 @@ void UBSceneCache::insert (std::shared_ptr<UBDocumentProxy> proxy, int pageIndex
 
         if (entry->isSceneAvailable() && entry->scene() == scene)
         {
-            mSceneCache.remove(key);
-            mCachedKeyFIFO.removeAll(key);
+            takeEntry(key);
         }
     }
 
@@ -119,8 +171,7 @@ std::shared_ptr<UBGraphicsScene> UBSceneCache::value(std::shared_ptr<UBDocumentP
     {
         auto entry = mSceneCache.value(key);
 
-        mCachedKeyFIFO.removeAll(key);
-        mCachedKeyFIFO.enqueue(key);
+        touch(entry);
 
         return entry->scene();
     }
@@ -144,8 +195,7 @@ void UBSceneCache::removeScene(std::shared_ptr<UBDocumentProxy> proxy, int pageI
 
     if (!entry->isSceneAvailable() || !entry->scene()->isActive())
     {
-        int count = mSceneCache.remove(key);
-        mCachedKeyFIFO.removeAll(key);
+        takeEntry(key);
 
         if (entry->isSceneAvailable())
         {
@@ -161,50 +211,69 @@ void UBSceneCache::removeAllScenes(std::shared_ptr<UBDocumentProxy> proxy)
     {
         removeScene(proxy, i);
     }
+
+    // pages still loading are never active, none is left
+    mLoadingPages.remove(proxy.get());
 }
 
 
-void UBSceneCache::moveScene(std::shared_ptr<UBDocumentProxy> proxy, int sourceIndex, int targetIndex)
+void UBSceneCache::cancelLoading(std::shared_ptr<UBDocumentProxy> proxy, int firstKeptIndex, int lastKeptIndex)
 {
-    UBSceneCacheID keySource(proxy, sourceIndex);
-
-    std::shared_ptr<SceneCacheEntry> entry;
-    bool hasEntry = mSceneCache.contains(keySource);
+    // drop the pages of the document which are still loading outside of the given range
+    auto loading = mLoadingPages.find(proxy.get());
 
-    if (hasEntry)
+    if (loading == mLoadingPages.end())
     {
-        entry = mSceneCache.value(keySource);
-        mCachedKeyFIFO.removeAll(keySource);
+        return;
     }
 
-    if (sourceIndex < targetIndex)
+    for (auto it = loading->begin(); it != loading->end();)
     {
-        for (int i = sourceIndex + 1; i <= targetIndex; i++)
+        const UBSceneCacheID key{proxy, *it};
+        const auto entry = mSceneCache.value(key);
+
+        if (!entry || entry->isSceneAvailable())
         {
-            internalMoveScene(proxy, i, i - 1);
+            // removed or loaded since
+            it = loading->erase(it);
         }
-    }
-    else
-    {
-        for (int i = sourceIndex - 1; i >= targetIndex; i--)
+        else if (key.pageIndex < firstKeptIndex || key.pageIndex > lastKeptIndex)
         {
-            internalMoveScene(proxy, i, i + 1);
+            qDebug() << "cancel loading page" << key.pageIndex;
+            takeEntry(key);
+            it = loading->erase(it);
+        }
+        else
+        {
+            ++it;
         }
     }
 
-    UBSceneCacheID keyTarget(proxy, targetIndex);
-
-    if (hasEntry)
+    if (loading->isEmpty())
     {
-        insertEntry(keyTarget, entry);
-        mCachedKeyFIFO.enqueue(keyTarget);
-    }
-    else if (mSceneCache.contains(keyTarget))
-    {
-        entry = mSceneCache.take(keyTarget);
-        mCachedKeyFIFO.removeAll(keyTarget);
+        mLoadingPages.erase(loading);
     }
+}
+
+
+void UBSceneCache::moveScene(std::shared_ptr<UBDocumentProxy> proxy, int sourceIndex, int targetIndex)
+{
+    reindexScenes(proxy, [sourceIndex, targetIndex](int index) {
+        if (index == sourceIndex)
+        {
+            return targetIndex;
+        }
+        else if (sourceIndex < targetIndex && index > sourceIndex && index <= targetIndex)
+        {
+            return index - 1;
+        }
+        else if (sourceIndex > targetIndex && index >= targetIndex && index < sourceIndex)
+        {
+            return index + 1;
+        }
 
+        return index;
+    });
 }
 
 void UBSceneCache::reassignDocProxy(std::shared_ptr<UBDocumentProxy> newDocument, std::shared_ptr<UBDocumentProxy> oldDocument)
@@ -221,16 +290,18 @@ void UBSceneCache::reassignDocProxy(std::shared_ptr<UBDocumentProxy> newDocument
     for (int i = 0; i < oldDocument->pageCount(); i++) {
 
         UBSceneCacheID sourceKey(oldDocument, i);
-        auto entry = mSceneCache.value(sourceKey);
+        auto entry = takeEntry(sourceKey);
+
+        if (!entry)
+        {
+            continue;
+        }
 
         if (entry->isSceneAvailable())
         {
             entry->scene()->setDocument(newDocument);
         }
 
-        mCachedKeyFIFO.removeAll(sourceKey);
-        int count = mSceneCache.remove(sourceKey);
-
         insertEntry({newDocument, i}, entry);
     }
 }
@@ -238,71 +309,178 @@ void UBSceneCache::reassignDocProxy(std::shared_ptr<UBDocumentProxy> newDocument
 
 void UBSceneCache::shiftUpScenes(std::shared_ptr<UBDocumentProxy> proxy, int startIncIndex, int endIncIndex)
 {
-    for(int i = endIncIndex; i >= startIncIndex; i--)
+    reindexScenes(proxy, [startIncIndex, endIncIndex](int index) {
+        return (index >= startIncIndex && index <= endIncIndex) ? index + 1 : index;
+    });
+}
+
+
+/**
+ * @brief Remove the scenes of deleted pages and shift the scenes of the following pages down.
+ */
+void UBSceneCache::removeScenes(std::shared_ptr<UBDocumentProxy> proxy, const QList<int>& pageIndexes)
+{
+    for (int pageIndex : pageIndexes)
     {
-        UBApplication::showMessage(QObject::tr("Moving cached scenes (%1/%2)").arg(i).arg(endIncIndex));
-        internalMoveScene(proxy, i, i + 1);
+        removeScene(proxy, pageIndex);
     }
+
+    reindexScenes(proxy, [&pageIndexes](int index) {
+        if (pageIndexes.contains(index))
+        {
+            return -1;
+        }
+
+        const int removedBefore = std::count_if(pageIndexes.cbegin(), pageIndexes.cend(), [index](int removed) {
+            return removed < index;
+        });
+
+        return index - removedBefore;
+    });
 }
 
 
-void UBSceneCache::internalMoveScene(std::shared_ptr<UBDocumentProxy> proxy, int sourceIndex, int targetIndex)
+/**
+ * @brief Change the page index of all cached scenes of a document in a single pass.
+ *
+ * The cost only depends on the number of cached scenes, not on the number of pages.
+ * Scenes mapped to a negative index are dropped, as well as scenes whose index is
+ * taken by a moved scene.
+ */
+void UBSceneCache::reindexScenes(std::shared_ptr<UBDocumentProxy> proxy, const std::function<int(int)>& newIndex)
 {
-    UBSceneCacheID sourceKey(proxy, sourceIndex);
+    QList<QPair<UBSceneCacheID, std::shared_ptr<SceneCacheEntry>>> movedEntries;
 
-    if (mSceneCache.contains(sourceKey))
+    for (auto it = mSceneCache.begin(); it != mSceneCache.end();)
     {
-        auto scene = mSceneCache.take(sourceKey);
-        mCachedKeyFIFO.removeAll(sourceKey);
+        const int pageIndex = it.key().pageIndex;
+        const int targetIndex = it.key().documentProxy == proxy ? newIndex(pageIndex) : pageIndex;
 
-        UBSceneCacheID targetKey(proxy, targetIndex);
-        mSceneCache.insert(targetKey, scene);
-        mCachedKeyFIFO.enqueue(targetKey);
+        if (targetIndex == pageIndex)
+        {
+            ++it;
+            continue;
+        }
+
+        auto entry = it.value();
+        it = mSceneCache.erase(it);
 
+        if (targetIndex < 0)
+        {
+            mLru.erase(entry->lruPosition);
+            mTotalSize -= entry->estimatedSize();
+        }
+        else
+        {
+            movedEntries.append({UBSceneCacheID(proxy, targetIndex), entry});
+        }
     }
-    else
+
+    for (const auto& moved : std::as_const(movedEntries))
     {
-        UBSceneCacheID targetKey(proxy, targetIndex);
-        if (mSceneCache.contains(targetKey))
-        {
-            mSceneCache.take(targetKey);
+        takeEntry(moved.first);
 
-            mCachedKeyFIFO.removeAll(targetKey);
+        // keep the position in the LRU list, only the key changes
+        *moved.second->lruPosition = moved.first;
+        mSceneCache.insert(moved.first, moved.second);
+
+        if (!moved.second->isSceneAvailable())
+        {
+            mLoadingPages[proxy.get()].insert(moved.first.pageIndex);
         }
     }
 }
 
 void UBSceneCache::insertEntry(UBSceneCacheID key, std::shared_ptr<SceneCacheEntry> entry)
 {
+    takeEntry(key);
+
     mSceneCache.insert(key, entry);
-    mCachedKeyFIFO.removeAll(key);
-    mCachedKeyFIFO.enqueue(key);
+    mLru.push_front(key);
+    entry->lruPosition = mLru.begin();
 
-    // remove LRU entries if cache size grows beyond limit
-    auto entries = mCachedKeyFIFO.size();
+    if (!entry->isSceneAvailable())
+    {
+        mLoadingPages[key.documentProxy.get()].insert(key.pageIndex);
+    }
 
-    while (entries-- > UBSettings::settings()->pageCacheSize->get().toInt())
+    entry->updateEstimatedSize();
+    mTotalSize += entry->estimatedSize();
+
+    evict(key);
+}
+
+std::shared_ptr<UBSceneCache::SceneCacheEntry> UBSceneCache::takeEntry(const UBSceneCacheID& key)
+{
+    auto entry = mSceneCache.take(key);
+
+    if (entry)
+    {
+        mLru.erase(entry->lruPosition);
+        mTotalSize -= entry->estimatedSize();
+    }
+
+    return entry;
+}
+
+void UBSceneCache::touch(std::shared_ptr<SceneCacheEntry> entry)
+{
+    mLru.splice(mLru.begin(), mLru, entry->lruPosition);
+
+    // a scene is estimated again when it is used after being loaded or modified
+    const qint64 previousSize = entry->estimatedSize();
+
+    if (entry->updateEstimatedSize())
     {
-        qDebug() << "cache full, size" << entries;
-        const auto key = mCachedKeyFIFO.dequeue();
+        mTotalSize += entry->estimatedSize() - previousSize;
+    }
+}
+
+void UBSceneCache::evict(const UBSceneCacheID& keptKey)
+{
+    const qint64 budget = UBSettings::settings()->pageCacheMemoryLimit->get().toLongLong() * 1024 * 1024;
+
+    // remove least recently used entries if still loading or inactive until the cache fits into the budget.
+    // The kept entry and active scenes are moved to the front instead, so that each entry is seen once
+    for (int remaining = int(mLru.size()); mTotalSize > budget && remaining > 0; --remaining)
+    {
+        const UBSceneCacheID key = mLru.back();
         auto entry = mSceneCache.value(key);
 
-        // remove if still loading or inactive
-        if ((entry->isSceneAvailable() && !entry->scene()->isActive())
-                || !entry->isSceneAvailable())
+        if (key == keptKey || (entry->isSceneAvailable() && entry->scene()->isActive()))
         {
-            qDebug() << "removing page" << key.pageIndex << "of" << key.documentProxy->documentFolderName();
-            removeScene(key.documentProxy, key.pageIndex);
-            entry = nullptr;
-            qDebug() << "removed page" << key.pageIndex << "of" << key.documentProxy->documentFolderName();
-            break;
+            touch(entry);
+            continue;
         }
+
+        qDebug() << "cache full, removing page" << key.pageIndex << "of" << key.documentProxy->documentFolderName();
+        removeScene(key.documentProxy, key.pageIndex);
     }
 }
 
 UBSceneCache::SceneCacheEntry::SceneCacheEntry(std::shared_ptr<UBDocumentProxy> proxy, int pageIndex)
+    : mProxy(proxy)
 {
-    mContext = UBSvgSubsetAdaptor::prepareLoadingScene(proxy, pageIndex);
+    // read the page file now, as it is renamed when pages are inserted, moved or deleted before the
+    // entry is loaded. Only the tokenizing runs on the thread pool, the attributes are parsed and the
+    // items created on the GUI thread
+    const QString fileName = UBSvgSubsetAdaptor::sceneFileName(proxy, pageIndex);
+    QFile file(fileName);
+    QByteArray xmlData;
+
+    if (file.open(QIODevice::ReadOnly))
+    {
+        xmlData = file.readAll();
+    }
+    else
+    {
+        qWarning() << "Cannot open file " << fileName << " for reading ...";
+    }
+
+    mDescription = QtConcurrent::run(&UBSvgPageDescription::fromData, xmlData);
+
+    // until the scene is available, assume that its items take a few times the size of the file
+    mEstimatedSize = xmlData.size() * 4;
 }
 
 UBSceneCache::SceneCacheEntry::SceneCacheEntry(std::shared_ptr<UBGraphicsScene> scene)
@@ -312,6 +490,11 @@ UBSceneCache::SceneCacheEntry::SceneCacheEntry(std::shared_ptr<UBGraphicsScene>
 
 UBSceneCache::SceneCacheEntry::~SceneCacheEntry()
 {
+    if (mDescriptionWatcher)
+    {
+        delete mDescriptionWatcher;
+    }
+
     if (mTimer)
     {
         delete mTimer;
@@ -326,6 +509,7 @@ void UBSceneCache::SceneCacheEntry::startLoading()
         {
             mTimer->stop();
             delete mTimer;
+            mTimer = nullptr;
             return;
         }
 
@@ -337,6 +521,7 @@ void UBSceneCache::SceneCacheEntry::startLoading()
             {
                 mScene = mContext->scene();
                 mContext = nullptr;
+                mProxy = nullptr;
                 mTimer->stop();
                 delete mTimer;
                 mTimer = nullptr;
@@ -344,7 +529,21 @@ void UBSceneCache::SceneCacheEntry::startLoading()
         }
     });
 
-    mTimer->start();
+    // start creating the items as soon as the description is available
+    mDescriptionWatcher = new QFutureWatcher<std::shared_ptr<const UBSvgPageDescription>>;
+    QObject::connect(mDescriptionWatcher, &QFutureWatcherBase::finished, mDescriptionWatcher, [this](){
+        if (!mContext && mProxy && !UBApplication::isClosing)
+        {
+            createContext();
+
+            if (mTimer)
+            {
+                mTimer->start();
+            }
+        }
+    });
+
+    mDescriptionWatcher->setFuture(mDescription);
 }
 
 bool UBSceneCache::SceneCacheEntry::isSceneAvailable() const
@@ -354,7 +553,7 @@ bool UBSceneCache::SceneCacheEntry::isSceneAvailable() const
 
 std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::scene()
 {
-    if (mContext && !mScene)
+    if (!mScene && mProxy)
     {
         // finish loading
         if (mTimer)
@@ -364,6 +563,12 @@ std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::scene()
             mTimer = nullptr;
         }
 
+        if (!mContext)
+        {
+            // waits for the description if it is still being parsed
+            createContext();
+        }
+
         while (!mContext->isFinished())
         {
             mContext->step();
@@ -371,7 +576,37 @@ std::shared_ptr<UBGraphicsScene> UBSceneCache::SceneCacheEntry::scene()
 
         mScene = mContext->scene();
         mContext = nullptr;
+        mProxy = nullptr;
     }
 
     return mScene;
 }
+
+qint64 UBSceneCache::SceneCacheEntry::estimatedSize() const
+{
+    return mEstimatedSize;
+}
+
+/**
+ * @brief Estimate the size of the scene again if it was loaded or modified since the last estimation.
+ * @return true if the estimated size changed.
+ */
+bool UBSceneCache::SceneCacheEntry::updateEstimatedSize()
+{
+    if (!mScene || mEstimatedModification == qint64(mScene->modificationCount()))
+    {
+        return false;
+    }
+
+    const qint64 previousSize = mEstimatedSize;
+    mEstimatedSize = estimateSceneSize(mScene.get());
+    mEstimatedModification = mScene->modificationCount();
+
+    return mEstimatedSize != previousSize;
+}
+
+void UBSceneCache::SceneCacheEntry::createContext()
+{
+    mContext = std::make_shared<UBSvgSubsetAdaptor::UBSvgReaderContext>(mProxy, mDescription.result());
+    mDescription = QFuture<std::shared_ptr<const UBSvgPageDescription>>();
+}
@@ -31,7 +31,11 @@
 #define UBSCENECACHE_H
 
 #include <QtCore>
+#include <QFuture>
+#include <QFutureWatcher>
 
+#include <functional>
+#include <list>
 #include <variant>
 
 #include "adaptors/UBSvgSubsetAdaptor.h"
@@ -68,9 +72,11 @@ inline bool operator==(const UBSceneCacheID &id1, const UBSceneCacheID &id2)
         && id1.pageIndex == id2.pageIndex;
 }
 
-inline uint qHash(const UBSceneCacheID &id)
+inline uint qHash(const UBSceneCacheID &id, uint seed = 0)
 {
-    return qHash(id.pageIndex);
+    // combine document and page, so that the same page of several documents does not collide
+    uint hash = qHash(id.documentProxy.get(), seed);
+    return hash ^ (qHash(id.pageIndex, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
 }
 
 
@@ -94,12 +100,16 @@ public:
 
     void removeAllScenes(std::shared_ptr<UBDocumentProxy> proxy);
 
+    void cancelLoading(std::shared_ptr<UBDocumentProxy> proxy, int firstKeptIndex, int lastKeptIndex);
+
     void moveScene(std::shared_ptr<UBDocumentProxy> proxy, int sourceIndex, int targetIndex);
 
     void reassignDocProxy(std::shared_ptr<UBDocumentProxy> newDocument, std::shared_ptr<UBDocumentProxy> oldDocument);
 
     void shiftUpScenes(std::shared_ptr<UBDocumentProxy> proxy, int startIncIndex, int endIncIndex);
 
+    void removeScenes(std::shared_ptr<UBDocumentProxy> proxy, const QList<int>& pageIndexes);
+
 
 private:
     class SceneCacheEntry
@@ -112,24 +122,51 @@ private:
         bool isSceneAvailable() const;
         std::shared_ptr<UBGraphicsScene> scene();
 
+        qint64 estimatedSize() const;
+        bool updateEstimatedSize();
+
+        std::list<UBSceneCacheID>::iterator lruPosition;
+
     private:
+        void createContext();
+
+        std::shared_ptr<UBDocumentProxy> mProxy = nullptr;
+        QFuture<std::shared_ptr<const UBSvgPageDescription>> mDescription;
+        QFutureWatcher<std::shared_ptr<const UBSvgPageDescription>>* mDescriptionWatcher = nullptr;
         std::shared_ptr<UBSvgSubsetAdaptor::UBSvgReaderContext> mContext = nullptr;
         std::shared_ptr<UBGraphicsScene> mScene = nullptr;
         QTimer* mTimer = nullptr;
+        qint64 mEstimatedSize = 0;
+
+        // modification count of the scene when its size was estimated, -1 if not yet estimated
+        qint64 mEstimatedModification = -1;
     };
 
 //    typedef QFuture<std::shared_ptr<UBGraphicsScene>> FutureScene;
 //    typedef std::variant<std::shared_ptr<UBGraphicsScene>, FutureScene> CacheEntry;
 
-    void internalMoveScene(std::shared_ptr<UBDocumentProxy> proxy, int sourceIndex, int targetIndex);
+    void reindexScenes(std::shared_ptr<UBDocumentProxy> proxy, const std::function<int(int)>& newIndex);
 
     void insertEntry(UBSceneCacheID key, std::shared_ptr<SceneCacheEntry> entry);
 
+    std::shared_ptr<SceneCacheEntry> takeEntry(const UBSceneCacheID& key);
+
+    void touch(std::shared_ptr<SceneCacheEntry> entry);
+
+    void evict(const UBSceneCacheID& keptKey);
+
     QHash<UBSceneCacheID, std::shared_ptr<SceneCacheEntry>> mSceneCache;
 
-    QQueue<UBSceneCacheID> mCachedKeyFIFO;
+    // keys ordered from the most to the least recently used, each entry knows its position
+    std::list<UBSceneCacheID> mLru;
 
     QHash<UBSceneCacheID, UBGraphicsScene::SceneViewState> mViewStates;
+
+    // sum of the estimated sizes of all entries
+    qint64 mTotalSize = 0;
+
+    // pages of each document which were still loading when last seen, checked again when loading is cancelled
+    QHash<const UBDocumentProxy*, QSet<int>> mLoadingPages;
 };
 
 
@@ -32,6 +32,9 @@
 
 #include <QtGui>
 
+#include <atomic>
+#include <type_traits>
+
 class UBSettings;
 
 class UBSetting : public QObject
@@ -89,6 +92,43 @@ class UBSetting : public QObject
 };
 
 
+/**
+ * A setting of an arithmetic type whose value is cached when it is set.
+ *
+ * value() neither looks up the settings hash nor converts a QVariant, so it is
+ * meant for code running for each input event. It may be called from any thread.
+ */
+template <typename T>
+class UBTypedSetting : public UBSetting
+{
+    static_assert(std::is_arithmetic<T>::value, "UBTypedSetting caches arithmetic values only");
+
+    public:
+        UBTypedSetting(UBSettings* owner, const QString& pDomain, const QString& pKey,
+                        const T& pDefaultValue)
+            : UBSetting(owner, pDomain, pKey, QVariant::fromValue(pDefaultValue))
+            , mValue(UBSetting::get().template value<T>())
+        {
+            // NOOP
+        }
+
+        virtual void set(const QVariant& pValue) override
+        {
+            // update the cache before changed() is emitted
+            mValue = pValue.value<T>();
+            UBSetting::set(pValue);
+        }
+
+        T value() const
+        {
+            return mValue.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<T> mValue;
+};
+
+
 class UBColorListSetting : public UBSetting
 {
     Q_OBJECT
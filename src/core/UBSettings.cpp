@@ -273,26 +273,26 @@ void UBSettings::init()
 
     featureSliderPosition = new UBSetting(this, "Board", "FeatureSliderPosition", 40);
 
-    boardPenFineWidth = new UBSetting(this, "Board", "PenFineWidth", 1.5);
-    boardPenMediumWidth = new UBSetting(this, "Board", "PenMediumWidth", 3.0);
-    boardPenStrongWidth = new UBSetting(this, "Board", "PenStrongWidth", 8.0);
+    boardPenFineWidth = new UBTypedSetting<qreal>(this, "Board", "PenFineWidth", 1.5);
+    boardPenMediumWidth = new UBTypedSetting<qreal>(this, "Board", "PenMediumWidth", 3.0);
+    boardPenStrongWidth = new UBTypedSetting<qreal>(this, "Board", "PenStrongWidth", 8.0);
 
-    boardMarkerFineWidth = new UBSetting(this, "Board", "MarkerFineWidth", 12.0);
-    boardMarkerMediumWidth = new UBSetting(this, "Board", "MarkerMediumWidth", 24.0);
-    boardMarkerStrongWidth = new UBSetting(this, "Board", "MarkerStrongWidth", 48.0);
+    boardMarkerFineWidth = new UBTypedSetting<qreal>(this, "Board", "MarkerFineWidth", 12.0);
+    boardMarkerMediumWidth = new UBTypedSetting<qreal>(this, "Board", "MarkerMediumWidth", 24.0);
+    boardMarkerStrongWidth = new UBTypedSetting<qreal>(this, "Board", "MarkerStrongWidth", 48.0);
 
-    boardPenPressureSensitive = new UBSetting(this, "Board", "PenPressureSensitive", true);
-    boardMarkerPressureSensitive = new UBSetting(this, "Board", "MarkerPressureSensitive", false);
+    boardPenPressureSensitive = new UBTypedSetting<bool>(this, "Board", "PenPressureSensitive", true);
+    boardMarkerPressureSensitive = new UBTypedSetting<bool>(this, "Board", "MarkerPressureSensitive", false);
 
-    boardUseHighResTabletEvent = new UBSetting(this, "Board", "UseHighResTabletEvent", true);
+    boardUseHighResTabletEvent = new UBTypedSetting<bool>(this, "Board", "UseHighResTabletEvent", true);
 
-    boardInterpolatePenStrokes = new UBSetting(this, "Board", "InterpolatePenStrokes", true);
-    boardSimplifyPenStrokes = new UBSetting(this, "Board", "SimplifyPenStrokes", true);
-    boardSimplifyPenStrokesThresholdAngle = new UBSetting(this, "Board", "SimplifyPenStrokesThresholdAngle", 2);
-    boardSimplifyPenStrokesThresholdWidthDifference = new UBSetting(this, "Board", "SimplifyPenStrokesThresholdWidthDifference", 2.0);
+    boardInterpolatePenStrokes = new UBTypedSetting<bool>(this, "Board", "InterpolatePenStrokes", true);
+    boardSimplifyPenStrokes = new UBTypedSetting<bool>(this, "Board", "SimplifyPenStrokes", true);
+    boardSimplifyPenStrokesThresholdAngle = new UBTypedSetting<qreal>(this, "Board", "SimplifyPenStrokesThresholdAngle", 2.0);
+    boardSimplifyPenStrokesThresholdWidthDifference = new UBTypedSetting<qreal>(this, "Board", "SimplifyPenStrokesThresholdWidthDifference", 2.0);
 
-    boardInterpolateMarkerStrokes = new UBSetting(this, "Board", "InterpolateMarkerStrokes", true);
-    boardSimplifyMarkerStrokes = new UBSetting(this, "Board", "SimplifyMarkerStrokes", true);
+    boardInterpolateMarkerStrokes = new UBTypedSetting<bool>(this, "Board", "InterpolateMarkerStrokes", true);
+    boardSimplifyMarkerStrokes = new UBTypedSetting<bool>(this, "Board", "SimplifyMarkerStrokes", true);
 
     boardKeyboardPaletteKeyBtnSize = new UBSetting(this, "Board", "KeyboardPaletteKeyBtnSize", "16x16");
     ValidateKeyboardPaletteKeyBtnSize();
@@ -348,10 +348,10 @@ void UBSettings::init()
     boardMarkerLightBackgroundSelectedColors = new UBColorListSetting(this, "Board", "MarkerLightBackgroundSelectedColors", markerLightBackgroundSelectedColors, boardMarkerAlpha->get().toDouble());
     boardMarkerDarkBackgroundSelectedColors = new UBColorListSetting(this, "Board", "MarkerDarkBackgroundSelectedColors", markerDarkBackgroundSelectedColors, boardMarkerAlpha->get().toDouble());
 
-    showEraserPreviewCircle = new UBSetting(this, "Board", "ShowEraserPreviewCircle", true);
-    showMarkerPreviewCircle = new UBSetting(this, "Board", "ShowMarkerPreviewCircle", true);
-    showPenPreviewCircle = new UBSetting(this, "Board", "ShowPenPreviewCircle", true);
-    penPreviewFromSize = new UBSetting(this, "Board", "PenPreviewFromSize", 5);
+    showEraserPreviewCircle = new UBTypedSetting<bool>(this, "Board", "ShowEraserPreviewCircle", true);
+    showMarkerPreviewCircle = new UBTypedSetting<bool>(this, "Board", "ShowMarkerPreviewCircle", true);
+    showPenPreviewCircle = new UBTypedSetting<bool>(this, "Board", "ShowPenPreviewCircle", true);
+    penPreviewFromSize = new UBTypedSetting<int>(this, "Board", "PenPreviewFromSize", 5);
 
     webUseExternalBrowser = new UBSetting(this, "Web", "UseExternalBrowser", false);
 
@@ -373,7 +373,9 @@ void UBSettings::init()
     webCookiePolicy = new UBSetting(this, "Web", "CookiePolicy", "DenyThirdParty");
     webPrivateBrowsing = new UBSetting(this, "Web", "PrivateBrowsing", false);
 
-    pageCacheSize = new UBSetting(this, "App", "PageCacheSize", 20);
+    pageCacheMemoryLimit = new UBSetting(this, "App", "PageCacheMemoryLimit", 512); // MB
+    pagePrefetchDepth = new UBSetting(this, "App", "PagePrefetchDepth", 5);
+    imageCacheMemoryLimit = new UBSetting(this, "App", "ImageCacheMemoryLimit", 256); // MB
 
     bitmapFileExtensions << "jpg" << "jpeg" <<  "png" <<  "tiff" << "tif" << "bmp" << "gif";
     vectoFileExtensions << "svg" <<  "svgz";
@@ -421,6 +423,8 @@ void UBSettings::init()
     pdfPageFormat = new UBSetting(this, "PDF", "PageFormat", "A4");
     pdfUsePDFMerger = new UBSetting(this, "PDF", "UsePDFMerger", "true");
     pdfResolution = new UBSetting(this, "PDF", "Resolution", "300");
+    pdfTileCacheMemoryLimit = new UBSetting(this, "PDF", "TileCacheMemoryLimit", 256); // MB
+    pdfCompressObjectStreams = new UBSetting(this, "PDF", "CompressObjectStreams", false);
 
     exportBackgroundGrid = new UBSetting(this, "PDF", "ExportBackgroundGrid", false);
     exportBackgroundColor = new UBSetting(this, "PDF", "ExportBackgroundColor", false);
@@ -431,6 +435,7 @@ void UBSettings::init()
 
     podcastWindowsMediaBitsPerSecond = new UBSetting(this, "Podcast", "WindowsMediaBitsPerSecond", 1700000);
     podcastQuickTimeQuality = new UBSetting(this, "Podcast", "QuickTimeQuality", "High");
+    podcastDamageRegionEncoding = new UBSetting(this, "Podcast", "DamageRegionEncoding", true);
 
     podcastPublishToYoutube = new UBSetting(this, "Podcast", "PublishToYouTube", false);
     youTubeUserEMail = new UBSetting(this, "YouTube", "UserEMail", "");
@@ -452,6 +457,7 @@ void UBSettings::init()
     documentSortOrder           = new UBSetting(this, "Document", "SortOrder", UBSettings::defaultSortOrder);
     documentSplitterLeftSize    = new UBSetting(this, "Document", "SplitterLeftSize", UBSettings::defaultSplitterLeftSize);
     documentSplitterRightSize   = new UBSetting(this, "Document", "SplitterRightSize", UBSettings::defaultSplitterRightSize);
+    documentUsePageManifest     = new UBSetting(this, "Document", "UsePageManifest", false);
 
     libraryShowDetailsForLocalItems = new UBSetting(this, "Library", "ShowDetailsForLocalItems", false);
 
@@ -468,7 +474,7 @@ void UBSettings::init()
     KeyboardLocale = new UBSetting(this, "Board", "StartupKeyboardLocale", 0);
     swapControlAndDisplayScreens = new UBSetting(this, "App", "SwapControlAndDisplayScreens", false);
 
-    rotationAngleStep = new UBSetting(this, "App", "RotationAngleStep", 5.);
+    rotationAngleStep = new UBTypedSetting<qreal>(this, "App", "RotationAngleStep", 5.0);
     historyLimit = new UBSetting(this, "Web", "HistoryLimit", 15);
 
     libIconSize = new UBSetting(this, "Library", "LibIconSize", defaultLibraryIconSize);
@@ -599,18 +605,18 @@ qreal UBSettings::currentPenWidth()
     switch (penWidthIndex())
     {
         case UBWidth::Fine:
-            width = boardPenFineWidth->get().toDouble();
+            width = boardPenFineWidth->value();
             break;
         case UBWidth::Medium:
-            width = boardPenMediumWidth->get().toDouble();
+            width = boardPenMediumWidth->value();
             break;
         case UBWidth::Strong:
-            width = boardPenStrongWidth->get().toDouble();
+            width = boardPenStrongWidth->value();
             break;
         default:
             Q_ASSERT(false);
             //failsafe
-            width = boardPenFineWidth->get().toDouble();
+            width = boardPenFineWidth->value();
             break;
     }
 
@@ -681,18 +687,18 @@ qreal UBSettings::currentMarkerWidth()
     switch (markerWidthIndex())
     {
         case UBWidth::Fine:
-            width = boardMarkerFineWidth->get().toDouble();
+            width = boardMarkerFineWidth->value();
             break;
         case UBWidth::Medium:
-            width = boardMarkerMediumWidth->get().toDouble();
+            width = boardMarkerMediumWidth->value();
             break;
         case UBWidth::Strong:
-            width = boardMarkerStrongWidth->get().toDouble();
+            width = boardMarkerStrongWidth->value();
             break;
         default:
             Q_ASSERT(false);
             //failsafe
-            width = boardMarkerFineWidth->get().toDouble();
+            width = boardMarkerFineWidth->value();
             break;
     }
 
@@ -1101,6 +1107,16 @@ QString UBSettings::userTrashDirPath()
     return trashPath;
 }
 
+QString UBSettings::userLibraryIconCacheDirectory()
+{
+    static QString dirPath = "";
+    if(dirPath.isEmpty()){
+        dirPath = userDataDirectory() + "/libraryPalette/iconCache";
+        checkDirectory(dirPath);
+    }
+    return dirPath;
+}
+
 
 QString UBSettings::userGipLibraryDirectory()
 {
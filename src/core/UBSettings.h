@@ -136,6 +136,7 @@ class UBSettings : public QObject
         static QString userDocumentDirectory();
         static QString userFavoriteListFilePath();
         static QString userTrashDirPath();
+        static QString userLibraryIconCacheDirectory();
         static QString userImageDirectory();
         static QString userVideoDirectory();
         static QString userAudioDirectory();
@@ -275,25 +276,25 @@ class UBSettings : public QObject
 
         UBSetting* appStartupHintsEnabled;
 
-        UBSetting* boardPenFineWidth;
-        UBSetting* boardPenMediumWidth;
-        UBSetting* boardPenStrongWidth;
+        UBTypedSetting<qreal>* boardPenFineWidth;
+        UBTypedSetting<qreal>* boardPenMediumWidth;
+        UBTypedSetting<qreal>* boardPenStrongWidth;
 
-        UBSetting* boardMarkerFineWidth;
-        UBSetting* boardMarkerMediumWidth;
-        UBSetting* boardMarkerStrongWidth;
+        UBTypedSetting<qreal>* boardMarkerFineWidth;
+        UBTypedSetting<qreal>* boardMarkerMediumWidth;
+        UBTypedSetting<qreal>* boardMarkerStrongWidth;
 
-        UBSetting* boardPenPressureSensitive;
-        UBSetting* boardMarkerPressureSensitive;
+        UBTypedSetting<bool>* boardPenPressureSensitive;
+        UBTypedSetting<bool>* boardMarkerPressureSensitive;
 
-        UBSetting* boardUseHighResTabletEvent;
+        UBTypedSetting<bool>* boardUseHighResTabletEvent;
 
-        UBSetting* boardInterpolatePenStrokes;
-        UBSetting* boardSimplifyPenStrokes;
-        UBSetting* boardSimplifyPenStrokesThresholdAngle;
-        UBSetting* boardSimplifyPenStrokesThresholdWidthDifference;
-        UBSetting* boardInterpolateMarkerStrokes;
-        UBSetting* boardSimplifyMarkerStrokes;
+        UBTypedSetting<bool>* boardInterpolatePenStrokes;
+        UBTypedSetting<bool>* boardSimplifyPenStrokes;
+        UBTypedSetting<qreal>* boardSimplifyPenStrokesThresholdAngle;
+        UBTypedSetting<qreal>* boardSimplifyPenStrokesThresholdWidthDifference;
+        UBTypedSetting<bool>* boardInterpolateMarkerStrokes;
+        UBTypedSetting<bool>* boardSimplifyMarkerStrokes;
 
         UBSetting* boardKeyboardPaletteKeyBtnSize;
 
@@ -321,10 +322,10 @@ class UBSettings : public QObject
         UBColorListSetting* boardMarkerDarkBackgroundColors;
         UBColorListSetting* boardMarkerDarkBackgroundSelectedColors;
 
-        UBSetting* showEraserPreviewCircle;
-        UBSetting* showMarkerPreviewCircle;
-        UBSetting* showPenPreviewCircle;
-        UBSetting* penPreviewFromSize;
+        UBTypedSetting<bool>* showEraserPreviewCircle;
+        UBTypedSetting<bool>* showMarkerPreviewCircle;
+        UBTypedSetting<bool>* showPenPreviewCircle;
+        UBTypedSetting<int>* penPreviewFromSize;
 
         UBSetting* webUseExternalBrowser;
         UBSetting* webShowPageImmediatelyOnMirroredScreen;
@@ -338,7 +339,9 @@ class UBSettings : public QObject
         UBSetting* webCookiePolicy;
         UBSetting* webPrivateBrowsing;
 
-        UBSetting* pageCacheSize;
+        UBSetting* pageCacheMemoryLimit;
+        UBSetting* pagePrefetchDepth;
+        UBSetting* imageCacheMemoryLimit;
 
         UBSetting* boardZoomBase;
         UBSetting* boardZoomFactor;
@@ -366,6 +369,8 @@ class UBSettings : public QObject
         UBSetting* pdfPageFormat;
         UBSetting* pdfUsePDFMerger;
         UBSetting* pdfResolution;
+        UBSetting* pdfTileCacheMemoryLimit;
+        UBSetting* pdfCompressObjectStreams;
 
         UBSetting* exportBackgroundGrid;
         UBSetting* exportBackgroundColor;
@@ -375,6 +380,7 @@ class UBSettings : public QObject
         UBSetting* podcastWindowsMediaBitsPerSecond;
         UBSetting* podcastAudioRecordingDevice;
         UBSetting* podcastQuickTimeQuality;
+        UBSetting* podcastDamageRegionEncoding;
 
         UBSetting* podcastPublishToYoutube;
         UBSetting* youTubeUserEMail;
@@ -391,6 +397,7 @@ class UBSettings : public QObject
         UBSetting* documentSortOrder;
         UBSetting* documentSplitterLeftSize;
         UBSetting* documentSplitterRightSize;
+        UBSetting* documentUsePageManifest;
         UBSetting* imageThumbnailWidth;
         UBSetting* videoThumbnailWidth;
         UBSetting* shapeThumbnailWidth;
@@ -417,7 +424,7 @@ class UBSettings : public QObject
         UBSetting* KeyboardLocale;
         UBSetting* swapControlAndDisplayScreens;
 
-        UBSetting* rotationAngleStep;
+        UBTypedSetting<qreal>* rotationAngleStep;
         UBSetting* historyLimit;
 
         UBSetting* libIconSize;
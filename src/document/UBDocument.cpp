@@ -37,6 +37,15 @@ UBDocument::UBDocument(std::shared_ptr<UBDocumentProxy> proxy)
     , mThumbnailScene(new UBThumbnailScene(this))
 {
     mThumbnailScene->createThumbnails();
+
+    // thumbnails of saved pages are written in the background
+    QObject::connect(UBPersistenceManager::persistenceManager(), &UBPersistenceManager::documentThumbnailPersisted,
+                     mThumbnailScene, [this](std::shared_ptr<UBDocumentProxy> proxy, int index){
+        if (proxy == mProxy)
+        {
+            mThumbnailScene->reloadThumbnail(index);
+        }
+    });
 }
 
 UBDocument::~UBDocument()
@@ -150,7 +159,11 @@ void UBDocument::persistPage(std::shared_ptr<UBGraphicsScene> scene, const int i
 {
     UBPersistenceManager::persistenceManager()->persistDocumentScene(mProxy, scene, index, isAutomaticBackup,
                                                                      forceImmediateSaving);
-    mThumbnailScene->reloadThumbnail(index);
+
+    if (forceImmediateSaving)
+    {
+        mThumbnailScene->reloadThumbnail(index);
+    }
 }
 
 UBThumbnailScene* UBDocument::thumbnailScene() const
@@ -29,6 +29,7 @@
 
 #include "UBDocumentProxy.h"
 
+#include "frameworks/UBFileSystemUtils.h"
 #include "frameworks/UBStringUtils.h"
 
 #include "core/UBApplication.h"
@@ -41,6 +42,7 @@
 
 UBDocumentProxy::UBDocumentProxy()
     : mPageCount(0)
+    , mHasPageManifest(false)
     , mPageDpi(0)
     , mPersistencePath("")
     , mDocumentDateLittleEndian("")
@@ -55,6 +57,7 @@ UBDocumentProxy::UBDocumentProxy()
 
 UBDocumentProxy::UBDocumentProxy(const QString& pPersistancePath)
     : mPageCount(0)
+    , mHasPageManifest(false)
     , mPageDpi(0)
     , mNeedsCleanup(true)
     , mLastVisitedIndex(0)
@@ -96,6 +99,8 @@ std::shared_ptr<UBDocumentProxy> UBDocumentProxy::deepCopy() const
     copy->mPersistencePath = QString(mPersistencePath);
     copy->mMetaDatas = QMap<QString, QVariant>(mMetaDatas);
     copy->mPageCount = mPageCount;
+    copy->mHasPageManifest = mHasPageManifest;
+    copy->mPageIds = mPageIds;
     copy->mLastVisitedIndex = mLastVisitedIndex;
     copy->mIsInFavoriteList = mIsInFavoriteList;
 
@@ -133,6 +138,89 @@ void UBDocumentProxy::setPageCount(int pPageCount)
     mPageCount = pPageCount;
 }
 
+bool UBDocumentProxy::hasPageManifest() const
+{
+    return mHasPageManifest;
+}
+
+/**
+ * @brief File name of a page relative to the document folder.
+ *
+ * Legacy documents encode the page order in the file names (page000.svg, page001.svg, ...).
+ * Documents with a page manifest name the files after the stable id of the page.
+ */
+QString UBDocumentProxy::pageFileName(int pageIndex) const
+{
+    if (mHasPageManifest)
+    {
+        return "page-" + mPageIds.value(pageIndex) + ".svg";
+    }
+
+    return UBFileSystemUtils::digitFileFormat("page%1.svg", pageIndex);
+}
+
+QString UBDocumentProxy::thumbnailFileName(int pageIndex) const
+{
+    if (mHasPageManifest)
+    {
+        return "page-" + mPageIds.value(pageIndex) + ".thumbnail.jpg";
+    }
+
+    return UBFileSystemUtils::digitFileFormat("page%1.thumbnail.jpg", pageIndex);
+}
+
+QString UBDocumentProxy::pageFilePath(int pageIndex) const
+{
+    return mPersistencePath + "/" + pageFileName(pageIndex);
+}
+
+QString UBDocumentProxy::thumbnailFilePath(int pageIndex) const
+{
+    return mPersistencePath + "/" + thumbnailFileName(pageIndex);
+}
+
+QStringList UBDocumentProxy::pageIds() const
+{
+    return mPageIds;
+}
+
+void UBDocumentProxy::setPageIds(const QStringList& pageIds)
+{
+    mHasPageManifest = true;
+    mPageIds = pageIds;
+}
+
+void UBDocumentProxy::clearPageIds()
+{
+    mHasPageManifest = false;
+    mPageIds.clear();
+}
+
+/**
+ * @brief Insert a new page id, the page count is not modified.
+ * @return the new id
+ */
+QString UBDocumentProxy::insertPageId(int pageIndex)
+{
+    // without braces, the cleanup of a document only considers braced uuids as object files
+    const QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    mPageIds.insert(pageIndex, id);
+    return id;
+}
+
+void UBDocumentProxy::removePageId(int pageIndex)
+{
+    if (pageIndex >= 0 && pageIndex < mPageIds.size())
+    {
+        mPageIds.removeAt(pageIndex);
+    }
+}
+
+void UBDocumentProxy::movePageId(int sourceIndex, int targetIndex)
+{
+    mPageIds.move(sourceIndex, targetIndex);
+}
+
 int UBDocumentProxy::pageDpi()
 {
     return mPageDpi;
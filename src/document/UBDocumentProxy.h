@@ -39,6 +39,7 @@ class UBGraphicsScene;
 class UBDocumentProxy
 {
     friend class UBPersistenceManager;
+    friend class UBDocumentIndex;
 
     public:
 
@@ -98,6 +99,13 @@ class UBDocumentProxy
 
         int pageCount();
 
+        bool hasPageManifest() const;
+        QString pageFileName(int pageIndex) const;
+        QString thumbnailFileName(int pageIndex) const;
+        QString pageFilePath(int pageIndex) const;
+        QString thumbnailFilePath(int pageIndex) const;
+        QStringList pageIds() const;
+
         int pageDpi();
         void setPageDpi(int dpi);
 
@@ -117,6 +125,12 @@ class UBDocumentProxy
         int incPageCount();
         int decPageCount();
 
+        void setPageIds(const QStringList& pageIds);
+        void clearPageIds();
+        QString insertPageId(int pageIndex);
+        void removePageId(int pageIndex);
+        void movePageId(int sourceIndex, int targetIndex);
+
     private:
 
         void init();
@@ -130,6 +144,10 @@ class UBDocumentProxy
 
         int mPageCount;
 
+        // stable ids of the pages in page order, only used by documents with a page manifest
+        bool mHasPageManifest;
+        QStringList mPageIds;
+
         int mPageDpi;
 
         QMap<QUuid, bool> mWidgetCompatibility;
@@ -87,7 +87,7 @@ UBGraphicsDelegateFrame::UBGraphicsDelegateFrame(UBGraphicsItemDelegate* pDelega
     , mTitleBarHeight(hasTitleBar ? 20 :0)
     , mNominalTitleBarHeight(hasTitleBar ? 20:0)
 {
-    mRotationAngleStep = UBSettings::settings()->rotationAngleStep->get().toReal();
+    mRotationAngleStep = UBSettings::settings()->rotationAngleStep->value();
 
     setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
 
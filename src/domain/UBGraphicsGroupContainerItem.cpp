@@ -248,7 +248,7 @@ void UBGraphicsGroupContainerItem::copyItemParameters(UBItem *copy) const
 void UBGraphicsGroupContainerItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 void UBGraphicsGroupContainerItem::destroy(bool canUndo) {
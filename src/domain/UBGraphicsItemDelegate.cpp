@@ -315,6 +315,11 @@ QVariant UBGraphicsItemDelegate::itemChange(QGraphicsItem::GraphicsItemChange ch
             showHide(shownOnDisplay);
             break;
         }
+        case QGraphicsItem::ItemSceneChange :
+        {
+            UBCoreGraphicsScene::itemSceneChange(delegated(), value);
+            break;
+        }
         case QGraphicsItem::ItemPositionHasChanged :
         case QGraphicsItem::ItemTransformHasChanged :
         case QGraphicsItem::ItemZValueHasChanged :
@@ -314,7 +314,7 @@ void UBGraphicsMediaItem::setMinimumSize(const QSize& size)
 void UBGraphicsMediaItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid));
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 void UBGraphicsMediaItem::setMediaFileUrl(QUrl url)
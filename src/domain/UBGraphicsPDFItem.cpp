@@ -35,6 +35,10 @@
 #include "UBGraphicsPixmapItem.h"
 #include "UBGraphicsItemDelegate.h"
 
+#include "board/UBBoardController.h"
+#include "board/UBBoardView.h"
+#include "core/UBApplication.h"
+
 #include "core/memcheck.h"
 
 UBGraphicsPDFItem::UBGraphicsPDFItem(PDFRenderer *renderer, int pageNumber, QGraphicsItem* parent)
@@ -71,7 +75,7 @@ void UBGraphicsPDFItem::updateChild()
 void UBGraphicsPDFItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid));
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 void UBGraphicsPDFItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -112,6 +116,18 @@ void UBGraphicsPDFItem::paint(QPainter *painter, const QStyleOptionGraphicsItem
     Delegate()->postpaint(painter, option, widget);
 }
 
+PDFRenderer::RenderPriority UBGraphicsPDFItem::renderPriority(const QWidget *widget) const
+{
+    UBBoardView* displayView = UBApplication::boardController ? UBApplication::boardController->displayView() : nullptr;
+
+    if (widget && displayView && widget == displayView->viewport())
+    {
+        return PDFRenderer::DisplayPriority;
+    }
+
+    return GraphicsPDFItem::renderPriority(widget);
+}
+
 UBItem* UBGraphicsPDFItem::deepCopy() const
 {
     UBGraphicsPDFItem *copy =  new UBGraphicsPDFItem(mRenderer, mPageNumber, parentItem());
@@ -74,6 +74,7 @@ class UBGraphicsPDFItem: public GraphicsPDFItem, public UBItem, public UBGraphic
         virtual void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
 
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+        virtual PDFRenderer::RenderPriority renderPriority(const QWidget *widget) const;
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
         virtual void updateChild();
     private slots:
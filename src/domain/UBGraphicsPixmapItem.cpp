@@ -33,6 +33,8 @@
 #include <QMimeData>
 #include <QDrag>
 
+#include <cmath>
+
 #include "UBGraphicsScene.h"
 
 #include "UBGraphicsItemDelegate.h"
@@ -79,19 +81,116 @@ QVariant UBGraphicsPixmapItem::itemChange(GraphicsItemChange change, const QVari
 void UBGraphicsPixmapItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid));
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
+}
+
+/**
+ * @brief Show a shared image of the image cache, allowing to draw from its mip levels.
+ */
+void UBGraphicsPixmapItem::setImage(std::shared_ptr<const UBImageCache::Image> image)
+{
+    if (isLoading())
+    {
+        prepareGeometryChange();
+        mLoadingPath.clear();
+        mLoadingSize = QSize();
+    }
+
+    mImage = image;
+    setPixmap(image ? image->pixmap() : QPixmap());
+}
+
+/**
+ * @brief Show the image of a file, decoding it in the background if it is not in the image cache.
+ *
+ * The size of the image is read from the file header, so that the item has its final geometry
+ * and shows a placeholder until the image is decoded.
+ */
+void UBGraphicsPixmapItem::loadImage(const QString& path)
+{
+    auto image = UBImageCache::instance().cachedImage(path);
+
+    if (image)
+    {
+        setImage(image);
+        return;
+    }
+
+    const QSize size = UBImageCache::imageSize(path);
+
+    if (!size.isValid())
+    {
+        // unknown geometry, decode now
+        setImage(UBImageCache::instance().image(path));
+        return;
+    }
+
+    prepareGeometryChange();
+    mImage.reset();
+    setPixmap(QPixmap());
+    mLoadingPath = path;
+    mLoadingSize = size;
+
+    UBImageCache::instance().requestImage(path, this, [this, path](std::shared_ptr<const UBImageCache::Image> image) {
+        // ignore the result if another image was set meanwhile
+        if (mLoadingPath == path)
+        {
+            setImage(image);
+        }
+    });
+}
+
+bool UBGraphicsPixmapItem::isLoading() const
+{
+    return !mLoadingPath.isEmpty();
+}
+
+/**
+ * @brief Decode the image now if it is still being loaded in the background.
+ */
+void UBGraphicsPixmapItem::finishLoading()
+{
+    if (isLoading())
+    {
+        setImage(UBImageCache::instance().image(mLoadingPath));
+    }
+}
+
+QRectF UBGraphicsPixmapItem::boundingRect() const
+{
+    if (isLoading())
+    {
+        return QRectF(offset(), QSizeF(mLoadingSize));
+    }
+
+    return QGraphicsPixmapItem::boundingRect();
+}
+
+QPainterPath UBGraphicsPixmapItem::shape() const
+{
+    if (isLoading())
+    {
+        QPainterPath path;
+        path.addRect(boundingRect());
+        return path;
+    }
+
+    return QGraphicsPixmapItem::shape();
 }
 
 void UBGraphicsPixmapItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    QMimeData* pMime = new QMimeData();
-    pMime->setImageData(pixmap().toImage());
-    Delegate()->setMimeData(pMime);
-    qreal k = (qreal)pixmap().width() / 100.0;
+    if (!pixmap().isNull())
+    {
+        QMimeData* pMime = new QMimeData();
+        pMime->setImageData(pixmap().toImage());
+        Delegate()->setMimeData(pMime);
+        qreal k = (qreal)pixmap().width() / 100.0;
 
-    QSize newSize((int)(pixmap().width() / k), (int)(pixmap().height() / k));
+        QSize newSize((int)(pixmap().width() / k), (int)(pixmap().height() / k));
 
-    Delegate()->setDragPixmap(pixmap().scaled(newSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        Delegate()->setDragPixmap(pixmap().scaled(newSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
 
     if (Delegate()->mousePressEvent(event))
     {
@@ -130,7 +229,37 @@ void UBGraphicsPixmapItem::paint(QPainter *painter, const QStyleOptionGraphicsIt
     QStyleOptionGraphicsItem styleOption = QStyleOptionGraphicsItem(*option);
 
     styleOption.state &= ~QStyle::State_Selected;
-    QGraphicsPixmapItem::paint(painter, &styleOption, widget);
+
+    if (isLoading())
+    {
+        // placeholder until the image is decoded
+        painter->fillRect(boundingRect(), QColor(128, 128, 128, 64));
+        Delegate()->postpaint(painter, option, widget);
+        painter->setRenderHint(QPainter::Antialiasing, true);
+        return;
+    }
+
+    const QPixmap& pix = pixmap();
+    int level = 0;
+
+    if (mImage && mImage->pixmap().cacheKey() == pix.cacheKey())
+    {
+        const qreal scale = std::sqrt(std::abs(painter->worldTransform().determinant())) * painter->device()->devicePixelRatioF();
+        level = mImage->levelForScale(scale / pix.devicePixelRatio());
+    }
+
+    if (level > 0)
+    {
+        // draw the mip level closest to the zoom factor instead of scaling down the whole image
+        const QPixmap& levelPixmap = mImage->level(level);
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, transformationMode() == Qt::SmoothTransformation);
+        painter->drawPixmap(QRectF(offset(), QSizeF(pix.size()) / pix.devicePixelRatio()), levelPixmap, QRectF(levelPixmap.rect()));
+    }
+    else
+    {
+        QGraphicsPixmapItem::paint(painter, &styleOption, widget);
+    }
+
     Delegate()->postpaint(painter, option, widget);
 
     painter->setRenderHint(QPainter::Antialiasing, true);
@@ -155,7 +284,18 @@ void UBGraphicsPixmapItem::copyItemParameters(UBItem *copy) const
     UBGraphicsPixmapItem *cp = dynamic_cast<UBGraphicsPixmapItem*>(copy);
     if (cp)
     {
-        cp->setPixmap(this->pixmap());
+        if (isLoading())
+        {
+            // shares the pending decode
+            cp->loadImage(mLoadingPath);
+        }
+        else
+        {
+            // the pixmap is implicitly shared, the copy shares the cached image as well
+            cp->mImage = mImage;
+            cp->setPixmap(this->pixmap());
+        }
+
         cp->setPos(this->pos());
         cp->setTransform(this->transform());
         cp->setFlag(QGraphicsItem::ItemIsMovable, true);
@@ -33,6 +33,7 @@
 #include <QtGui>
 
 #include "core/UB.h"
+#include "core/UBImageCache.h"
 
 #include "UBItem.h"
 
@@ -67,6 +68,14 @@ class UBGraphicsPixmapItem : public QObject, public QGraphicsPixmapItem, public
 
         virtual void setUuid(const QUuid &pUuid);
 
+        void setImage(std::shared_ptr<const UBImageCache::Image> image);
+        void loadImage(const QString& path);
+        bool isLoading() const;
+        void finishLoading();
+
+        virtual QRectF boundingRect() const;
+        virtual QPainterPath shape() const;
+
 protected:
 
         virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -76,6 +85,14 @@ protected:
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+
+private:
+        // shared image of the file, only used while the pixmap was not replaced
+        std::shared_ptr<const UBImageCache::Image> mImage;
+
+        // file and size of the image being decoded, a placeholder is shown meanwhile
+        QString mLoadingPath;
+        QSize mLoadingSize;
 };
 
 #endif /* UBGRAPHICSPIXMAPITEM_H_ */
@@ -95,7 +95,18 @@ void UBGraphicsPolygonItem::initialize()
 void UBGraphicsPolygonItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
+}
+
+QVariant UBGraphicsPolygonItem::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    // strokes have no delegate, which updates the uuid index for the other items
+    if (change == QGraphicsItem::ItemSceneChange)
+    {
+        UBCoreGraphicsScene::itemSceneChange(this, value);
+    }
+
+    return QGraphicsPolygonItem::itemChange(change, value);
 }
 
 void UBGraphicsPolygonItem::clearStroke()
@@ -41,6 +41,7 @@ class UBGraphicsStroke;
 
 class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
 {
+    friend class UBGraphicsStrokeItem;
 
     public:
 
@@ -136,6 +137,7 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
 
     protected:
         void paint ( QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget);
+        QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
 
     private:
@@ -78,6 +78,7 @@
 #include "domain/UBGraphicsGroupContainerItem.h"
 
 #include "UBGraphicsStroke.h"
+#include "UBGraphicsStrokeItem.h"
 
 #include "core/memcheck.h"
 
@@ -320,6 +321,7 @@ UBGraphicsScene::UBGraphicsScene(std::shared_ptr<UBDocumentProxy> document, bool
     , mPointer(0)
     , mMarkerCircle(0)
     , mPenCircle(0)
+    , mEraserTimer(0)
     , mDocument(document)
     , mDarkBackground(false)
     , mPageBackground(UBPageBackground::plain)
@@ -535,7 +537,7 @@ bool UBGraphicsScene::inputDevicePressImpl(const QPointF& scenePos, const qreal&
             eraserWidth /= UBApplication::boardController->systemScaleFactor();
             eraserWidth /= UBApplication::boardController->currentZoom();
 
-            eraseLineTo(scenePos, eraserWidth);
+            queueEraseLineTo(scenePos, eraserWidth);
             drawEraser(scenePos, mInputDeviceIsPressed);
 
             accepted = true;
@@ -629,7 +631,7 @@ bool UBGraphicsScene::inputDeviceMoveImpl(const QPointF& scenePos, const qreal&
 
                 if (isSnapping())
                 {
-                    double step = UBSettings::settings()->rotationAngleStep->get().toDouble();
+                    double step = UBSettings::settings()->rotationAngleStep->value();
                     QLineF radius(mPreviousPoint, position);
                     qreal angle = radius.angle();
                     angle = qRound(angle / step) * step;
@@ -679,8 +681,8 @@ bool UBGraphicsScene::inputDeviceMoveImpl(const QPointF& scenePos, const qreal&
             else {
                 bool interpolate = false;
 
-                if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardInterpolatePenStrokes->get().toBool())
-                    || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardInterpolateMarkerStrokes->get().toBool()))
+                if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardInterpolatePenStrokes->value())
+                    || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardInterpolateMarkerStrokes->value()))
                 {
                     interpolate = true;
                 }
@@ -730,7 +732,7 @@ bool UBGraphicsScene::inputDeviceMoveImpl(const QPointF& scenePos, const qreal&
             eraserWidth /= UBApplication::boardController->systemScaleFactor();
             eraserWidth /= UBApplication::boardController->currentZoom();
 
-            eraseLineTo(position, eraserWidth);
+            queueEraseLineTo(position, eraserWidth);
         }
         else if (currentTool == UBStylusTool::Pointer)
         {
@@ -747,6 +749,8 @@ bool UBGraphicsScene::inputDeviceReleaseImpl(int tool, Qt::KeyboardModifiers mod
 {
     bool accepted = false;
 
+    erasePendingLines();
+
     if (mPointer)
     {
         mPointer->hide();
@@ -800,12 +804,15 @@ bool UBGraphicsScene::inputDeviceReleaseImpl(int tool, Qt::KeyboardModifiers mod
             }
 
             // replace the stroke by a simplified version of it
-            if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardSimplifyPenStrokes->get().toBool())
-                || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardSimplifyMarkerStrokes->get().toBool()))
+            if ((currentTool == UBStylusTool::Pen && UBSettings::settings()->boardSimplifyPenStrokes->value())
+                || (currentTool == UBStylusTool::Marker && UBSettings::settings()->boardSimplifyMarkerStrokes->value()))
             {
                 simplifyCurrentStroke();
             }
 
+            // replace the segments of a freehand stroke by a single item
+            if (currentTool == UBStylusTool::Pen || currentTool == UBStylusTool::Marker)
+                consolidateCurrentStroke();
 
             UBGraphicsStrokesGroup* pStrokes = new UBGraphicsStrokesGroup();
 
@@ -874,7 +881,7 @@ bool UBGraphicsScene::palmPressImpl(const QPointF& scenePos, const qreal& diamet
         eraserWidth /= UBApplication::boardController->systemScaleFactor();
         eraserWidth /= UBApplication::boardController->currentZoom();
         moveTo(scenePos);
-        eraseLineTo(scenePos, eraserWidth);
+        queueEraseLineTo(scenePos, eraserWidth);
         accepted = true;
     }
     return accepted;
@@ -888,7 +895,7 @@ bool UBGraphicsScene::palmMoveImpl(const QPointF& scenePos, const qreal& diamete
         qreal eraserWidth = diameter;
         eraserWidth /= UBApplication::boardController->systemScaleFactor();
         eraserWidth /= UBApplication::boardController->currentZoom();
-        eraseLineTo(scenePos, eraserWidth);
+        queueEraseLineTo(scenePos, eraserWidth);
         accepted = true;
     }
     return accepted;
@@ -899,6 +906,7 @@ bool UBGraphicsScene::palmReleaseImpl()
     bool accepted = false;
     if (mInputDeviceIsPressed)
     {
+        erasePendingLines();
         hideEraser();
         mInputDeviceIsPressed = false;
         accepted = true;
@@ -979,8 +987,8 @@ void UBGraphicsScene::drawPenCircle(const QPointF &pPoint)
 {
     QCursor cursor;
 
-    if (mPenCircle && UBSettings::settings()->showPenPreviewCircle->get().toBool() &&
-        UBSettings::settings()->currentPenWidth() >= UBSettings::settings()->penPreviewFromSize->get().toInt()) {
+    if (mPenCircle && UBSettings::settings()->showPenPreviewCircle->value() &&
+        UBSettings::settings()->currentPenWidth() >= UBSettings::settings()->penPreviewFromSize->value()) {
         qreal penDiameter = UBSettings::settings()->currentPenWidth();
         penDiameter /= UBApplication::boardController->systemScaleFactor();
         penDiameter /= UBApplication::boardController->currentZoom();
@@ -1143,79 +1151,126 @@ void UBGraphicsScene::eraseLineTo(const QPointF &pEndPoint, const qreal &pWidth)
     const QLineF line(mPreviousPoint, pEndPoint);
     mPreviousPoint = pEndPoint;
 
-    const QPolygonF eraserPolygon = UBGeometryUtils::lineToPolygon(line, pWidth);
-    const QRectF eraserBoundingRect = eraserPolygon.boundingRect();
+    erasePolygons({UBGeometryUtils::lineToPolygon(line, pWidth)});
+}
+
+/**
+ * @brief Queue an eraser line, the queued lines are erased together once per frame
+ *
+ * Tablets report positions faster than the screen refreshes, erasing the lines of a frame
+ * in one pass avoids creating and removing the intermediate pieces of the strokes.
+ */
+void UBGraphicsScene::queueEraseLineTo(const QPointF &pEndPoint, const qreal &pWidth)
+{
+    const QLineF line(mPreviousPoint, pEndPoint);
+    mPreviousPoint = pEndPoint;
+
+    mPendingEraserPolygons << UBGeometryUtils::lineToPolygon(line, pWidth);
+
+    if (!mEraserTimer)
+    {
+        mEraserTimer = new QTimer(this);
+        mEraserTimer->setSingleShot(true);
+        mEraserTimer->setInterval(16);
 
-    QPainterPath eraserPath;
-    eraserPath.addPolygon(eraserPolygon);
+        connect(mEraserTimer, &QTimer::timeout, this, [this](){
+            for (PointerState& state : mPointerStates)
+            {
+                if (!state.mPendingEraserPolygons.isEmpty())
+                {
+                    loadPointerState(state);
+                    erasePendingLines();
+                    savePointerState(state);
+                }
+            }
+        });
+    }
+
+    if (!mEraserTimer->isActive())
+    {
+        mEraserTimer->start();
+    }
+}
+
+void UBGraphicsScene::erasePendingLines()
+{
+    if (!mPendingEraserPolygons.isEmpty())
+    {
+        const QList<QPolygonF> eraserPolygons = mPendingEraserPolygons;
+        mPendingEraserPolygons.clear();
+        erasePolygons(eraserPolygons);
+    }
+}
 
-    // Retrieve items affected by the eraser path
-    const auto itemsList = items(eraserPath, Qt::ContainsItemShape);
-    QSet<QGraphicsItem*> fullyContained(itemsList.cbegin(), itemsList.cend());
-    fullyContained.remove(mEraser);
+void UBGraphicsScene::erasePolygons(const QList<QPolygonF>& eraserPolygons)
+{
+    QRectF eraserBoundingRect;
 
-    QList<QGraphicsItem*> collidItems = items(eraserPath, Qt::IntersectsItemShape);
-    collidItems.removeOne(mEraser);
+    foreach(const QPolygonF& eraserPolygon, eraserPolygons)
+    {
+        eraserBoundingRect |= eraserPolygon.boundingRect();
+    }
 
-    QList<UBGraphicsPolygonItem*> intersectedItems;
+    // the scene index gives the candidates, the exact test is made when clipping their polygons
+    const QList<QGraphicsItem*> candidates = items(eraserBoundingRect, Qt::IntersectsItemBoundingRect);
 
-    typedef QList<QPolygonF> POLYGONSLIST;
-    QList<POLYGONSLIST> intersectedPolygons;
+    bool modified = false;
 
-    for (int i = 0; i < collidItems.size(); i++)
+    foreach(QGraphicsItem* item, candidates)
     {
-        UBGraphicsPolygonItem *pi = qgraphicsitem_cast<UBGraphicsPolygonItem *>(collidItems[i]);
-        if (!pi)
+        UBGraphicsPolygonItem *intersectedPolygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem *>(item);
+
+        if (!intersectedPolygonItem)
             continue;
 
-        if (fullyContained.contains(pi))
+        // erase the lines one after the other from the polygon, in item coordinates
+        const QTransform sceneToItem = intersectedPolygonItem->sceneTransform().inverted();
+        QList<QPolygonF> erasers;
+
+        foreach(const QPolygonF& eraserPolygon, eraserPolygons)
         {
-            // Completely remove item
-            intersectedItems << pi;
-            intersectedPolygons << QList<QPolygonF>();
+            erasers << sceneToItem.map(eraserPolygon);
         }
-        else
+
+        UBGraphicsStrokeItem* strokeItem = dynamic_cast<UBGraphicsStrokeItem*>(intersectedPolygonItem);
+        QList<QList<QPair<QPointF, qreal> > > strokes;
+        QList<QPolygonF> polygons;
+
+        // a stroke item is erased segment by segment, so that the untouched runs of segments stay strokes
+        if (strokeItem && strokeItem->points().size() > 1)
         {
-            QPainterPath itemPainterPath;
-            itemPainterPath.addPolygon(pi->sceneTransform().map(pi->polygon()));
-            itemPainterPath.setFillRule(Qt::WindingFill);
-            
-            // reverse eraserPath so that it has the opposite orientation of the stroke
-            // necessary for punching a hole with WindingFill rule
-            QPainterPath newPath = itemPainterPath.subtracted(eraserPath.toReversed());
-            intersectedItems << pi;
-            intersectedPolygons << newPath.simplified().toFillPolygons(pi->sceneTransform().inverted());
+            if (!strokeItem->erase(erasers, strokes, polygons))
+                continue;
+        }
+        else if (!UBGeometryUtils::subtractConvexPolygons(intersectedPolygonItem->polygon(), erasers, polygons))
+        {
+            continue;
         }
-    }
 
-    for(int i=0; i<intersectedItems.size(); i++)
-    {
-        // item which intersects with eraser
-        UBGraphicsPolygonItem *intersectedPolygonItem = intersectedItems[i];
+        // replace the polygon item by a couple of strokes and polygons which create the same stroke without the erased parts
+        auto addRemainingItem = [this, intersectedPolygonItem](UBGraphicsPolygonItem* polygonItem) {
+            intersectedPolygonItem->copyItemParameters(polygonItem);
+            polygonItem->setNominalLine(false);
+            polygonItem->setStroke(intersectedPolygonItem->stroke());
+            if (intersectedPolygonItem->strokesGroup())
+            {
+                polygonItem->setStrokesGroup(intersectedPolygonItem->strokesGroup());
+                intersectedPolygonItem->strokesGroup()->addToGroup(polygonItem);
+            }
+            mAddedItems << polygonItem;
+        };
 
-        if (!intersectedPolygons[i].empty())
+        foreach(const auto& stroke, strokes)
         {
-            // intersected polygons generated as QList<QPolygon> QPainterPath::toFillPolygons(),
-            // so each intersectedPolygonItem has one or couple of QPolygons who should be removed from it.
-            for(int j = 0; j < intersectedPolygons[i].size(); j++)
-            {
-                // create small polygon from couple of polygons to replace particular erased polygon
-                UBGraphicsPolygonItem* polygonItem = new UBGraphicsPolygonItem(intersectedPolygons[i][j], intersectedPolygonItem->parentItem());
+            addRemainingItem(new UBGraphicsStrokeItem(stroke, intersectedPolygonItem->parentItem()));
+        }
 
-                intersectedPolygonItem->copyItemParameters(polygonItem);
-                polygonItem->setNominalLine(false);
-                polygonItem->setStroke(intersectedPolygonItem->stroke());
-                if (intersectedPolygonItem->strokesGroup())
-                {
-                    polygonItem->setStrokesGroup(intersectedPolygonItem->strokesGroup());
-                    intersectedPolygonItem->strokesGroup()->addToGroup(polygonItem);
-                }
-                mAddedItems << polygonItem;
-            }
+        foreach(const QPolygonF& polygon, polygons)
+        {
+            addRemainingItem(new UBGraphicsPolygonItem(polygon, intersectedPolygonItem->parentItem()));
         }
 
-        //remove full polygon item and replace it by a couple of polygons which create the same stroke without the part that intersects with the eraser
-         mRemovedItems << intersectedPolygonItem;
+        mRemovedItems << intersectedPolygonItem;
 
         QTransform t;
         bool bApplyTransform = false;
@@ -1231,9 +1286,11 @@ void UBGraphicsScene::eraseLineTo(const QPointF &pEndPoint, const qreal &pWidth)
         removeItem(intersectedPolygonItem);
         if (bApplyTransform)
             intersectedPolygonItem->setTransform(t);
+
+        modified = true;
     }
 
-    if (!intersectedItems.empty())
+    if (modified)
         setModified(true);
     // Refresh only the affected region
     update(eraserBoundingRect);
@@ -2300,21 +2357,6 @@ QRectF UBGraphicsScene::normalizedSceneRect(qreal ratio)
     return normalizedRect;
 }
 
-QGraphicsItem *UBGraphicsScene::itemForUuid(QUuid uuid)
-{
-    QGraphicsItem *result = 0;
-
-    //simple search before implementing container for fast access
-    foreach (QGraphicsItem *item, items())
-    {
-        if (UBGraphicsScene::getPersonalUuid(item) == uuid && !uuid.isNull()) {
-            result = item;
-        }
-    }
-
-    return result;
-}
-
 void UBGraphicsScene::setDocument(std::shared_ptr<UBDocumentProxy> pDocument)
 {
     if (pDocument != mDocument)
@@ -2795,6 +2837,25 @@ void UBGraphicsScene::setRenderingQuality(UBItem::RenderingQuality pRenderingQua
     }
 }
 
+/**
+ * @brief Decode the images still loading in the background.
+ *
+ * Must be called before rendering the scene anywhere else than on the board, so that an
+ * export or a thumbnail never contains the placeholders of the images.
+ */
+void UBGraphicsScene::finishImageLoading()
+{
+    foreach (auto item, items())
+    {
+        UBGraphicsPixmapItem *pixmapItem = qgraphicsitem_cast<UBGraphicsPixmapItem*>(item);
+
+        if (pixmapItem)
+        {
+            pixmapItem->finishLoading();
+        }
+    }
+}
+
 QList<QUrl> UBGraphicsScene::relativeDependenciesOfItem(QGraphicsItem* item) const
 {
     QList<QUrl> relativePaths;
@@ -3268,6 +3329,49 @@ void UBGraphicsScene::simplifyCurrentStroke()
 
 }
 
+/**
+ * @brief Replace the polygons of the current stroke by a single UBGraphicsStrokeItem
+ *
+ * The stroke is drawn segment by segment while the input device moves. Once it is finished,
+ * it is rebuilt from its points as one item, which keeps the number of items in the scene
+ * index low on pages with lots of handwriting.
+ */
+void UBGraphicsScene::consolidateCurrentStroke()
+{
+    if (!mCurrentStroke || mCurrentStroke->polygons().empty() || mCurrentStroke->points().size() < 2)
+        return;
+
+    const QList<UBGraphicsPolygonItem*> polygons = mCurrentStroke->polygons();
+    QList<QPair<QPointF, qreal> > points = mCurrentStroke->points();
+
+    // the segment towards the last input position is not part of the stroke points (see inputDeviceMoveImpl)
+    UBGraphicsPolygonItem* lastPolygon = polygons.last();
+
+    if (lastPolygon->isNominalLine() && lastPolygon->originalLine().p2() != points.last().first)
+        points << QPair<QPointF, qreal>(lastPolygon->originalLine().p2(), lastPolygon->originalWidth());
+
+    UBGraphicsStrokeItem* strokeItem = new UBGraphicsStrokeItem(points);
+    initPolygonItem(strokeItem);
+
+    // attach the new item first, so that the stroke is not deleted with its last polygon
+    strokeItem->setStroke(mCurrentStroke);
+
+    foreach(UBGraphicsPolygonItem* poly, polygons)
+    {
+        mPreviousPolygonItems.removeAll(poly);
+        mAddedItems.remove(poly);
+
+        if (mpLastPolygon == poly)
+            mpLastPolygon = NULL;
+
+        removeItem(poly);
+        deleteItem(poly);
+    }
+
+    addItem(strokeItem);
+    mPreviousPolygonItems.append(strokeItem);
+}
+
 void UBGraphicsScene::setDocumentUpdated()
 {
     if (document())
@@ -3288,7 +3392,7 @@ void UBGraphicsScene::updateBackground()
 
 void UBGraphicsScene::createEraiser()
 {
-    if (UBSettings::settings()->showEraserPreviewCircle->get().toBool()) {
+    if (UBSettings::settings()->showEraserPreviewCircle->value()) {
         mEraser = new QGraphicsEllipseItem(); // mem : owned and destroyed by the scene
         mEraser->setRect(QRect(0, 0, 0, 0));
         mEraser->setVisible(false);
@@ -3321,7 +3425,7 @@ void UBGraphicsScene::createPointer()
 
 void UBGraphicsScene::createMarkerCircle()
 {
-    if (UBSettings::settings()->showMarkerPreviewCircle->get().toBool()) {
+    if (UBSettings::settings()->showMarkerPreviewCircle->value()) {
         mMarkerCircle = new QGraphicsEllipseItem();
 
         mMarkerCircle->setRect(QRect(0, 0, 0, 0));
@@ -3340,7 +3444,7 @@ void UBGraphicsScene::createMarkerCircle()
 
 void UBGraphicsScene::createPenCircle()
 {
-    if (UBSettings::settings()->showPenPreviewCircle->get().toBool()) {
+    if (UBSettings::settings()->showPenPreviewCircle->value()) {
         mPenCircle = new QGraphicsEllipseItem();
 
         mPenCircle->setRect(QRect(0, 0, 0, 0));
@@ -3453,6 +3557,7 @@ void UBGraphicsScene::loadPointerState(const PointerState &state)
     mTempPolygon = state.mTempPolygon;
     mDrawWithCompass = state.mDrawWithCompass;
     mCurrentPolygon = state.mCurrentPolygon;
+    mPendingEraserPolygons = state.mPendingEraserPolygons;
 }
 
 void UBGraphicsScene::savePointerState(PointerState &state)
@@ -3471,4 +3576,5 @@ void UBGraphicsScene::savePointerState(PointerState &state)
     state.mTempPolygon = mTempPolygon;
     state.mDrawWithCompass = mDrawWithCompass;
     state.mCurrentPolygon = mCurrentPolygon;
+    state.mPendingEraserPolygons = mPendingEraserPolygons;
 }
@@ -198,8 +198,6 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
 
         QRectF normalizedSceneRect(qreal ratio = -1.0);
 
-        QGraphicsItem *itemForUuid(QUuid uuid);
-
         void moveTo(const QPointF& pPoint);
         void drawLineTo(const QPointF& pEndPoint, const qreal& pWidth, bool bLineStyle);
         void drawLineTo(const QPointF& pEndPoint, const qreal& pStartWidth, const qreal& endWidth, bool bLineStyle);
@@ -296,6 +294,7 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem, public std::en
         }
 
         virtual void setRenderingQuality(UBItem::RenderingQuality pRenderingQuality, UBItem::CacheBehavior cacheBehavior);
+        void finishImageLoading();
 
         QList<QUrl> relativeDependenciesOfItem(QGraphicsItem* item) const;
         QList<QUrl> relativeDependencies() const;
@@ -445,11 +444,16 @@ signals:
         void updatePenCircleColor();
         bool hasTextItemWithFocus(UBGraphicsGroupContainerItem* item);
         void simplifyCurrentStroke();
+        void consolidateCurrentStroke();
+        void queueEraseLineTo(const QPointF& pEndPoint, const qreal& pWidth);
+        void erasePendingLines();
+        void erasePolygons(const QList<QPolygonF>& eraserPolygons);
 
         QGraphicsEllipseItem* mEraser;
         QGraphicsEllipseItem* mPointer; // "laser" pointer
         QGraphicsEllipseItem* mMarkerCircle; // dotted circle around marker
         QGraphicsEllipseItem* mPenCircle; // dotted circle around pen
+        QTimer* mEraserTimer; // applies the queued eraser lines once per frame
 
         QSet<QGraphicsItem*> mAddedItems;
         QSet<QGraphicsItem*> mRemovedItems;
@@ -502,6 +506,7 @@ signals:
 
         bool mDrawWithCompass;
         UBGraphicsPolygonItem *mCurrentPolygon;
+        QList<QPolygonF> mPendingEraserPolygons;
         UBSelectionFrame *mSelectionFrame;
 
         UBGraphicsCache* mGraphicsCache;
@@ -521,6 +526,7 @@ signals:
             UBGraphicsPolygonItem *mTempPolygon = nullptr;
             bool mDrawWithCompass = false;
             UBGraphicsPolygonItem *mCurrentPolygon = nullptr;
+            QList<QPolygonF> mPendingEraserPolygons;
         };
 
         QHash<int, PointerState> mPointerStates;
@@ -30,6 +30,7 @@
 #include "UBGraphicsStroke.h"
 
 #include "UBGraphicsPolygonItem.h"
+#include "UBGraphicsStrokeItem.h"
 
 #include "board/UBBoardController.h"
 #include "core/UBApplication.h"
@@ -155,6 +156,14 @@ QList<QPair<QPointF, qreal> > UBGraphicsStroke::addPoint(const QPointF& point, q
 
 bool UBGraphicsStroke::hasPressure()
 {
+    if (mPolygons.count() == 1)
+    {
+        UBGraphicsStrokeItem* strokeItem = dynamic_cast<UBGraphicsStrokeItem*>(mPolygons.at(0));
+
+        if (strokeItem)
+            return strokeItem->hasPressure();
+    }
+
     if (mPolygons.count() > 2)
     {
         qreal nominalWidth = mPolygons.at(0)->originalWidth();
@@ -227,10 +236,10 @@ UBGraphicsStroke* UBGraphicsStroke::simplify()
      */
 
     // angle difference in degrees between AB and BC below which the segments are considered colinear
-    qreal thresholdAngle = UBSettings::settings()->boardSimplifyPenStrokesThresholdAngle->get().toReal();
+    qreal thresholdAngle = UBSettings::settings()->boardSimplifyPenStrokesThresholdAngle->value();
 
     // Relative difference in thickness between two consecutive points (A and B) below which they are considered equal
-    qreal thresholdWidthDifference = UBSettings::settings()->boardSimplifyPenStrokesThresholdWidthDifference->get().toReal();
+    qreal thresholdWidthDifference = UBSettings::settings()->boardSimplifyPenStrokesThresholdWidthDifference->value();
 
     QList<strokePoint>::iterator it = points.begin();
     QList<QList<strokePoint>::iterator> toDelete;
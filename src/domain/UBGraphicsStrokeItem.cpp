@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UBGraphicsStrokeItem.h"
+
+#include <QPainterPathStroker>
+
+#include "frameworks/UBGeometryUtils.h"
+
+#include "core/memcheck.h"
+
+typedef QPair<QPointF, qreal> strokePoint;
+
+UBGraphicsStrokeItem::UBGraphicsStrokeItem(const QList<QPair<QPointF, qreal> >& points, QGraphicsItem* parent)
+    : UBGraphicsPolygonItem(parent)
+    , mPoints(points)
+    , mOutline(outline(points))
+{
+    initializeOutline();
+}
+
+UBGraphicsStrokeItem::UBGraphicsStrokeItem(const QList<QPair<QPointF, qreal> >& points, const QPainterPath& outline, QGraphicsItem* parent)
+    : UBGraphicsPolygonItem(parent)
+    , mPoints(points)
+    , mOutline(outline)
+{
+    initializeOutline();
+}
+
+UBGraphicsStrokeItem::~UBGraphicsStrokeItem()
+{
+    // NOOP
+}
+
+void UBGraphicsStrokeItem::initializeOutline()
+{
+    mIsNominalLine = false;
+    mOriginalWidth = mPoints.isEmpty() ? -1 : mPoints.first().second;
+
+    QGraphicsPolygonItem::setPolygon(mOutline.toFillPolygon());
+    setFillRule(Qt::WindingFill);
+}
+
+bool UBGraphicsStrokeItem::hasPressure() const
+{
+    foreach(const strokePoint& point, mPoints)
+    {
+        if (!qFuzzyCompare(point.second, mPoints.first().second))
+            return true;
+    }
+
+    return false;
+}
+
+UBItem* UBGraphicsStrokeItem::deepCopy() const
+{
+    // the outline only depends on the points, no need to compute it again
+    UBGraphicsStrokeItem* copy = new UBGraphicsStrokeItem(mPoints, mOutline);
+    copyItemParameters(copy);
+    return copy;
+}
+
+QPainterPath UBGraphicsStrokeItem::shape() const
+{
+    return mOutline;
+}
+
+/**
+ * @brief Build the outline of a stroke from its points and widths
+ *
+ * Strokes with a constant width are outlined by the path stroker, which gives round joints
+ * and caps like the segments drawn on the board. Strokes with pressure are built with
+ * UBGeometryUtils::curveToPolygon, split at sharp angles so that the round ends of the parts
+ * cover the joints (see UBGraphicsStroke::simplify). The resulting path uses the winding
+ * fill rule, so that translucent strokes crossing themselves are painted evenly.
+ */
+QPainterPath UBGraphicsStrokeItem::outline(const QList<QPair<QPointF, qreal> >& points)
+{
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+
+    if (points.size() < 2)
+    {
+        path.addPolygon(UBGeometryUtils::curveToPolygon(points, true, true));
+        return path;
+    }
+
+    bool constantWidth = true;
+
+    foreach(const strokePoint& point, points)
+    {
+        if (!qFuzzyCompare(point.second, points.first().second))
+        {
+            constantWidth = false;
+            break;
+        }
+    }
+
+    if (constantWidth)
+    {
+        QPainterPath centerLine(points.first().first);
+
+        for (int i = 1; i < points.size(); ++i)
+            centerLine.lineTo(points.at(i).first);
+
+        QPainterPathStroker stroker;
+        stroker.setWidth(points.first().second);
+        stroker.setCapStyle(Qt::RoundCap);
+        stroker.setJoinStyle(Qt::RoundJoin);
+
+        QPainterPath strokedPath = stroker.createStroke(centerLine);
+
+        if (!strokedPath.isEmpty())
+        {
+            strokedPath.setFillRule(Qt::WindingFill);
+            return strokedPath;
+        }
+    }
+
+    QList<strokePoint> part;
+
+    for (int i = 0; i < points.size(); ++i)
+    {
+        part << points.at(i);
+
+        if (part.size() > 1 && i < points.size() - 1)
+        {
+            qreal angle = qFabs(UBGeometryUtils::angle(points.at(i-1).first, points.at(i).first, points.at(i+1).first));
+
+            if (angle < 150) // same threshold as UBGraphicsStroke::simplify
+            {
+                path.addPolygon(UBGeometryUtils::curveToPolygon(part, true, true));
+                path.closeSubpath();
+
+                part.clear();
+                part << points.at(i);
+            }
+        }
+    }
+
+    if (part.size() > 1)
+    {
+        path.addPolygon(UBGeometryUtils::curveToPolygon(part, true, true));
+        path.closeSubpath();
+    }
+
+    return path;
+}
+
+/**
+ * @brief Outline of the segment from the point at index to the next one, with round ends
+ *
+ * The outline of the stroke is the union of the outlines of its segments. Unlike the outline
+ * of the whole stroke, which crosses itself at every turn, the outline of a segment is convex.
+ */
+QPolygonF UBGraphicsStrokeItem::segmentPolygon(int index) const
+{
+    const strokePoint& start = mPoints.at(index);
+    const strokePoint& end = mPoints.at(index + 1);
+
+    return UBGeometryUtils::lineToPolygon(QLineF(start.first, end.first), start.second, end.second);
+}
+
+/**
+ * @brief Erase convex polygons from the stroke, segment by segment
+ *
+ * The segments which are not touched are kept as strokes, the others are replaced by the parts
+ * of their outline outside of the erasers. The stroke needs at least two points.
+ *
+ * @param erasers The convex polygons to erase, in item coordinates
+ * @param remainingStrokes The points of the runs of segments which are not touched
+ * @param remainingPolygons The remaining parts of the touched segments
+ * @return false if no segment is touched
+ */
+bool UBGraphicsStrokeItem::erase(const QList<QPolygonF>& erasers, QList<QList<QPair<QPointF, qreal> > >& remainingStrokes, QList<QPolygonF>& remainingPolygons) const
+{
+    QRectF eraserRect;
+
+    foreach(const QPolygonF& eraser, erasers)
+        eraserRect |= eraser.boundingRect();
+
+    QList<strokePoint> run;
+    bool intersected = false;
+
+    remainingStrokes.clear();
+    remainingPolygons.clear();
+
+    for (int i = 0; i < mPoints.size() - 1; ++i)
+    {
+        const strokePoint& start = mPoints.at(i);
+        const strokePoint& end = mPoints.at(i + 1);
+        const qreal margin = qMax(start.second, end.second) / 2;
+        const QRectF segmentRect = QRectF(start.first, end.first).normalized().adjusted(-margin, -margin, margin, margin);
+
+        QList<QPolygonF> parts;
+
+        // the round ends are part of both neighbouring segments, a segment is therefore only kept if its ends are not touched
+        if (!segmentRect.intersects(eraserRect) || !UBGeometryUtils::subtractConvexPolygons(segmentPolygon(i), erasers, parts))
+        {
+            if (run.isEmpty())
+                run << start;
+
+            run << end;
+            continue;
+        }
+
+        intersected = true;
+        remainingPolygons << parts;
+
+        if (!run.isEmpty())
+        {
+            remainingStrokes << run;
+            run.clear();
+        }
+    }
+
+    if (!intersected)
+        return false;
+
+    if (!run.isEmpty())
+        remainingStrokes << run;
+
+    return true;
+}
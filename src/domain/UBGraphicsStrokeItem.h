@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "UBGraphicsPolygonItem.h"
+
+/**
+ * @brief A complete freehand stroke represented by a single graphics item.
+ *
+ * The item keeps the list of points and widths of the stroke and renders its outline
+ * as one polygon, instead of using one UBGraphicsPolygonItem per segment. It keeps the
+ * type of a polygon item, so that the eraser, undo and recoloring code can handle it
+ * like any other polygon. Erasing a part of the stroke replaces the item by stroke
+ * items for the untouched segments and plain polygon items for the erased ones, the
+ * outline of a stroke item is therefore never modified.
+ */
+class UBGraphicsStrokeItem : public UBGraphicsPolygonItem
+{
+public:
+    UBGraphicsStrokeItem(const QList<QPair<QPointF, qreal> >& points, QGraphicsItem* parent = nullptr);
+    virtual ~UBGraphicsStrokeItem();
+
+    const QList<QPair<QPointF, qreal> >& points() const
+    {
+        return mPoints;
+    }
+
+    bool hasPressure() const;
+
+    virtual UBItem* deepCopy() const;
+
+    virtual QPainterPath shape() const;
+
+    static QPainterPath outline(const QList<QPair<QPointF, qreal> >& points);
+
+    QPolygonF segmentPolygon(int index) const;
+
+    bool erase(const QList<QPolygonF>& erasers, QList<QList<QPair<QPointF, qreal> > >& remainingStrokes, QList<QPolygonF>& remainingPolygons) const;
+
+private:
+    UBGraphicsStrokeItem(const QList<QPair<QPointF, qreal> >& points, const QPainterPath& outline, QGraphicsItem* parent = nullptr);
+
+    void initializeOutline();
+
+    QList<QPair<QPointF, qreal> > mPoints;
+    QPainterPath mOutline;
+};
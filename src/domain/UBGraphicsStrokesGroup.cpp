@@ -32,6 +32,8 @@
 
 #include "domain/UBGraphicsPolygonItem.h"
 
+#include "frameworks/UBCoreGraphicsScene.h"
+
 #include "core/memcheck.h"
 
 UBGraphicsStrokesGroup::UBGraphicsStrokesGroup(QGraphicsItem *parent)
@@ -61,7 +63,7 @@ UBGraphicsStrokesGroup::~UBGraphicsStrokesGroup()
 void UBGraphicsStrokesGroup::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 void UBGraphicsStrokesGroup::setColor(const QColor &color, colorType pColorType)
@@ -233,7 +233,7 @@ UBGraphicsPixmapItem* UBGraphicsSvgItem::toPixmapItem() const
 void UBGraphicsSvgItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 
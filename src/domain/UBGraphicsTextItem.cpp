@@ -491,7 +491,7 @@ QSizeF UBGraphicsTextItem::size() const
 void UBGraphicsTextItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 
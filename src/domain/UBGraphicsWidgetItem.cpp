@@ -399,7 +399,7 @@ void UBGraphicsWidgetItem::clearSource()
 void UBGraphicsWidgetItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 QSize UBGraphicsWidgetItem::nominalSize() const
@@ -1003,7 +1003,7 @@ UBGraphicsAppleWidgetItem::~UBGraphicsAppleWidgetItem()
 void UBGraphicsAppleWidgetItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 UBItem* UBGraphicsAppleWidgetItem::deepCopy() const
@@ -1194,7 +1194,7 @@ UBGraphicsW3CWidgetItem::~UBGraphicsW3CWidgetItem()
 void UBGraphicsW3CWidgetItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 UBItem* UBGraphicsW3CWidgetItem::deepCopy() const
@@ -41,6 +41,7 @@
 #include "domain/UBGraphicsScene.h"
 #include "tools/UBGraphicsCurtainItem.h"
 #include "domain/UBGraphicsItemDelegate.h"
+#include "frameworks/UBCoreGraphicsScene.h"
 
 UBItem::UBItem()
     : mUuid(QUuid::createUuid())
@@ -51,7 +52,7 @@ UBItem::UBItem()
 
 UBItem::~UBItem()
 {
-    // NOOP
+    UBCoreGraphicsScene::itemDestroyed(this);
 }
 
 UBGraphicsItem::~UBGraphicsItem()
@@ -36,6 +36,7 @@
 
 class UBGraphicsScene;
 class UBGraphicsItem;
+class UBCoreGraphicsScene;
 
 class UBItem
 {
@@ -111,6 +112,13 @@ class UBItem
         QUrl mSourceUrl;
 
         CacheBehavior mCacheBehavior;
+
+    private:
+        friend class UBCoreGraphicsScene;
+
+        // scene whose uuid index holds the item and the uuid it is indexed by
+        UBCoreGraphicsScene* mIndexScene{nullptr};
+        QUuid mIndexUuid;
 };
 
 class UBGraphicsItem
@@ -212,7 +212,7 @@ void UBSelectionFrame::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
         }
         else if (mOperationMode == om_rotating)
         {
-            qreal step = UBSettings::settings()->rotationAngleStep->get().toReal();
+            qreal step = UBSettings::settings()->rotationAngleStep->value();
             qreal snappedAngle = qRound(mCursorRotationAngle / step) * step;
             dAngle = mItemRotationAngle - snappedAngle;
             mItemRotationAngle = std::fmod(snappedAngle + 360., 360.);
@@ -22,32 +22,50 @@
 
 #include "UBBackgroundLoader.h"
 
-#include <QFile>
+#include <QImageReader>
+#include <QtConcurrent>
 
 #include "core/UBApplication.h"
 
 UBBackgroundLoader::UBBackgroundLoader(QObject* parent)
-    : QThread{parent}
+    : UBBackgroundLoader{{}, 0, parent}
 {
 }
 
-UBBackgroundLoader::UBBackgroundLoader(QList<std::pair<int, QString>> paths, QObject* parent)
+/**
+ * @brief Create a loader decoding the images at the given paths.
+ *
+ * The images are decoded on a small pool of worker threads. If a target width is given, larger
+ * images are decoded directly at that width, which lets the JPEG decoder skip most of the work.
+ *
+ * @param paths List of index and file path pairs.
+ * @param targetWidth Maximum width of the decoded images, 0 to keep the original size.
+ */
+UBBackgroundLoader::UBBackgroundLoader(QList<std::pair<int, QString>> paths, int targetWidth, QObject* parent)
     : QThread{parent}
+    , mTargetWidth{targetWidth}
 {
     mPaths.insert(mPaths.cend(), paths.constBegin(), paths.constEnd());
     mPathCounter.release(paths.size());
+
+    // leave one core to the GUI thread
+    mDecoderPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
+
+    // limit the number of decoded images waiting to be taken
+    mDecoderSlots.release(2 * mDecoderPool.maxThreadCount());
 }
 
 UBBackgroundLoader::~UBBackgroundLoader()
 {
     abort();
     wait();
+    mDecoderPool.waitForDone();
 }
 
 bool UBBackgroundLoader::isIdle()
 {
     QMutexLocker lock{&mMutex};
-    return mPaths.empty() && mResults.empty();
+    return mPaths.empty() && mResults.empty() && mDecoding == 0;
 }
 
 bool UBBackgroundLoader::isResultAvailable()
@@ -56,7 +74,7 @@ bool UBBackgroundLoader::isResultAvailable()
     return !mResults.empty();
 }
 
-std::pair<int, QByteArray> UBBackgroundLoader::takeResult()
+std::pair<int, QImage> UBBackgroundLoader::takeResult()
 {
     QMutexLocker lock{&mMutex};
 
@@ -67,6 +85,7 @@ std::pair<int, QByteArray> UBBackgroundLoader::takeResult()
 
     const auto result = mResults.front();
     mResults.pop_front();
+    mDecoderSlots.release();
     return result;
 }
 
@@ -87,6 +106,8 @@ void UBBackgroundLoader::abort()
 {
     mRunning = false;
     mPathCounter.release();
+    mDecoderSlots.release();
+    mDecoderPool.clear();
 }
 
 void UBBackgroundLoader::run()
@@ -94,6 +115,7 @@ void UBBackgroundLoader::run()
     while (mRunning && !UBApplication::isClosing)
     {
         mPathCounter.acquire();
+        mDecoderSlots.acquire();
 
         if (mRunning && !UBApplication::isClosing)
         {
@@ -103,25 +125,39 @@ void UBBackgroundLoader::run()
                 QMutexLocker lock{&mMutex};
                 path = mPaths.front();
                 mPaths.pop_front();
+                ++mDecoding;
             }
 
-            QFile file{path.second};
-            QByteArray result;
+            QtConcurrent::run(&mDecoderPool, [this, path]() { decode(path); });
+        }
+    }
 
-            if (file.open(QFile::ReadOnly))
-            {
-                result = file.readAll();
-                file.close();
-            }
+    quit();
+}
 
-            {
-                QMutexLocker lock{&mMutex};
-                mResults.push_back({path.first, result});
-            }
+void UBBackgroundLoader::decode(const std::pair<int, QString>& path)
+{
+    QImage image;
+
+    if (mRunning && !UBApplication::isClosing)
+    {
+        QImageReader reader{path.second};
+        const auto size = reader.size();
 
-            emit resultAvailable(path.first, result);
+        if (mTargetWidth > 0 && size.width() > mTargetWidth)
+        {
+            // decoding at a reduced size is much cheaper than scaling the decoded image
+            reader.setScaledSize({mTargetWidth, qMax(1, size.height() * mTargetWidth / size.width())});
         }
+
+        image = reader.read();
     }
 
-    quit();
+    {
+        QMutexLocker lock{&mMutex};
+        mResults.push_back({path.first, image});
+        --mDecoding;
+    }
+
+    emit resultAvailable(path.first, image);
 }
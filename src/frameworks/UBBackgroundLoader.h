@@ -22,10 +22,13 @@
 
 #pragma once
 
+#include <QImage>
 #include <QMutex>
 #include <QObject>
 #include <QSemaphore>
 #include <QThread>
+#include <QThreadPool>
+#include <atomic>
 #include <deque>
 
 class UBBackgroundLoader : public QThread
@@ -34,12 +37,12 @@ class UBBackgroundLoader : public QThread
 
 public:
     explicit UBBackgroundLoader(QObject* parent = nullptr);
-    UBBackgroundLoader(QList<std::pair<int, QString>> paths, QObject* parent = nullptr);
+    UBBackgroundLoader(QList<std::pair<int, QString>> paths, int targetWidth = 0, QObject* parent = nullptr);
     virtual ~UBBackgroundLoader();
 
     bool isIdle();
     bool isResultAvailable();
-    std::pair<int, QByteArray> takeResult();
+    std::pair<int, QImage> takeResult();
 
 public slots:
     void start();
@@ -47,15 +50,22 @@ public slots:
     void abort();
 
 signals:
-    void resultAvailable(int index, QByteArray data);
+    void resultAvailable(int index, QImage image);
 
 protected:
     void run() override;
 
+private:
+    void decode(const std::pair<int, QString>& path);
+
 private:
     std::deque<std::pair<int, QString>> mPaths{};
-    std::deque<std::pair<int, QByteArray>> mResults{};
+    std::deque<std::pair<int, QImage>> mResults{};
     QMutex mMutex{};
     QSemaphore mPathCounter{};
-    bool mRunning{false};
+    QSemaphore mDecoderSlots{};
+    QThreadPool mDecoderPool{};
+    int mDecoding{0};
+    int mTargetWidth{0};
+    std::atomic<bool> mRunning{false};
 };
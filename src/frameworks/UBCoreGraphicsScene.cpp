@@ -29,9 +29,12 @@
 
 #include "UBCoreGraphicsScene.h"
 
+#include "core/UB.h"
+
 #include "domain/UBGraphicsMediaItem.h"
 #include "domain/UBGraphicsWidgetItem.h"
 #include "domain/UBGraphicsGroupContainerItem.h"
+#include "domain/UBItem.h"
 
 #include "core/memcheck.h"
 
@@ -39,11 +42,18 @@ UBCoreGraphicsScene::UBCoreGraphicsScene(QObject * parent)
     : QGraphicsScene ( parent  )
     , mIsModified(false)
 {
-    //NOOP
 }
 
 UBCoreGraphicsScene::~UBCoreGraphicsScene()
 {
+    // the index is destroyed with the scene, deleted items do not need to update it
+    for (const IndexedItem& indexedItem : std::as_const(mItemsByUuid))
+    {
+        indexedItem.ubItem->mIndexScene = nullptr;
+    }
+
+    mItemsByUuid.clear();
+
     //we must delete removed items that are no more in any scene
     //at groups deleting some items can be added to mItemsToDelete, so we need to use iterators.
     foreach(QGraphicsItem* item, mItemsToDelete)
@@ -72,11 +82,14 @@ void UBCoreGraphicsScene::addItem(QGraphicsItem* item)
 
     if (item->scene() != this)
         QGraphicsScene::addItem(item);
+
+    indexItem(item);
 }
 
 
 void UBCoreGraphicsScene::removeItem(QGraphicsItem* item, bool forceDelete)
 {
+    unindexItem(item);
     QGraphicsScene::removeItem(item);
     if (forceDelete)
     {
@@ -92,6 +105,7 @@ bool UBCoreGraphicsScene::deleteItem(QGraphicsItem* item)
         if (item_casted != NULL)
             item_casted->clearSource();
 
+        unindexItem(item);
         mItemsToDelete.remove(item);
         delete item;
         item = NULL;
@@ -114,3 +128,157 @@ void UBCoreGraphicsScene::addItemToDeletion(QGraphicsItem *item)
         mItemsToDelete.insert(item);
     }
 }
+
+/**
+ * @brief Find an item of the scene by its uuid
+ *
+ * The index is updated when an item enters or leaves the scene, when its uuid changes and
+ * when it is destroyed. An uuid which is not in the index is not in the scene, e.g. a stroke
+ * which is only part of a group in the file, so a miss does not require to scan the scene.
+ */
+QGraphicsItem* UBCoreGraphicsScene::itemForUuid(const QUuid& uuid)
+{
+    if (uuid.isNull())
+    {
+        return nullptr;
+    }
+
+    auto it = mItemsByUuid.constFind(uuid);
+
+    // items without hook may have been removed by QGraphicsScene::removeItem
+    if (it == mItemsByUuid.constEnd() || it->item->scene() != this)
+    {
+        return nullptr;
+    }
+
+    return it->item;
+}
+
+/**
+ * @brief Set the uuid of an item, to be called by the setUuid functions of the items
+ */
+void UBCoreGraphicsScene::setItemUuid(QGraphicsItem* item, const QUuid& uuid)
+{
+    UBCoreGraphicsScene* scene = dynamic_cast<UBCoreGraphicsScene*>(item->scene());
+
+    if (scene)
+    {
+        scene->removeUuid(item, item->data(UBGraphicsItemData::ItemUuid).toUuid());
+    }
+
+    item->setData(UBGraphicsItemData::ItemUuid, QVariant(uuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+
+    if (scene)
+    {
+        scene->insertUuid(item);
+    }
+}
+
+/**
+ * @brief Move an item to the index of its new scene, to be called on QGraphicsItem::ItemSceneChange
+ *
+ * QGraphicsScene notifies the children separately, so only the item itself is moved.
+ */
+void UBCoreGraphicsScene::itemSceneChange(QGraphicsItem* item, const QVariant& newScene)
+{
+    UBCoreGraphicsScene* oldIndex = dynamic_cast<UBCoreGraphicsScene*>(item->scene());
+    UBCoreGraphicsScene* newIndex = dynamic_cast<UBCoreGraphicsScene*>(newScene.value<QGraphicsScene*>());
+
+    if (oldIndex == newIndex)
+    {
+        return;
+    }
+
+    if (oldIndex)
+    {
+        oldIndex->removeUuid(item, item->data(UBGraphicsItemData::ItemUuid).toUuid());
+    }
+
+    if (newIndex)
+    {
+        newIndex->insertUuid(item);
+    }
+}
+
+/**
+ * @brief Remove a destroyed item from the index, called by the destructor of UBItem
+ *
+ * QGraphicsItem does not notify its scene when it is deleted while being part of it.
+ */
+void UBCoreGraphicsScene::itemDestroyed(UBItem* item)
+{
+    UBCoreGraphicsScene* scene = item->mIndexScene;
+
+    if (!scene)
+    {
+        return;
+    }
+
+    Q_ASSERT(QThread::currentThread() == scene->thread());
+
+    auto it = scene->mItemsByUuid.find(item->mIndexUuid);
+
+    if (it != scene->mItemsByUuid.end() && it->ubItem == item)
+    {
+        scene->mItemsByUuid.erase(it);
+    }
+
+    item->mIndexScene = nullptr;
+}
+
+void UBCoreGraphicsScene::indexItem(QGraphicsItem* item)
+{
+    insertUuid(item);
+
+    foreach(QGraphicsItem* child, item->childItems())
+    {
+        indexItem(child);
+    }
+}
+
+void UBCoreGraphicsScene::unindexItem(QGraphicsItem* item)
+{
+    removeUuid(item, item->data(UBGraphicsItemData::ItemUuid).toUuid());
+
+    foreach(QGraphicsItem* child, item->childItems())
+    {
+        unindexItem(child);
+    }
+}
+
+void UBCoreGraphicsScene::insertUuid(QGraphicsItem* item)
+{
+    // only UBItems remove themselves from the index when they are destroyed
+    UBItem* ubItem = dynamic_cast<UBItem*>(item);
+    const QUuid uuid = item->data(UBGraphicsItemData::ItemUuid).toUuid();
+
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (ubItem && !uuid.isNull())
+    {
+        auto it = mItemsByUuid.find(uuid);
+
+        // an item with the same uuid, e.g. a copy which did not get its own uuid yet, leaves the index
+        if (it != mItemsByUuid.end() && it->ubItem != ubItem)
+        {
+            it->ubItem->mIndexScene = nullptr;
+        }
+
+        mItemsByUuid.insert(uuid, {item, ubItem});
+        ubItem->mIndexScene = this;
+        ubItem->mIndexUuid = uuid;
+    }
+}
+
+void UBCoreGraphicsScene::removeUuid(QGraphicsItem* item, const QUuid& uuid)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto it = mItemsByUuid.find(uuid);
+
+    if (it != mItemsByUuid.end() && it->item == item)
+    {
+        it->ubItem->mIndexScene = nullptr;
+        mItemsByUuid.erase(it);
+    }
+}
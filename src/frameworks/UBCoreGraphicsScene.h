@@ -33,6 +33,9 @@
 #include <QtGui>
 #include <QGraphicsScene>
 #include <QGraphicsItem>
+#include <QUuid>
+
+class UBItem;
 
 class UBCoreGraphicsScene : public QGraphicsScene
 {
@@ -49,6 +52,12 @@ class UBCoreGraphicsScene : public QGraphicsScene
         void removeItemFromDeletion(QGraphicsItem* item);
         void addItemToDeletion(QGraphicsItem *item);
 
+        QGraphicsItem* itemForUuid(const QUuid& uuid);
+
+        static void setItemUuid(QGraphicsItem* item, const QUuid& uuid);
+        static void itemSceneChange(QGraphicsItem* item, const QVariant& newScene);
+        static void itemDestroyed(UBItem* item);
+
         bool isModified() const
         {
             return mIsModified;
@@ -57,13 +66,40 @@ class UBCoreGraphicsScene : public QGraphicsScene
         void setModified(bool pModified)
         {
             mIsModified = pModified;
+
+            if (pModified)
+            {
+                ++mModificationCount;
+            }
+        }
+
+        // counts the modifications, unlike isModified it is not reset when the scene is saved
+        quint64 modificationCount() const
+        {
+            return mModificationCount;
         }
 
 
     private:
+        struct IndexedItem
+        {
+            QGraphicsItem* item;
+            UBItem* ubItem;
+        };
+
+        void indexItem(QGraphicsItem* item);
+        void unindexItem(QGraphicsItem* item);
+        void insertUuid(QGraphicsItem* item);
+        void removeUuid(QGraphicsItem* item, const QUuid& uuid);
+
         QSet<QGraphicsItem*> mItemsToDelete;
 
+        // items of the scene by uuid, kept exact by the items when their uuid or scene changes.
+        // The indexed UBItems point back to the scene, so that they leave the index when destroyed
+        QHash<QUuid, IndexedItem> mItemsByUuid;
+
         bool mIsModified;
+        quint64 mModificationCount{0};
 };
 
 #endif /* UBCOREGRAPHICSSCENE_H_ */
@@ -657,7 +657,7 @@ QString UBFileSystemUtils::getFirstExistingFileFromList(const QString& path, con
 }
 
 
-bool UBFileSystemUtils::compressDirInZip(const QDir& pDir, const QString& pDestPath, QuaZipFile *pOutZipFile, bool pRootDocumentFolder, UBProcessingProgressListener* progressListener)
+bool UBFileSystemUtils::compressDirInZip(const QDir& pDir, const QString& pDestPath, QuaZipFile *pOutZipFile, bool pRootDocumentFolder, UBProcessingProgressListener* progressListener, const QMap<QString, QString>& pRenamedFiles)
 {
     QFileInfoList files = pDir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
 
@@ -678,6 +678,13 @@ bool UBFileSystemUtils::compressDirInZip(const QDir& pDir, const QString& pDestP
 
         if (file.isFile())
         {
+            const QString zipFileName = pRenamedFiles.value(file.fileName(), file.fileName());
+
+            if (zipFileName.isEmpty())
+            {
+                continue;
+            }
+
             QString objectType;
             if (pRootDocumentFolder)
             {
@@ -706,9 +713,9 @@ bool UBFileSystemUtils::compressDirInZip(const QDir& pDir, const QString& pDestP
                 return false;
             }
 
-            qDebug() << "will open" << pDestPath << file.fileName() << inFile.fileName();
+            qDebug() << "will open" << pDestPath << zipFileName << inFile.fileName();
 
-            if(!pOutZipFile->open(QIODevice::WriteOnly, QuaZipNewInfo(pDestPath + file.fileName(), inFile.fileName())))
+            if(!pOutZipFile->open(QIODevice::WriteOnly, QuaZipNewInfo(pDestPath + zipFileName, inFile.fileName())))
             {
                 qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: outFile.open(): " << pOutZipFile->getZipError();
                 inFile.close();
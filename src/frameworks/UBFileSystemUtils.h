@@ -101,10 +101,12 @@ class UBFileSystemUtils : public QObject
          * @arg pDestPath the path inside the zip. Attention, if path is not empty it must end by a /.
          * @arg pOutZipFile the zip file we want to populate with the directory
          * @arg UBProcessingProgressListener an object listening to the compression progress
+         * @arg pRenamedFiles names inside the zip of files directly in pDir, files renamed to an empty name are skipped
          * @return bool. true if compression is successful.
          */
         static bool compressDirInZip(const QDir& pDir, const QString& pDestDir, QuaZipFile *pOutZipFile
-                        , bool pRootDocumentFolder, UBProcessingProgressListener* progressListener = 0);
+                        , bool pRootDocumentFolder, UBProcessingProgressListener* progressListener = 0
+                        , const QMap<QString, QString>& pRenamedFiles = QMap<QString, QString>());
 
         static bool expandZipToDir(const QFile& pZipFile, const QDir& pTargetDir);
 
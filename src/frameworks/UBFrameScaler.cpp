@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "UBFrameScaler.h"
+
+#include <QtConcurrent>
+
+#include "core/memcheck.h"
+
+UBFrameScaler::UBFrameScaler(QObject* parent)
+    : QObject(parent)
+{
+}
+
+UBFrameScaler::~UBFrameScaler()
+{
+    {
+        QMutexLocker lock(&mMutex);
+        mSubmitted = QImage();
+    }
+
+    mFuture.waitForFinished();
+}
+
+void UBFrameScaler::setTargetSize(const QSize& size, qreal devicePixelRatio)
+{
+    QMutexLocker lock(&mMutex);
+    mTargetSize = size;
+    mDevicePixelRatio = devicePixelRatio;
+}
+
+/**
+ * @brief Scale a frame on the calling thread.
+ *
+ * The frame data is only read during the call, so a streaming thread can hand out its
+ * mapped buffer without copying it first.
+ */
+void UBFrameScaler::scale(const uchar* data, int width, int height, int stride, QImage::Format format, bool swapRgb)
+{
+    QSize targetSize;
+    qreal devicePixelRatio;
+
+    {
+        QMutexLocker lock(&mMutex);
+        targetSize = QSize(width, height).scaled(mTargetSize, Qt::KeepAspectRatio);
+        devicePixelRatio = mDevicePixelRatio;
+    }
+
+    if (targetSize.isEmpty())
+    {
+        return;
+    }
+
+    int bytesPerPixel = 4;
+    int red, green, blue;
+
+    switch (format)
+    {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        // 0xAARRGGBB in native byte order
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        red = 2; green = 1; blue = 0;
+#else
+        red = 1; green = 2; blue = 3;
+#endif
+        break;
+
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        red = 0; green = 1; blue = 2;
+        break;
+
+    case QImage::Format_RGB888:
+        bytesPerPixel = 3;
+        red = 0; green = 1; blue = 2;
+        break;
+
+    default:
+        {
+            const QImage converted = QImage(data, width, height, stride, format).convertToFormat(QImage::Format_RGB32);
+            scale(converted.constBits(), width, height, converted.bytesPerLine(), converted.format(), swapRgb);
+        }
+        return;
+    }
+
+    if (swapRgb)
+    {
+        std::swap(red, blue);
+    }
+
+    QMutexLocker lock(&mScaleMutex);
+
+    if (targetSize.width() > width || targetSize.height() > height)
+    {
+        // the box filter only reduces, enlarging is rare enough to afford an allocation
+        QImage source(data, width, height, stride, format);
+
+        if (swapRgb)
+        {
+            source = source.rgbSwapped();
+        }
+
+        mBack = source.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGB32);
+    }
+    else
+    {
+        if (mBack.size() != targetSize || mBack.format() != QImage::Format_RGB32)
+        {
+            mBack = QImage(targetSize, QImage::Format_RGB32);
+        }
+
+        boxFilter(data, width, height, stride, bytesPerPixel, red, green, blue);
+    }
+
+    mBack.setDevicePixelRatio(devicePixelRatio);
+    publish();
+}
+
+/**
+ * @brief Scale a frame on the thread pool.
+ *
+ * If a previously submitted frame is still waiting, it is replaced.
+ */
+void UBFrameScaler::submit(const QImage& image)
+{
+    QMutexLocker lock(&mMutex);
+    mSubmitted = image;
+
+    if (!mScaling)
+    {
+        mScaling = true;
+        mFuture = QtConcurrent::run([this](){
+            scaleSubmittedFrames();
+        });
+    }
+}
+
+/**
+ * @brief Take the most recent scaled frame.
+ *
+ * The returned image stays valid until the next call of takeFrame or clear.
+ */
+const QImage& UBFrameScaler::takeFrame()
+{
+    QMutexLocker lock(&mMutex);
+
+    if (mHasPending)
+    {
+        std::swap(mPending, mFront);
+        mHasPending = false;
+    }
+
+    return mFront;
+}
+
+void UBFrameScaler::clear()
+{
+    QMutexLocker lock(&mMutex);
+    mSubmitted = QImage();
+    mHasPending = false;
+    mFront = QImage();
+}
+
+void UBFrameScaler::scaleSubmittedFrames()
+{
+    forever
+    {
+        QImage image;
+
+        {
+            QMutexLocker lock(&mMutex);
+
+            if (mSubmitted.isNull())
+            {
+                mScaling = false;
+                return;
+            }
+
+            std::swap(image, mSubmitted);
+        }
+
+        scale(image.constBits(), image.width(), image.height(), image.bytesPerLine(), image.format());
+    }
+}
+
+/**
+ * Average the source pixels covered by each target pixel into mBack.
+ * The target size must not exceed the source size.
+ */
+void UBFrameScaler::boxFilter(const uchar* data, int width, int height, int stride, int bytesPerPixel, int red, int green, int blue)
+{
+    const int targetWidth = mBack.width();
+    const int targetHeight = mBack.height();
+
+    mColumns.resize(targetWidth + 1);
+
+    for (int x = 0; x <= targetWidth; ++x)
+    {
+        mColumns[x] = int(qint64(x) * width / targetWidth) * bytesPerPixel;
+    }
+
+    mSums.resize(targetWidth * 3);
+
+    for (int y = 0; y < targetHeight; ++y)
+    {
+        const int firstRow = int(qint64(y) * height / targetHeight);
+        const int lastRow = qMax(firstRow + 1, int(qint64(y + 1) * height / targetHeight));
+
+        std::fill(mSums.begin(), mSums.end(), 0);
+
+        for (int row = firstRow; row < lastRow; ++row)
+        {
+            const uchar* line = data + qint64(row) * stride;
+            quint32* sum = mSums.data();
+
+            for (int x = 0; x < targetWidth; ++x, sum += 3)
+            {
+                const uchar* pixel = line + mColumns[x];
+                const uchar* end = line + qMax(mColumns[x] + bytesPerPixel, mColumns[x + 1]);
+
+                for (; pixel < end; pixel += bytesPerPixel)
+                {
+                    sum[0] += pixel[red];
+                    sum[1] += pixel[green];
+                    sum[2] += pixel[blue];
+                }
+            }
+        }
+
+        QRgb* target = reinterpret_cast<QRgb*>(mBack.scanLine(y));
+        const quint32* sum = mSums.constData();
+
+        for (int x = 0; x < targetWidth; ++x, sum += 3)
+        {
+            const quint32 count = (lastRow - firstRow) * qMax(1, (mColumns[x + 1] - mColumns[x]) / bytesPerPixel);
+            target[x] = qRgb((sum[0] + count / 2) / count, (sum[1] + count / 2) / count, (sum[2] + count / 2) / count);
+        }
+    }
+}
+
+void UBFrameScaler::publish()
+{
+    bool notify;
+
+    {
+        QMutexLocker lock(&mMutex);
+        std::swap(mBack, mPending);
+        notify = !mHasPending;
+        mHasPending = true;
+    }
+
+    // a single notification until the frame is taken
+    if (notify)
+    {
+        emit frameReady();
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#pragma once
+
+#include <QFuture>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+
+/**
+ * @brief Scale video frames to a target size, outside of the GUI thread.
+ *
+ * Frames are either scaled synchronously with scale(), e.g. on a streaming thread which
+ * owns the frame buffer, or submitted from the GUI thread with submit() and scaled on
+ * the global thread pool. Only the most recent submitted frame is kept when frames
+ * arrive faster than they can be scaled.
+ *
+ * Downscaling uses a box filter writing directly from the source buffer to one of three
+ * preallocated RGB32 buffers, which are reused as long as the target size does not change.
+ * frameReady() is emitted when a new frame can be taken with takeFrame().
+ */
+class UBFrameScaler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UBFrameScaler(QObject* parent = nullptr);
+    virtual ~UBFrameScaler();
+
+    void setTargetSize(const QSize& size, qreal devicePixelRatio = 1.);
+
+    void scale(const uchar* data, int width, int height, int stride, QImage::Format format, bool swapRgb = false);
+    void submit(const QImage& image);
+
+    // GUI thread only
+    const QImage& takeFrame();
+    void clear();
+
+signals:
+    void frameReady();
+
+private:
+    void scaleSubmittedFrames();
+    void boxFilter(const uchar* data, int width, int height, int stride, int bytesPerPixel, int red, int green, int blue);
+    void publish();
+
+    QMutex mMutex;
+    QSize mTargetSize;
+    qreal mDevicePixelRatio{1.};
+    QImage mSubmitted;
+    bool mScaling{false};
+    QFuture<void> mFuture;
+
+    // the back buffer and scratch data are only used by the scaling thread
+    QMutex mScaleMutex;
+    QImage mBack;
+    QVector<int> mColumns;
+    QVector<quint32> mSums;
+
+    // guarded by mMutex
+    QImage mPending;
+    bool mHasPending{false};
+
+    QImage mFront;
+};
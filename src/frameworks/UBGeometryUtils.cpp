@@ -29,6 +29,9 @@
 
 #include "UBGeometryUtils.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "core/memcheck.h"
 
 const double PI = 4.0 * atan(1.0);
@@ -467,3 +470,471 @@ QList<QPointF> UBGeometryUtils::quadraticBezier(const QPointF& p0, const QPointF
 
     return points;
 }
+
+
+
+namespace
+{
+    // tolerance for the parameters along the edges, relative to their length
+    const qreal parameterTolerance = 1e-9;
+
+    struct Crossing
+    {
+        QPointF point;
+        int subjectEdge;
+        qreal subjectParameter;
+        int clipEdge;
+        qreal clipParameter;
+        bool entering;
+        bool visited;
+    };
+
+    qreal crossProduct(const QPointF& a, const QPointF& b)
+    {
+        return a.x() * b.y() - a.y() * b.x();
+    }
+
+    qreal signedArea(const QPolygonF& polygon)
+    {
+        qreal area = 0;
+
+        for (int i = 0; i < polygon.size(); ++i)
+            area += crossProduct(polygon.at(i), polygon.at((i + 1) % polygon.size()));
+
+        return area / 2;
+    }
+
+    // remove repeated points and the closing point of the polygon
+    QPolygonF openPolygon(const QPolygonF& polygon)
+    {
+        QPolygonF result;
+        result.reserve(polygon.size());
+
+        for (const QPointF& point : polygon)
+        {
+            if (result.isEmpty() || result.last() != point)
+                result << point;
+        }
+
+        while (result.size() > 1 && result.first() == result.last())
+            result.removeLast();
+
+        return result;
+    }
+
+    // polygon must be counterclockwise
+    bool isConvex(const QPolygonF& polygon)
+    {
+        const int n = polygon.size();
+
+        for (int i = 0; i < n; ++i)
+        {
+            const QPointF e1 = polygon.at((i + 1) % n) - polygon.at(i);
+            const QPointF e2 = polygon.at((i + 2) % n) - polygon.at((i + 1) % n);
+
+            if (crossProduct(e1, e2) < -parameterTolerance * qSqrt(QPointF::dotProduct(e1, e1) * QPointF::dotProduct(e2, e2)))
+                return false;
+        }
+
+        return true;
+    }
+
+    // polygon must be counterclockwise and convex, points on the border are not inside
+    bool isInsideConvex(const QPolygonF& polygon, const QPointF& point)
+    {
+        const int n = polygon.size();
+
+        for (int i = 0; i < n; ++i)
+        {
+            if (crossProduct(polygon.at((i + 1) % n) - polygon.at(i), point - polygon.at(i)) <= 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    int orientation(const QPointF& a, const QPointF& b, const QPointF& c)
+    {
+        const qreal value = crossProduct(b - a, c - a);
+        return value > 0 ? 1 : (value < 0 ? -1 : 0);
+    }
+
+    bool onSegment(const QPointF& a, const QPointF& b, const QPointF& p)
+    {
+        return qMin(a.x(), b.x()) <= p.x() && p.x() <= qMax(a.x(), b.x())
+            && qMin(a.y(), b.y()) <= p.y() && p.y() <= qMax(a.y(), b.y());
+    }
+
+    // closed segments, touching counts as intersecting
+    bool segmentsIntersect(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d)
+    {
+        const int o1 = orientation(a, b, c);
+        const int o2 = orientation(a, b, d);
+        const int o3 = orientation(c, d, a);
+        const int o4 = orientation(c, d, b);
+
+        if (o1 != o2 && o3 != o4)
+            return true;
+
+        return (o1 == 0 && onSegment(a, b, c))
+            || (o2 == 0 && onSegment(a, b, d))
+            || (o3 == 0 && onSegment(c, d, a))
+            || (o4 == 0 && onSegment(c, d, b));
+    }
+}
+
+namespace
+{
+    // Weiler-Atherton clipping of a convex subject, the borders touching at a vertex and a clip
+    // polygon making a hole in the subject are reported as Unsupported
+    UBGeometryUtils::SubtractionResult followCrossings(const QPolygonF& s, const QPolygonF& c, QList<QPolygonF>& result)
+    {
+        const QRectF clipRect = c.boundingRect();
+        const int n = s.size();
+        const int m = c.size();
+        QVector<Crossing> crossings;
+
+        for (int i = 0; i < n; ++i)
+        {
+            const QPointF a = s.at(i);
+            const QPointF d = s.at((i + 1) % n) - a;
+
+            if (qMax(a.x(), a.x() + d.x()) < clipRect.left() || qMin(a.x(), a.x() + d.x()) > clipRect.right()
+                    || qMax(a.y(), a.y() + d.y()) < clipRect.top() || qMin(a.y(), a.y() + d.y()) > clipRect.bottom())
+                continue;
+
+            for (int j = 0; j < m; ++j)
+            {
+                const QPointF p = c.at(j);
+                const QPointF e = c.at((j + 1) % m) - p;
+                const qreal denominator = crossProduct(d, e);
+                const qreal lengths = qSqrt(QPointF::dotProduct(d, d) * QPointF::dotProduct(e, e));
+
+                if (qAbs(denominator) <= parameterTolerance * lengths)
+                {
+                    // parallel edges, overlapping ones are not supported
+                    if (qAbs(crossProduct(p - a, d)) <= parameterTolerance * lengths
+                            && segmentsIntersect(a, a + d, p, p + e))
+                        return UBGeometryUtils::Unsupported;
+
+                    continue;
+                }
+
+                const qreal t = crossProduct(p - a, e) / denominator;
+                const qreal u = crossProduct(p - a, d) / denominator;
+
+                if (t < -parameterTolerance || t > 1 + parameterTolerance || u < -parameterTolerance || u > 1 + parameterTolerance)
+                    continue;
+
+                // the borders touch at a vertex
+                if (t < parameterTolerance || t > 1 - parameterTolerance || u < parameterTolerance || u > 1 - parameterTolerance)
+                    return UBGeometryUtils::Unsupported;
+
+                crossings << Crossing{a + t * d, i, t, j, u, crossProduct(e, d) > 0, false};
+            }
+        }
+
+        result.clear();
+
+        if (crossings.isEmpty())
+        {
+            if (isInsideConvex(c, s.first()))
+                return UBGeometryUtils::Subtracted;
+
+            if (s.containsPoint(c.first(), Qt::OddEvenFill))
+                return UBGeometryUtils::Unsupported;
+
+            return UBGeometryUtils::NotIntersecting;
+        }
+
+        const int count = crossings.size();
+
+        if (count % 2 != 0)
+            return UBGeometryUtils::Unsupported;
+
+        // order of the crossings along the subject and along the clip polygon
+        QVector<int> subjectOrder(count);
+        QVector<int> clipOrder(count);
+        std::iota(subjectOrder.begin(), subjectOrder.end(), 0);
+        std::iota(clipOrder.begin(), clipOrder.end(), 0);
+
+        std::sort(subjectOrder.begin(), subjectOrder.end(), [&crossings](int k1, int k2) {
+            const Crossing& c1 = crossings.at(k1);
+            const Crossing& c2 = crossings.at(k2);
+            return c1.subjectEdge < c2.subjectEdge || (c1.subjectEdge == c2.subjectEdge && c1.subjectParameter < c2.subjectParameter);
+        });
+
+        std::sort(clipOrder.begin(), clipOrder.end(), [&crossings](int k1, int k2) {
+            const Crossing& c1 = crossings.at(k1);
+            const Crossing& c2 = crossings.at(k2);
+            return c1.clipEdge < c2.clipEdge || (c1.clipEdge == c2.clipEdge && c1.clipParameter < c2.clipParameter);
+        });
+
+        QVector<int> subjectPosition(count);
+        QVector<int> clipPosition(count);
+
+        for (int k = 0; k < count; ++k)
+        {
+            subjectPosition[subjectOrder.at(k)] = k;
+            clipPosition[clipOrder.at(k)] = k;
+        }
+
+        // entering and leaving crossings must alternate along both borders
+        for (int k = 0; k < count; ++k)
+        {
+            if (crossings.at(subjectOrder.at(k)).entering == crossings.at(subjectOrder.at((k + 1) % count)).entering
+                    || crossings.at(clipOrder.at(k)).entering == crossings.at(clipOrder.at((k + 1) % count)).entering)
+                return UBGeometryUtils::Unsupported;
+        }
+
+        for (int start = 0; start < count; ++start)
+        {
+            if (crossings.at(start).entering || crossings.at(start).visited)
+                continue;
+
+            QPolygonF part;
+            int current = start;
+            int steps = 0;
+
+            do
+            {
+                // follow the subject outside of the clip polygon, up to the next crossing
+                Crossing& leaving = crossings[current];
+                leaving.visited = true;
+                part << leaving.point;
+
+                const int next = subjectOrder.at((subjectPosition.at(current) + 1) % count);
+                Crossing& entering = crossings[next];
+                entering.visited = true;
+
+                int vertices = (entering.subjectEdge - leaving.subjectEdge + n) % n;
+
+                if (vertices == 0 && entering.subjectParameter < leaving.subjectParameter)
+                    vertices = n;
+
+                for (int v = 1; v <= vertices; ++v)
+                    part << s.at((leaving.subjectEdge + v) % n);
+
+                part << entering.point;
+
+                // follow the clip polygon backwards inside of the subject, up to the previous crossing
+                const int previous = clipOrder.at((clipPosition.at(next) - 1 + count) % count);
+                const Crossing& nextLeaving = crossings.at(previous);
+
+                vertices = (entering.clipEdge - nextLeaving.clipEdge + m) % m;
+
+                if (vertices == 0 && nextLeaving.clipParameter > entering.clipParameter)
+                    vertices = m;
+
+                for (int v = 0; v < vertices; ++v)
+                    part << c.at((entering.clipEdge - v + m) % m);
+
+                current = previous;
+            }
+            while (current != start && ++steps < count);
+
+            if (current != start)
+                return UBGeometryUtils::Unsupported;
+
+            result << part;
+        }
+
+        return UBGeometryUtils::Subtracted;
+    }
+
+    // keep the part of the polygon on the left of the line from a to b, or on its right (Sutherland-Hodgman).
+    // The winding number of the points kept does not change, so the polygon may intersect itself
+    QPolygonF clipToHalfPlane(const QPolygonF& polygon, const QPointF& a, const QPointF& b, bool left)
+    {
+        QPolygonF result;
+
+        if (polygon.isEmpty())
+            return result;
+
+        result.reserve(polygon.size() + 2);
+
+        const QPointF direction = b - a;
+
+        auto side = [&direction, &a, left](const QPointF& point) {
+            const qreal value = crossProduct(direction, point - a);
+            return left ? value : -value;
+        };
+
+        QPointF previous = polygon.last();
+        qreal previousSide = side(previous);
+
+        for (const QPointF& current : polygon)
+        {
+            const qreal currentSide = side(current);
+
+            if ((previousSide >= 0) != (currentSide >= 0))
+                result << previous + (current - previous) * (previousSide / (previousSide - currentSide));
+
+            if (currentSide >= 0)
+                result << current;
+
+            previous = current;
+            previousSide = currentSide;
+        }
+
+        return result;
+    }
+
+    // split the outside of the clip polygon in the regions beyond each of its edges and keep the part of
+    // the subject in each of them. The parts are joined in a single polygon, going back to the first
+    // point after each part, so that the joining edges cancel out with both fill rules
+    UBGeometryUtils::SubtractionResult subtractBeyondEdges(const QPolygonF& s, const QPolygonF& c, QList<QPolygonF>& result)
+    {
+        const int m = c.size();
+        QPolygonF inside = s;
+        QPolygonF outside;
+
+        for (int j = 0; j < m && inside.size() >= 3; ++j)
+        {
+            const QPointF a = c.at(j);
+            const QPointF b = c.at((j + 1) % m);
+            const QPolygonF part = clipToHalfPlane(inside, a, b, false);
+
+            if (part.size() >= 3)
+            {
+                if (!outside.isEmpty())
+                    outside << part << part.first() << outside.first();
+                else
+                    outside << part << part.first();
+            }
+
+            inside = clipToHalfPlane(inside, a, b, true);
+        }
+
+        // the signed area of a self-intersecting polygon may cancel out, only the polygons
+        // merely touching the clip polygon are flat
+        const QRectF subjectRect = s.boundingRect();
+        const QRectF insideRect = inside.boundingRect();
+        const qreal tolerance = parameterTolerance * qMax(subjectRect.width(), subjectRect.height());
+
+        if (inside.size() < 3 || insideRect.width() <= tolerance || insideRect.height() <= tolerance)
+            return UBGeometryUtils::NotIntersecting;
+
+        result.clear();
+
+        if (!outside.isEmpty())
+            result << outside;
+
+        return UBGeometryUtils::Subtracted;
+    }
+}
+
+/**
+ * @brief Subtract a convex polygon from a polygon
+ *
+ * This is much faster than the boolean operations of QPainterPath. A convex subject, e.g. the
+ * outline of a stroke segment, is clipped by following the crossings of both borders, which
+ * gives separate simple parts. Any other subject, including the self-intersecting outline of
+ * a whole stroke, is clipped beyond each edge of the clip polygon, which keeps the winding
+ * number of every remaining point. Only a clip polygon which is not convex is Unsupported.
+ *
+ * @param subject The polygon to subtract from
+ * @param convexClip The convex polygon to subtract
+ * @param result The remaining parts of the subject, empty if it is completely covered
+ * @return NotIntersecting if the polygons are disjoint, Subtracted if result is valid
+ */
+UBGeometryUtils::SubtractionResult UBGeometryUtils::subtractConvexPolygon(const QPolygonF& subject, const QPolygonF& convexClip, QList<QPolygonF>& result)
+{
+    QPolygonF s = openPolygon(subject);
+    QPolygonF c = openPolygon(convexClip);
+
+    if (s.size() < 3 || c.size() < 3)
+        return Unsupported;
+
+    // both polygons counterclockwise, the inside is on the left of the edges
+    if (signedArea(s) < 0)
+        std::reverse(s.begin(), s.end());
+
+    if (signedArea(c) < 0)
+        std::reverse(c.begin(), c.end());
+
+    if (!s.boundingRect().intersects(c.boundingRect()))
+        return NotIntersecting;
+
+    if (!isConvex(c))
+        return Unsupported;
+
+    if (isConvex(s))
+    {
+        const SubtractionResult subtracted = followCrossings(s, c, result);
+
+        if (subtracted != Unsupported)
+            return subtracted;
+    }
+
+    return subtractBeyondEdges(s, c, result);
+}
+
+/**
+ * @brief Subtract convex polygons one after the other from a polygon
+ *
+ * The cases subtractConvexPolygon does not handle fall back on the boolean operations of QPainterPath.
+ *
+ * @param subject The polygon to subtract from
+ * @param convexClips The convex polygons to subtract
+ * @param result The remaining parts of the subject, empty if it is completely covered
+ * @return false if the subject does not intersect any of the clip polygons, result is then left empty
+ */
+bool UBGeometryUtils::subtractConvexPolygons(const QPolygonF& subject, const QList<QPolygonF>& convexClips, QList<QPolygonF>& result)
+{
+    QList<QPolygonF> polygons{subject};
+    bool intersected = false;
+
+    result.clear();
+
+    for (const QPolygonF& convexClip : convexClips)
+    {
+        QList<QPolygonF> remainingPolygons;
+
+        for (const QPolygonF& polygon : std::as_const(polygons))
+        {
+            QList<QPolygonF> parts;
+
+            switch (subtractConvexPolygon(polygon, convexClip, parts))
+            {
+            case NotIntersecting:
+                remainingPolygons << polygon;
+                break;
+
+            case Subtracted:
+                remainingPolygons << parts;
+                intersected = true;
+                break;
+
+            case Unsupported:
+            {
+                QPainterPath subjectPath;
+                subjectPath.addPolygon(polygon);
+                subjectPath.setFillRule(Qt::WindingFill);
+
+                QPainterPath clipPath;
+                clipPath.addPolygon(convexClip);
+
+                if (!subjectPath.intersects(clipPath))
+                {
+                    remainingPolygons << polygon;
+                    break;
+                }
+
+                // reverse clipPath so that it has the opposite orientation of the subject
+                // necessary for punching a hole with WindingFill rule
+                remainingPolygons << subjectPath.subtracted(clipPath.toReversed()).simplified().toFillPolygons();
+                intersected = true;
+                break;
+            }
+            }
+        }
+
+        polygons = remainingPolygons;
+    }
+
+    if (intersected)
+        result = polygons;
+
+    return intersected;
+}
@@ -39,6 +39,13 @@ class UBGeometryUtils
         virtual ~UBGeometryUtils();
 
     public:
+        enum SubtractionResult
+        {
+            NotIntersecting,
+            Subtracted,
+            Unsupported
+        };
+
         static QPolygonF lineToPolygon(const QLineF& pLine, const qreal& pWidth);
         static QPolygonF lineToPolygon(const QLineF& pLine, const qreal& pStartWidth, const qreal& pEndWidth);
         static QRectF lineToInnerRect(const QLineF& pLine, const qreal& pWidth);
@@ -59,6 +66,9 @@ class UBGeometryUtils
 
         static QList<QPointF> quadraticBezier(const QPointF& p0, const QPointF& p1, const QPointF& p2, unsigned int nPoints);
 
+        static SubtractionResult subtractConvexPolygon(const QPolygonF& subject, const QPolygonF& convexClip, QList<QPolygonF>& result);
+        static bool subtractConvexPolygons(const QPolygonF& subject, const QList<QPolygonF>& convexClips, QList<QPolygonF>& result);
+
         const static int centimeterGraduationHeight;
         const static int halfCentimeterGraduationHeight;
         const static int millimeterGraduationHeight;
@@ -25,6 +25,8 @@
 #include <QDebug>
 #include <QImage>
 
+#include "UBFrameScaler.h"
+
 #include <spa/debug/types.h>
 #include <spa/param/format-utils.h>
 #include <spa/param/video/raw-utils.h>
@@ -63,6 +65,16 @@ UBPipewireSink::~UBPipewireSink()
     mLoop = nullptr;
 }
 
+/**
+ * @brief Scale the frames directly from the stream buffers on the streaming thread.
+ *
+ * Must be set before the sink is started and the scaler must outlive the sink.
+ */
+void UBPipewireSink::setFrameScaler(UBFrameScaler* scaler)
+{
+    mFrameScaler = scaler;
+}
+
 bool UBPipewireSink::start(int fd, int nodeId)
 {
     // stream event handler struct
@@ -216,38 +228,38 @@ void UBPipewireSink::process()
     auto height = static_cast<int>(mFormat.info.raw.size.height);
     auto stride = buf->datas[0].chunk->stride;
 
-    QImage image;
+    QImage::Format format{QImage::Format_Invalid};
     bool swapRgb{false};
 
     switch (mFormat.info.raw.format)
     {
     case SPA_VIDEO_FORMAT_ARGB:
-        image = QImage(data, width, height, stride, QImage::Format_ARGB32);
+        format = QImage::Format_ARGB32;
         break;
 
     case SPA_VIDEO_FORMAT_xRGB:
-        image = QImage(data, width, height, stride, QImage::Format_RGB32);
+        format = QImage::Format_RGB32;
         break;
 
     case SPA_VIDEO_FORMAT_RGB:
-        image = QImage(data, width, height, stride, QImage::Format_RGB888);
+        format = QImage::Format_RGB888;
         break;
 
     case SPA_VIDEO_FORMAT_RGBA:
-        image = QImage(data, width, height, stride, QImage::Format_RGBA8888);
+        format = QImage::Format_RGBA8888;
         break;
 
     case SPA_VIDEO_FORMAT_RGBx:
-        image = QImage(data, width, height, stride, QImage::Format_RGBX8888);
+        format = QImage::Format_RGBX8888;
         break;
 
     case SPA_VIDEO_FORMAT_BGRA:
-        image = QImage(data, width, height, stride, QImage::Format_RGBA8888);
+        format = QImage::Format_RGBA8888;
         swapRgb = true;
         break;
 
     case SPA_VIDEO_FORMAT_BGRx:
-        image = QImage(data, width, height, stride, QImage::Format_RGBX8888);
+        format = QImage::Format_RGBX8888;
         swapRgb = true;
         break;
 
@@ -255,17 +267,22 @@ void UBPipewireSink::process()
         qWarning() << "UBPipewireSink: unsupported image format";
     }
 
-    if (swapRgb)
+    if (format != QImage::Format_Invalid)
     {
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        image.rgbSwap();
-#else
-        image = image.rgbSwapped();
-#endif
+        // scale while the buffer is mapped, no copy of the full frame is needed
+        if (mFrameScaler)
+        {
+            mFrameScaler->scale(data, width, height, stride, format, swapRgb);
+        }
+
+        if (receivers(SIGNAL(gotImage(QImage))) > 0)
+        {
+            // the buffer is given back to the stream below, the image must own its data
+            const QImage image(data, width, height, stride, format);
+            emit gotImage(swapRgb ? image.rgbSwapped() : image.copy());
+        }
     }
 
-    emit gotImage(image);
-
     pw_stream_queue_buffer(mStream, b);
 }
 
@@ -27,6 +27,7 @@
 #include <pipewire/pipewire.h>
 #include <spa/param/video/format.h>
 
+class UBFrameScaler;
 
 class UBPipewireSink : public QObject
 {
@@ -36,6 +37,8 @@ public:
     explicit UBPipewireSink(QObject* parent = nullptr);
     ~UBPipewireSink();
 
+    void setFrameScaler(UBFrameScaler* scaler);
+
 public slots:
     bool start(int fd, int nodeId);
 
@@ -49,6 +52,7 @@ private:
     void streamParamChanged(uint32_t id, const struct spa_pod* param);
 
 private:
+    UBFrameScaler* mFrameScaler{nullptr};
     pw_thread_loop* mLoop{nullptr};
     pw_context* mContext{nullptr};
     pw_stream* mStream{nullptr};
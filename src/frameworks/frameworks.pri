@@ -7,7 +7,8 @@ HEADERS      += src/frameworks/UBGeometryUtils.h \
                 src/frameworks/UBCoreGraphicsScene.h \
                 src/frameworks/UBCryptoUtils.h \
                 src/frameworks/UBBackgroundLoader.h \
-                src/frameworks/UBBase32.h
+                src/frameworks/UBBase32.h \
+                src/frameworks/UBFrameScaler.h
 
 SOURCES      += src/frameworks/UBGeometryUtils.cpp \
                 src/frameworks/UBPlatformUtils.cpp \
@@ -17,7 +18,8 @@ SOURCES      += src/frameworks/UBGeometryUtils.cpp \
                 src/frameworks/UBCoreGraphicsScene.cpp \
                 src/frameworks/UBCryptoUtils.cpp \
                 src/frameworks/UBBackgroundLoader.cpp \
-                src/frameworks/UBBase32.cpp
+                src/frameworks/UBBase32.cpp \
+                src/frameworks/UBFrameScaler.cpp
 
 
 win32 {
@@ -33,6 +33,7 @@
 #include "core/UBApplication.h"
 #include "core/UBDisplayManager.h"
 #include "board/UBBoardController.h"
+#include "frameworks/UBFrameScaler.h"
 
 #ifdef Q_OS_LINUX
 #include "frameworks/UBDesktopPortal.h"
@@ -50,15 +51,20 @@
 UBScreenMirror::UBScreenMirror(QWidget* parent)
     : QWidget(parent)
     , mSourceWidget(0)
+    , mFrameScaler(new UBFrameScaler(this))
     , mTimerID(0)
 {
-    // NOOP
+    // frames are scaled on another thread, repaint only when a new one is available
+    connect(mFrameScaler, &UBFrameScaler::frameReady, this, QOverload<>::of(&UBScreenMirror::update), Qt::QueuedConnection);
 }
 
 
 UBScreenMirror::~UBScreenMirror()
 {
-    // NOOP
+#ifdef Q_OS_LINUX
+    // the streaming threads use the frame scaler
+    qDeleteAll(findChildren<UBPipewireSink*>(QString(), Qt::FindDirectChildrenOnly));
+#endif
 }
 
 
@@ -70,41 +76,50 @@ void UBScreenMirror::paintEvent(QPaintEvent *event)
 
     painter.fillRect(0, 0, width(), height(), QBrush(Qt::black));
 
-    if (!mLastPixmap.isNull())
+    const QImage& frame = mFrameScaler->takeFrame();
+
+    if (!frame.isNull())
     {
         // compute size and offset in device independent coordinates
-        QSizeF pixmapSize = mLastPixmap.size() / mLastPixmap.devicePixelRatioF();
-        int x = (width() - pixmapSize.width()) / 2;
-        int y = (height() - pixmapSize.height()) / 2;
+        QSizeF frameSize = frame.size() / frame.devicePixelRatioF();
+        int x = (width() - frameSize.width()) / 2;
+        int y = (height() - frameSize.height()) / 2;
 
-        painter.drawPixmap(x, y, mLastPixmap);
+        painter.drawImage(x, y, frame);
     }
 }
 
 
+void UBScreenMirror::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    mFrameScaler->setTargetSize(size() * devicePixelRatioF(), devicePixelRatioF());
+}
+
+
 void UBScreenMirror::timerEvent(QTimerEvent *event)
 {
     Q_UNUSED(event);
 
     grabPixmap();
-
-    update();
 }
 
 void UBScreenMirror::grabPixmap()
 {
+    // grabbing must be done on the GUI thread, scaling is done by the frame scaler
     if (mSourceWidget)
     {
-        mLastPixmap = mSourceWidget->grab();
+        QPixmap pixmap = mSourceWidget->grab();
 
-        if (!mLastPixmap.isNull())
-            mLastPixmap = mLastPixmap.scaled(width(), height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        if (!pixmap.isNull())
+            mFrameScaler->submit(pixmap.toImage());
     }
     else
     {
         UBApplication::displayManager->grab(ScreenRole::Control, [this](QPixmap pixmap){
             if (!pixmap.isNull())
-                mLastPixmap = pixmap.scaled(width(), height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                mFrameScaler->submit(pixmap.toImage());
         });
     }
 }
@@ -130,11 +145,7 @@ void UBScreenMirror::playStream(int fd, int nodeId)
 {
     qDebug() << "Start stream player" << fd << nodeId;
     auto sink = new UBPipewireSink(this);
-
-    connect(sink, &UBPipewireSink::gotImage, this, [this](QImage image){
-        mLastPixmap = QPixmap::fromImage(image).scaled(width(), height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        update();
-    });
+    sink->setFrameScaler(mFrameScaler);
 
     connect(sink, &UBPipewireSink::streamingInterrupted, sink, &QObject::deleteLater);
 
@@ -163,15 +174,13 @@ void UBScreenMirror::setSourceWidget(QWidget *sourceWidget)
         }
 
         // use desktop portal to start a screencast
-        mLastPixmap = {};
+        mFrameScaler->clear();
         startScreenCast();
         return;
     }
 #endif
 
     grabPixmap();
-
-    update();
 }
 
 
@@ -190,7 +199,7 @@ void UBScreenMirror::start()
     if (mSourceWidget == nullptr && UBPlatformUtils::sessionType() == UBPlatformUtils::WAYLAND)
     {
         // use desktop portal to start a screencast
-        mLastPixmap = {};
+        mFrameScaler->clear();
         startScreenCast();
         return;
     }
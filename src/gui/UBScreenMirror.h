@@ -35,6 +35,7 @@
 
 // forward
 class UBDesktopPortal;
+class UBFrameScaler;
 
 
 class UBScreenMirror : public QWidget
@@ -46,6 +47,7 @@ class UBScreenMirror : public QWidget
         virtual ~UBScreenMirror();
 
         virtual void paintEvent (QPaintEvent * event);
+        virtual void resizeEvent(QResizeEvent *event);
         virtual void timerEvent(QTimerEvent *event);
 
     public slots:
@@ -65,7 +67,7 @@ class UBScreenMirror : public QWidget
 #endif
 
         QWidget* mSourceWidget;
-        QPixmap mLastPixmap;
+        UBFrameScaler* mFrameScaler;
         long mTimerID;
         bool mIsStarted{false};
 
@@ -22,6 +22,8 @@
 
 #include "UBThumbnailScene.h"
 
+#include <QtConcurrent>
+
 #include "adaptors/UBThumbnailAdaptor.h"
 #include "core/UBApplication.h"
 #include "document/UBDocument.h"
@@ -218,7 +220,7 @@ void UBThumbnailScene::createThumbnails(int startIndex)
         return;
     }
 
-    mLoader = new UBBackgroundLoader{paths, this};
+    mLoader = new UBBackgroundLoader{paths, UBSettings::maxThumbnailWidth, this};
     mLoader->start();
 
     // now create all missing thumbnails for document as they arrive from the loader
@@ -282,6 +284,7 @@ void UBThumbnailScene::deleteThumbnail(int pageIndex, bool rearrange)
                 mLastSelectedThumbnail = nullptr;
             }
 
+            cancelMissingThumbnail(thumbnail);
             removeItem(thumbnail);
             delete thumbnail;
         }
@@ -400,30 +403,31 @@ void UBThumbnailScene::loadNextThumbnail()
             // take and process next result
             const auto result = mLoader->takeResult();
             const auto index = result.first;
-            auto thumbnailItem = mThumbnailItems.at(index);
 
-            if (!thumbnailItem)
+            if (index >= mThumbnailItems.size())
             {
-                QPixmap pixmap;
+                continue;
+            }
 
-                if (result.second.isEmpty())
-                {
-                    pixmap = UBThumbnailAdaptor::generateMissingThumbnail(mDocument->proxy(), index);
-                }
-                else
-                {
-                    pixmap.loadFromData(result.second);
-                }
+            auto thumbnailItem = mThumbnailItems.at(index);
 
+            if (!thumbnailItem)
+            {
                 thumbnailItem = new UBThumbnail;
 
-                thumbnailItem->setPixmap(pixmap);
+                thumbnailItem->setPixmap(QPixmap::fromImage(result.second));
                 thumbnailItem->setSceneIndex(index);
 
                 mThumbnailItems[index] = thumbnailItem;
                 addItem(thumbnailItem);
 
-                if (firstIndex < 0)
+                if (result.second.isNull())
+                {
+                    // keep the empty thumbnail until the page is rendered
+                    mMissingThumbnails << thumbnailItem;
+                }
+
+                if (firstIndex < 0 || index < firstIndex)
                 {
                     firstIndex = index;
                 }
@@ -435,6 +439,8 @@ void UBThumbnailScene::loadNextThumbnail()
             arrangeThumbnails(firstIndex);
         }
 
+        generateNextMissingThumbnail();
+
         // load next thumbnails in a deferred task executed on the main thread when it is idle.
         QTimer::singleShot(1, mLoader, [this]() { loadNextThumbnail(); });
     }
@@ -452,6 +458,87 @@ void UBThumbnailScene::loadNextThumbnail()
     }
 }
 
+/**
+ * @brief Generate the next missing thumbnail.
+ *
+ * The page is parsed on a worker thread and its items are created in small steps on the
+ * main thread, like pages prefetched by the scene cache. Rendering and saving the pixmap
+ * is then left to the thumbnail adaptor. The page index is only taken from the thumbnail
+ * when it is needed, so pages may be moved while their thumbnail is generated.
+ */
+void UBThumbnailScene::generateNextMissingThumbnail()
+{
+    if (mGeneratingThumbnail || mMissingThumbnails.empty() || UBApplication::isClosing)
+    {
+        return;
+    }
+
+    if (!mDescriptionWatcher)
+    {
+        mDescriptionWatcher = new QFutureWatcher<std::shared_ptr<const UBSvgPageDescription>>{this};
+        connect(mDescriptionWatcher, &QFutureWatcherBase::finished, this, [this]() {
+            if (mGeneratingThumbnail && !UBApplication::isClosing)
+            {
+                mGeneratorContext = std::make_shared<UBSvgSubsetAdaptor::UBSvgReaderContext>(mDocument->proxy(), mDescriptionWatcher->result());
+                mGeneratorTimer->start();
+            }
+        });
+
+        mGeneratorTimer = new QTimer{this};
+        connect(mGeneratorTimer, &QTimer::timeout, this, [this]() {
+            if (!mGeneratorContext || UBApplication::isClosing)
+            {
+                mGeneratorTimer->stop();
+                return;
+            }
+
+            mGeneratorContext->step();
+
+            if (mGeneratorContext->isFinished())
+            {
+                mGeneratorTimer->stop();
+
+                const auto scene = mGeneratorContext->scene();
+                const auto thumbnail = mGeneratingThumbnail;
+                mGeneratorContext = nullptr;
+                mGeneratingThumbnail = nullptr;
+
+                if (scene)
+                {
+                    QPointer<UBThumbnailScene> self{this};
+
+                    UBThumbnailAdaptor::persistSceneInBackground(mDocument->proxy(), scene, thumbnail->sceneIndex(), [self, thumbnail]() {
+                        if (self && self->mThumbnailItems.contains(thumbnail))
+                        {
+                            self->reloadThumbnail(thumbnail->sceneIndex());
+                        }
+                    });
+                }
+
+                generateNextMissingThumbnail();
+            }
+        });
+    }
+
+    mGeneratingThumbnail = mMissingThumbnails.takeFirst();
+    const auto fileName = UBSvgSubsetAdaptor::sceneFileName(mDocument->proxy(), mGeneratingThumbnail->sceneIndex());
+    mDescriptionWatcher->setFuture(QtConcurrent::run(&UBSvgPageDescription::fromFile, fileName));
+}
+
+void UBThumbnailScene::cancelMissingThumbnail(UBThumbnail* thumbnail)
+{
+    mMissingThumbnails.removeAll(thumbnail);
+
+    if (thumbnail == mGeneratingThumbnail)
+    {
+        mGeneratorTimer->stop();
+        mGeneratorContext = nullptr;
+        mGeneratingThumbnail = nullptr;
+
+        generateNextMissingThumbnail();
+    }
+}
+
 void UBThumbnailScene::renumberThumbnails(int fromIndex, int toIndex) const
 {
     if (toIndex < 0 || toIndex > mThumbnailItems.size())
@@ -23,8 +23,10 @@
 #pragma once
 
 
+#include <QFutureWatcher>
 #include <QGraphicsScene>
 
+#include "adaptors/UBSvgSubsetAdaptor.h"
 #include "core/UBSettings.h"
 
 // forward
@@ -72,6 +74,8 @@ private:
     friend class UBThumbnail;
     UBThumbnailArranger* currentThumbnailArranger();
     void loadNextThumbnail();
+    void generateNextMissingThumbnail();
+    void cancelMissingThumbnail(UBThumbnail* thumbnail);
     void renumberThumbnails(int fromIndex = 0, int toIndex = -1) const;
 
 private:
@@ -80,4 +84,11 @@ private:
     int mThumbnailWidth{UBSettings::defaultThumbnailWidth};
     UBBackgroundLoader* mLoader{nullptr};
     UBThumbnail* mLastSelectedThumbnail{nullptr};
+
+    // missing thumbnails are generated one after the other without blocking the GUI
+    QList<UBThumbnail*> mMissingThumbnails{};
+    UBThumbnail* mGeneratingThumbnail{nullptr};
+    QFutureWatcher<std::shared_ptr<const UBSvgPageDescription>>* mDescriptionWatcher{nullptr};
+    std::shared_ptr<UBSvgSubsetAdaptor::UBSvgReaderContext> mGeneratorContext{};
+    QTimer* mGeneratorTimer{nullptr};
 };
@@ -33,6 +33,7 @@
 #include "Utils.h"
 #include "Parser.h"
 #include "Exception.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -42,6 +43,26 @@
 using namespace merge_lib;
 const std::string firstObj("%PDF-1.4\n1 0 obj\n<<\n/Title ()/Creator ()/Producer (Qt 4.5.0 (C) 1992-2009 Nokia Corporation and/or its subsidiary(-ies))/CreationDate (D:20090424120829)\n>>\nendobj\n");
 const std::string zeroStr("0000000000");
+const std::string pdfVersion14("%PDF-1.4");
+const unsigned int maxObjectsInObjectStream = 100;
+
+//collects all objects in the same order as Object::serialize writes them
+static void collectObjects(Object * object, std::map<unsigned int, Object *> & objects)
+{
+   if(objects.count(object->getObjectNumber()))
+      return;
+   objects[object->getObjectNumber()] = object;
+   const Object::Children & children = object->getChildren();
+   for(Object::Children::const_iterator it = children.begin(); it != children.end(); ++it)
+      collectObjects((*it).second.first, objects);
+}
+
+//appends big-endian field of cross-reference stream entry
+static void appendXRefField(std::string & xref, unsigned long long value, unsigned int width)
+{
+   for(unsigned int i = width; i > 0; --i)
+      xref.push_back(static_cast<char>((value >> (8 * (i - 1))) & 0xFF));
+}
 Document::Document(const char * fileName):
     _root(0), _pages(), _documentName(fileName), _maxObjectNumber(0)
 {
@@ -77,7 +98,7 @@ Page * Document::getPage(unsigned int pageNumber)
    return  _pages[pageNumber];
 }
 
-void Document::saveAs(const char * newFileName)
+void Document::saveAs(const char * newFileName, bool compressObjects)
 {
    //first two objects will be created by hand
    unsigned int fromObjNumber = 2;
@@ -97,6 +118,12 @@ void Document::saveAs(const char * newFileName)
       throw Exception(error);
    }
 
+   if(compressObjects)
+   {
+      _saveWithObjectStreams(out);
+      return;
+   }
+
    out << firstObj.c_str();
    _root->serialize( out, sizesAndGenerationNumbers);
    
@@ -127,6 +154,100 @@ void Document::saveAs(const char * newFileName)
 
 }
 
+void Document::_saveWithObjectStreams(std::ofstream & out)
+{
+   std::map<unsigned int, Object *> objects;
+   collectObjects(_root, objects);
+
+   //object streams and cross-reference streams require PDF 1.5
+   std::string firstObjects(firstObj);
+   firstObjects.replace(0, pdfVersion14.size(), "%PDF-1.5");
+   out << firstObjects;
+
+   //key - object number
+   //value - entry type, offset or number of object stream, generation number or index in object stream
+   std::map<unsigned int, std::pair<unsigned int, std::pair<unsigned long long, unsigned int> > > entries;
+   entries[1] = std::make_pair(1u, std::make_pair((unsigned long long)firstObjects.find("1 0 obj"), 0u));
+
+   //streams and objects with non-zero generation cannot be stored in object stream
+   std::vector<Object *> objectsToCompress;
+   std::map<unsigned int, Object *>::iterator objectIterator;
+   for(objectIterator = objects.begin(); objectIterator != objects.end(); ++objectIterator)
+   {
+      Object * object = (*objectIterator).second;
+      if(object->hasStream() || object->getgenerationNumber() != 0)
+      {
+         entries[object->getObjectNumber()] = std::make_pair(1u, std::make_pair((unsigned long long)std::streamoff(out.tellp()), object->getgenerationNumber()));
+         object->serializeHimself(out);
+      }
+      else
+         objectsToCompress.push_back(object);
+   }
+
+   unsigned int nextObjectNumber = _maxObjectNumber + 1;
+   for(size_t first = 0; first < objectsToCompress.size(); first += maxObjectsInObjectStream)
+   {
+      const size_t last = std::min<size_t>(objectsToCompress.size(), first + maxObjectsInObjectStream);
+      const unsigned int streamNumber = nextObjectNumber++;
+      //object stream starts with pairs "<object number> <offset>", objects follow them
+      std::string offsets;
+      std::string objectsContent;
+      for(size_t i = first; i < last; ++i)
+      {
+         Object * object = objectsToCompress[i];
+         offsets += Utils::uIntToStr(object->getObjectNumber()) + " " + Utils::uIntToStr(objectsContent.size()) + " ";
+         const std::string_view content = object->getObjectContentView();
+         objectsContent.append(content.data(), content.size());
+         if(content.empty() || (int)Parser::WHITESPACES.find(content.back()) == -1)
+            objectsContent.append("\n");
+         entries[object->getObjectNumber()] = std::make_pair(2u, std::make_pair((unsigned long long)streamNumber, (unsigned int)(i - first)));
+      }
+      std::string stream = offsets + objectsContent;
+      if(!FlateDecode().encode(stream))
+         throw Exception("Cannot compress object stream");
+
+      entries[streamNumber] = std::make_pair(1u, std::make_pair((unsigned long long)std::streamoff(out.tellp()), 0u));
+      out << streamNumber << " 0 obj\n<<\n/Type /ObjStm /N " << (last - first) << " /First " << offsets.size()
+          << " /Filter /FlateDecode /Length " << stream.size() << "\n>>\nstream\n";
+      out.write(stream.data(), stream.size());
+      out << "\nendstream\nendobj\n";
+   }
+
+   //cross-reference stream contains an entry for itself
+   const unsigned int xrefNumber = nextObjectNumber++;
+   const unsigned long long startOfXref = std::streamoff(out.tellp());
+   entries[xrefNumber] = std::make_pair(1u, std::make_pair(startOfXref, 0u));
+
+   unsigned int offsetWidth = 1;
+   while(offsetWidth < 8 && (startOfXref >> (8 * offsetWidth)))
+      ++offsetWidth;
+
+   std::string xref;
+   for(unsigned int number = 0; number <= xrefNumber; ++number)
+   {
+      if(!entries.count(number))
+      {
+         //free entry
+         xref.push_back(0);
+         appendXRefField(xref, 0, offsetWidth);
+         appendXRefField(xref, number == 0 ? 65535 : 0, 2);
+         continue;
+      }
+      const std::pair<unsigned int, std::pair<unsigned long long, unsigned int> > & entry = entries[number];
+      xref.push_back(static_cast<char>(entry.first));
+      appendXRefField(xref, entry.second.first, offsetWidth);
+      appendXRefField(xref, entry.second.second, 2);
+   }
+   if(!FlateDecode().encode(xref))
+      throw Exception("Cannot compress cross-reference stream");
+
+   out << xrefNumber << " 0 obj\n<<\n/Type /XRef /Size " << xrefNumber + 1 << " /W [1 " << offsetWidth << " 2]"
+       << " /Root " << _root->getObjectNumber() << " 0 R /Info 1 0 R"
+       << " /Filter /FlateDecode /Length " << xref.size() << "\n>>\nstream\n";
+   out.write(xref.data(), xref.size());
+   out << "\nendstream\nendobj\nstartxref\n" << startOfXref << "\n%%EOF";
+}
+
 Object * Document::getDocumentObject()
 {
    return _root;
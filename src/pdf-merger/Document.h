@@ -50,7 +50,9 @@ namespace merge_lib
       Page *   getPage(unsigned int pageNumber);
       
       //save document with newFileName file name
-      void     saveAs(const char * newFileName);   
+      //if compressObjects is set, objects without streams are packed into
+      //compressed object streams and a cross-reference stream is written (PDF 1.5)
+      void     saveAs(const char * newFileName, bool compressObjects = false);   
 
       //get root of all document objects
       Object * getDocumentObject();
@@ -64,6 +66,7 @@ namespace merge_lib
    private:
       //methods   
       Document(const char * docName);
+      void _saveWithObjectStreams(std::ofstream & out);
       //members
 
       //root of all document's objects
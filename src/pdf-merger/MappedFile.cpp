@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#include "MappedFile.h"
+#include "Exception.h"
+
+#include "core/memcheck.h"
+
+using namespace merge_lib;
+
+MappedFile::MappedFile(const char * fileName):
+   _fileName(fileName), _file(QFile::decodeName(fileName)), _mapping(0), _buffer(), _view()
+{
+   if(!_file.open(QIODevice::ReadOnly))
+   {
+      std::stringstream errorMessage;
+      errorMessage << "File " << _fileName << " is absent";
+      throw Exception(errorMessage);
+   }
+
+   const qint64 size = _file.size();
+   if(size <= 0)
+      return;
+
+   _mapping = _file.map(0, size);
+   if(_mapping)
+   {
+      _view = std::string_view(reinterpret_cast<const char *>(_mapping), static_cast<size_t>(size));
+      return;
+   }
+
+   // mapping is not available on every file system, fall back to a single read
+   _buffer.resize(static_cast<size_t>(size));
+   if(_file.read(&_buffer[0], size) != size)
+   {
+      std::stringstream errorMessage;
+      errorMessage << "File " << _fileName << " cannot be read";
+      throw Exception(errorMessage);
+   }
+   _file.close();
+   _view = _buffer;
+}
+
+MappedFile::~MappedFile()
+{
+   if(_mapping)
+      _file.unmap(_mapping);
+   _file.close();
+}
+
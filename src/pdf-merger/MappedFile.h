@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#if !defined MappedFile_h
+#define MappedFile_h
+
+#include <QFile>
+
+#include <string>
+#include <string_view>
+
+namespace merge_lib
+{
+   //Read-only view of a whole pdf file.
+   //The file is memory-mapped when the platform allows it, otherwise it is read
+   //into memory once. Parser and the objects it creates share one instance, so
+   //object headers and streams can be read or copied to the output straight
+   //from the source file without keeping a private copy of it.
+   class MappedFile
+   {
+   public:
+      MappedFile(const char * fileName); //throw (Exception)
+      ~MappedFile();
+
+      std::string_view view() const
+      {
+         return _view;
+      }
+
+      const std::string & fileName() const
+      {
+         return _fileName;
+      }
+
+   private:
+      MappedFile(const MappedFile & copy);
+      MappedFile & operator=(const MappedFile & copy);
+
+      //members
+      std::string      _fileName;
+      QFile            _file;
+      uchar *          _mapping;
+      std::string      _buffer;
+      std::string_view _view;
+   };
+}
+#endif
+
@@ -133,11 +133,11 @@ void Merger::merge(const char * overlayDocName, const MergeDescription & pagesTo
 
 }
 // Method performs saving of merged documents into selected file
-void Merger::saveMergedDocumentsAs(const char * outDocumentName)
+void Merger::saveMergedDocumentsAs(const char * outDocumentName, bool compressObjects)
 {
     try
     {
-        _overlayDocument->saveAs(outDocumentName);
+        _overlayDocument->saveAs(outDocumentName, compressObjects);
     }
     catch (...)
     {
@@ -52,7 +52,7 @@ namespace merge_lib
 
       void addOverlayDocument(const char *docName);
 
-      void saveMergedDocumentsAs(const char *outDocumentName);
+      void saveMergedDocumentsAs(const char *outDocumentName, bool compressObjects = false);
 
       void merge(const char *overlayDocName, const MergeDescription & pagesToMerge);
 
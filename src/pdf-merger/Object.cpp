@@ -64,7 +64,9 @@ Object * Object::_getClone(std::map<unsigned int, Object *> & clones)
 {
    _isPassed = true;
    unsigned int objectNumber = this->getObjectNumber();   
-   Object * clone = new Object(objectNumber, this->_generationNumber, this->getObjectContent(), _fileName, _streamBounds, _hasStream);
+   Object * clone = _contentIsMapped ?
+      new Object(objectNumber, this->_generationNumber, _mappedContent, _source, _streamBounds, _hasStream) :
+      new Object(objectNumber, this->_generationNumber, _content, _source, _streamBounds, _hasStream);
    clone->_hasStreamInContent = _hasStreamInContent;
    clones.insert(std::pair<unsigned int, Object *>(objectNumber, clone));
    Children::iterator currentChild = _children.begin();
@@ -219,9 +221,26 @@ unsigned int Object::getgenerationNumber() const
 
 std::string & Object::getObjectContent()
 {
+   _loadContent();
    return _content;
 }
 
+std::string_view Object::getObjectContentView() const
+{
+   if(_contentIsMapped)
+      return _mappedContent;
+   return _content;
+}
+
+void Object::_loadContent()
+{
+   if(!_contentIsMapped)
+      return;
+   _content.assign(_mappedContent.data(), _mappedContent.size());
+   _mappedContent = std::string_view();
+   _contentIsMapped = false;
+}
+
 void Object::_setObjectNumber(unsigned int objectNumber)
 {
    if(!isPassed())
@@ -235,15 +254,19 @@ void Object::_setObjectNumber(unsigned int objectNumber)
 void Object::setObjectContent(const std::string & objectContent)
 {
    _content = objectContent;
+   _mappedContent = std::string_view();
+   _contentIsMapped = false;
 }
 
 void Object::appendContent(const std::string & addToContent)
 {
+   _loadContent();
    _content.append(addToContent);
 }
 
 void Object::eraseContent(unsigned int from, unsigned int size)
 {
+   _loadContent();
    int iSize = size;
    _recalculateReferencePositions(from + size, -iSize);
    _content.erase(from, size);
@@ -251,12 +274,14 @@ void Object::eraseContent(unsigned int from, unsigned int size)
 
 void Object::insertToContent(unsigned int position, const std::string & insertedStr)
 {
+   _loadContent();
    _recalculateReferencePositions(position, insertedStr.size());
    _content.insert(position, insertedStr);
 }
 
 void Object::insertToContent(unsigned int position, const char * insertedStr, unsigned int length)
 {    
+   _loadContent();
    _recalculateReferencePositions(position, length);
    _content.insert(position, insertedStr, length);    
 }
@@ -267,20 +292,20 @@ void Object::serialize(std::ofstream & out, std::map< unsigned int, std::pair<un
    //is this element already printed
    if(sizesAndGenerationNumbers.find(_number) != sizesAndGenerationNumbers.end()) return;
 
-   std::string stream;
-   if(_hasStream && !_hasStreamInContent)
-   {       
-      getStream(stream);
-      stream.append("endstream\n");       
-   }
+   // the stream is copied from the source file mapping to the output as is
+   const bool hasStreamInFile = _hasStream && !_hasStreamInContent;
+   std::string_view stream;
+   if(hasStreamInFile)
+      stream = _getStreamFromFile();
+   static const std::string endOfStream("endstream\n");
    // xxxx + " " + "0" + " " + "obj" + "\n" + _content.size() + "endobj\n", where x - is a digit
-   unsigned long long objectSizeForXref = (static_cast<unsigned int>(std::log10(static_cast<double>(_number))) + 1) + 14 + _content.size() + stream.size();    
+   unsigned long long objectSizeForXref = (static_cast<unsigned int>(std::log10(static_cast<double>(_number))) + 1) + 14 + getObjectContentView().size();
+   if(hasStreamInFile)
+      objectSizeForXref += stream.size() + endOfStream.size();
 
    sizesAndGenerationNumbers.insert(std::pair<unsigned int, std::pair<unsigned long long, unsigned int > >(_number, std::make_pair(objectSizeForXref, _generationNumber)));
 
-   serialize(out, stream);
-   stream.clear();
-   stream.shrink_to_fit();
+   serialize(out, stream, hasStreamInFile);
 
    //call serialize of each child
    Children::iterator it;
@@ -290,6 +315,12 @@ void Object::serialize(std::ofstream & out, std::map< unsigned int, std::pair<un
       currentChild->serialize(out, sizesAndGenerationNumbers);
    }
 }
+void Object::serializeHimself(std::ofstream & out)
+{
+   const bool hasStreamInFile = _hasStream && !_hasStreamInContent;
+   serialize(out, hasStreamInFile ? _getStreamFromFile() : std::string_view(), hasStreamInFile);
+}
+
 void Object::recalculateObjectNumbers(unsigned int & newNumber)
 {    
    _recalculateObjectNumbers(newNumber);
@@ -313,6 +344,7 @@ void Object::_recalculateObjectNumbers(unsigned int & newNumber)
    {    
       Object * currentChild = (*childIterator).second.first;
       //if(currentChild->getOldNumber() == currentChild->getObjectNumber()) continue;
+      _loadContent();
       const ReferencePositionsInContent & refPositionForcurrentChild = (*childIterator).second.second;
       const std::string & oldNumberStr = Utils::uIntToStr(currentChild->getOldNumber());
       const std::string & newNumber = Utils::uIntToStr(currentChild->getObjectNumber());
@@ -383,7 +415,7 @@ void Object::_retrieveMaxObjectNumber(unsigned int & maxNumber)
 bool Object::_findObject(const std::string & token, Object* & foundObject, unsigned int & tokenPositionInContent)
 {
    _isPassed = true;
-   tokenPositionInContent = Parser::findToken(_content,token);
+   tokenPositionInContent = Parser::findToken(getObjectContentView(),token);
    if((int)tokenPositionInContent != -1)
    {
       foundObject = this;
@@ -429,10 +461,17 @@ void Object::_addParent(Object * child)
 {
    _parents.insert(child);
 }
-void Object::serialize(std::ofstream  & out, const std::string & stream)
+void Object::serialize(std::ofstream  & out, std::string_view stream, bool hasStreamInFile)
 {
-    out << _number << " " << _generationNumber << " obj\n" << _content << stream << "endobj\n";
-   out.flush();
+   const std::string_view content = getObjectContentView();
+   out << _number << " " << _generationNumber << " obj\n";
+   out.write(content.data(), content.size());
+   if(hasStreamInFile)
+   {
+      out.write(stream.data(), stream.size());
+      out << "endstream\n";
+   }
+   out << "endobj\n";
 }
 
 /** @brief getStream
@@ -451,25 +490,24 @@ bool Object::getStream(std::string & stream)
          return false;
    }
 
-   std::ifstream pdfFile;
-   pdfFile.open (_fileName.c_str(), std::ios::binary );
-   if (pdfFile.fail())
-   {
-      std::stringstream errorMessage("File ");
-      errorMessage << _fileName << " is absent" << "\0";
-      throw Exception(errorMessage);
-   }
-   // get length of file:
-   int length = _streamBounds.second - _streamBounds.first;
-   pdfFile.seekg (_streamBounds.first, std::ios_base::beg);
-   stream.resize(length);
-   pdfFile.read(&stream[0], length);   
-   pdfFile.close();
+   const std::string_view streamInFile = _getStreamFromFile();
+   stream.assign(streamInFile.data(), streamInFile.size());
    return true;
 }
 
+std::string_view Object::_getStreamFromFile() const
+{
+   if(!_source)
+      throw Exception("Stream of object is not available, source file is absent");
+   const std::string_view file = _source->view();
+   if((_streamBounds.second < _streamBounds.first) || (_streamBounds.second > file.size()))
+      throw Exception("Wrong stream bounds in PDF");
+   return file.substr(_streamBounds.first, _streamBounds.second - _streamBounds.first);
+}
+
 bool Object::_getStreamFromContent(std::string & stream)
 {
+   _loadContent();
    size_t stream_begin = _content.find("stream");
    if((int) stream_begin == -1 )
    {
@@ -502,13 +540,14 @@ bool Object::_getStreamFromContent(std::string & stream)
 */
 bool Object::getHeader(std::string &content)
 {
+   const std::string_view objectContent = getObjectContentView();
    if( !hasStream() )
    {
-      content = _content;
+      content.assign(objectContent.data(), objectContent.size());
       return true;
    }
-   size_t stream_begin = _content.find("stream");
-   content = _content.substr(0,stream_begin);
+   const std::string_view header = objectContent.substr(0, objectContent.find("stream"));
+   content.assign(header.data(), header.size());
    return true;
 }
 
@@ -31,11 +31,14 @@
 #define Object_h
 
 #include "Utils.h"
+#include "MappedFile.h"
 
 #include <cmath>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 #include <utility>
@@ -52,6 +55,9 @@ namespace merge_lib
     //Each reference (child object) should be kept with it position(s) in object's content.
     //After each content modification, all references should be changed too.
     //This convention lighten the recalculation object numbers work.
+    //Objects created by Parser keep their content as a view into the mapped source file
+    //and copy it only when it is requested for modification (see getObjectContent).
+    //Objects which are never touched are written to the output straight from the mapping.
     class Object
     {
     public:
@@ -60,10 +66,18 @@ namespace merge_lib
        typedef std::pair<Object *, ReferencePositionsInContent > ChildAndItPositionInContent;
        typedef std::map <unsigned int, ChildAndItPositionInContent> Children;
        Object(unsigned int objectNumber, unsigned int generationNumber, const std::string & objectContent, 
-           std::string fileName = "", std::pair<unsigned int, unsigned int> streamBounds = std::make_pair ((unsigned int)0,(unsigned int)0), bool hasStream = false
+           std::shared_ptr<const MappedFile> source = std::shared_ptr<const MappedFile>(), std::pair<unsigned int, unsigned int> streamBounds = std::make_pair ((unsigned int)0,(unsigned int)0), bool hasStream = false
                   ):
-       _number(objectNumber), _generationNumber(generationNumber), _oldNumber(objectNumber), _content(objectContent),_parents(),_children(),_isPassed(false),
-           _streamBounds(streamBounds), _fileName(fileName), _hasStream(hasStream), _hasStreamInContent(false)
+       _number(objectNumber), _generationNumber(generationNumber), _oldNumber(objectNumber), _content(objectContent), _mappedContent(), _contentIsMapped(false),
+           _parents(),_children(),_isPassed(false), _streamBounds(streamBounds), _source(source), _hasStream(hasStream), _hasStreamInContent(false)
+       {
+       }
+       //mappedContent should point into source
+       Object(unsigned int objectNumber, unsigned int generationNumber, std::string_view mappedContent,
+           std::shared_ptr<const MappedFile> source, std::pair<unsigned int, unsigned int> streamBounds, bool hasStream
+                  ):
+       _number(objectNumber), _generationNumber(generationNumber), _oldNumber(objectNumber), _content(), _mappedContent(mappedContent), _contentIsMapped(true),
+           _parents(),_children(),_isPassed(false), _streamBounds(streamBounds), _source(source), _hasStream(hasStream), _hasStreamInContent(false)
        {
        }
        virtual ~Object();
@@ -86,6 +100,8 @@ namespace merge_lib
 
 
        std::string &               getObjectContent();
+       //read-only access which does not copy the content out of the source file
+       std::string_view            getObjectContentView() const;
 
        void                        setObjectContent(const std::string & objectContent);
        void                        appendContent(const std::string & addToContent);
@@ -95,6 +111,8 @@ namespace merge_lib
 
        //vector <object number, its size>
        void serialize(std::ofstream & out, std::map< unsigned int, std::pair<unsigned long long, unsigned int > > & sizesAndGenerationNumbers);
+       //writes this object only, without children
+       void serializeHimself(std::ofstream & out);
 
        void recalculateObjectNumbers(unsigned int & newNumber);
 
@@ -152,23 +170,27 @@ namespace merge_lib
        void _setObjectNumber(unsigned int objectNumber);       
        void _addParent(Object * child);
        bool _findObject(const std::string & token, Object* & foundObject, unsigned int & tokenPositionInContent);
-       void serialize(std::ofstream  & out, const std::string & stream);
+       void serialize(std::ofstream  & out, std::string_view stream, bool hasStreamInFile);
        void _recalculateObjectNumbers(unsigned int & maxNumber);
        void _recalculateReferencePositions(unsigned int changedReference, int displacement);
        void _retrieveMaxObjectNumber(unsigned int & maxNumber);
        void serialize(std::ofstream & out, std::map<unsigned int, unsigned long long> & sizes);
        bool _getStreamFromContent(std::string & stream);
+       std::string_view _getStreamFromFile() const;
+       void _loadContent();
 
        //members
        unsigned int                          _number;
        unsigned int                          _generationNumber;
        unsigned int                          _oldNumber;
        std::string                           _content;
+       std::string_view                      _mappedContent;
+       bool                                  _contentIsMapped;
        std::set <Object *>                   _parents;
        Children                              _children;
        bool                                  _isPassed;
        std::pair<unsigned int, unsigned int> _streamBounds;
-       std::string                           _fileName;
+       std::shared_ptr<const MappedFile>     _source;
        bool                                  _hasStream;
        bool                                  _hasStreamInContent;
 
@@ -28,7 +28,7 @@
 
 
 #include "OverlayDocumentParser.h"
-#include <fstream>
+#include <algorithm>
 #include <string.h>
 #include <QtGlobal>
 #include "Exception.h"
@@ -56,7 +56,7 @@ void OverlayDocumentParser::_readXRefAndCreateObjects()
    std::map<unsigned int, unsigned long> objectsAndSizes;
    std::map<unsigned int, unsigned long>::iterator objAndSIter;
    std::map<unsigned int, unsigned long>::iterator objAndPIter;
-   unsigned long fileSize = Utils::getFileSize(_fileName.c_str());
+   unsigned long fileSize = _file->view().size();
 
    for(objAndSIter = objectsAndPositions.begin(); objAndSIter != objectsAndPositions.end(); ++objAndSIter)
    {
@@ -98,10 +98,10 @@ void OverlayDocumentParser::_readXRefAndCreateObjects()
             unsigned int objectNumber;
             unsigned int generationNumber;
             bool hasObjectStream;
-            const std::string content = _getObjectContent(objIter->second - partStart, objectNumber, generationNumber, streamBounds, hasObjectStream);
+            std::string_view content = _getObjectContent(objIter->second - partStart, objectNumber, generationNumber, streamBounds, hasObjectStream);
             streamBounds.first += partStart;
             streamBounds.second += partStart;
-            Object * newObject = new Object(objectNumber, generationNumber, content, _document->_documentName ,streamBounds, hasObjectStream);
+            Object * newObject = new Object(objectNumber, generationNumber, content, _file, streamBounds, hasObjectStream);
             _objects[objectNumber] = newObject;
             std::map<unsigned int, unsigned long>::iterator temp = objIter;                   
             ++objIter;
@@ -117,28 +117,20 @@ void OverlayDocumentParser::_readXRefAndCreateObjects()
 
 void OverlayDocumentParser::_getFileContent(const char * fileName)
 {
-    Q_UNUSED(fileName);
+   //parts of the file are selected by _getPartOfFileContent
+   _file = std::make_shared<MappedFile>(fileName);
 }
 
+//parts are views into the mapped file, negative startOfPart is counted from the end of file
 void OverlayDocumentParser::_getPartOfFileContent(long startOfPart, unsigned int length)
 {
-   ifstream pdfFile;
-   pdfFile.open (_fileName.c_str(), ios::binary );
-   if (pdfFile.fail())
-   {
-      stringstream errorMessage("File ");
-      errorMessage << _fileName << " is absent" << "\0";
-      throw Exception(errorMessage);
-   }   
-   ios_base::seekdir dir;
+   const std::string_view file = _file->view();
+   size_t start = 0;
    if(startOfPart >= 0)
-      dir = ios_base::beg;
-   else 
-      dir = ios_base::end;
-   pdfFile.seekg (startOfPart, dir);
-   _fileContent.resize(length);
-   pdfFile.read(&_fileContent[0], length);
-   pdfFile.close();
+      start = std::min(static_cast<size_t>(startOfPart), file.size());
+   else if(static_cast<size_t>(-startOfPart) < file.size())
+      start = file.size() + startOfPart;
+   _fileContent = file.substr(start, length);
 }
 
 void OverlayDocumentParser::_readXref(std::map<unsigned int, unsigned long> & objectsAndSizes)
@@ -147,21 +139,21 @@ void OverlayDocumentParser::_readXref(std::map<unsigned int, unsigned long> & ob
    unsigned int startOfStartxref = _fileContent.find("startxref");
    unsigned int startOfNumber = _fileContent.find_first_of(Parser::NUMBERS, startOfStartxref);
    unsigned int endOfNumber = _fileContent.find_first_not_of(Parser::NUMBERS, startOfNumber + 1);
-   std::string startXref = _fileContent.substr(startOfNumber, endOfNumber - startOfNumber);
+   std::string startXref(_fileContent.substr(startOfNumber, endOfNumber - startOfNumber));
    unsigned int strtXref = Utils::stringToInt(startXref);
 
-   unsigned int sizeOfXref = Utils::getFileSize(_fileName.c_str()) - strtXref;
+   unsigned int sizeOfXref = _file->view().size() - strtXref;
    _getPartOfFileContent(strtXref, sizeOfXref);
    unsigned int leftBoundOfObjectNumber = _fileContent.find("0 ") + strlen("0 ");
    unsigned int rightBoundOfObjectNumber = _fileContent.find_first_not_of(Parser::NUMBERS, leftBoundOfObjectNumber);
-   std::string objectNuberStr = _fileContent.substr(leftBoundOfObjectNumber, rightBoundOfObjectNumber - leftBoundOfObjectNumber);
+   std::string objectNuberStr(_fileContent.substr(leftBoundOfObjectNumber, rightBoundOfObjectNumber - leftBoundOfObjectNumber));
    unsigned long objectNumber = Utils::stringToInt(objectNuberStr);
    unsigned int startOfObjectPosition = _fileContent.find("0000000000 65535 f ") + strlen("0000000000 65535 f ");
    for(unsigned long i = 1; i < objectNumber; ++i)
    {
       startOfObjectPosition = _fileContent.find_first_of(Parser::NUMBERS, startOfObjectPosition);
       unsigned int endOfObjectPostion = _fileContent.find(" 00000 n", startOfObjectPosition);
-      std::string objectPostionStr = _fileContent.substr(startOfObjectPosition, endOfObjectPostion - startOfObjectPosition);
+      std::string objectPostionStr(_fileContent.substr(startOfObjectPosition, endOfObjectPostion - startOfObjectPosition));
       objectsAndSizes[i] = Utils::stringToInt(objectPostionStr);
       startOfObjectPosition = endOfObjectPostion + strlen(" 00000 n");
    }
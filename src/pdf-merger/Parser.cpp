@@ -28,15 +28,18 @@
 
 
 #include <QtGlobal>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <set>
 #include <stack>
 #include <string.h>
 #include "Parser.h"
 #include "Object.h"
 #include "Exception.h"
+#include "Filter.h"
 #include "Utils.h"
 
 #include "core/memcheck.h"
@@ -49,6 +52,53 @@ const std::string Parser::DELIMETERS("()<>{}/%][");
 const std::string Parser::NUMBERS("0123456789");
 const std::string Parser::WHITESPACES_AND_DELIMETERS = Parser::WHITESPACES + Parser::DELIMETERS;
 
+//reads value of dictionary entry like "/Size 12" or first number of "/Root 1 0 R"
+static bool getIntegerValue(std::string_view dictionary, const std::string & key, unsigned long & value)
+{
+   size_t position = Parser::findToken(dictionary, key);
+   if((int) position == -1)
+      return false;
+   position += key.size();
+   std::string word;
+   if(!Parser::getNextWord(word, dictionary, position))
+      return false;
+   size_t endOfNumber = word.find_first_not_of(Parser::NUMBERS);
+   if(endOfNumber == 0)
+      return false;
+   value = Utils::stringToInt(word.substr(0, endOfNumber));
+   return true;
+}
+
+//reads array of integers like "/W [1 2 1]"
+static std::vector<unsigned long> getIntegerArray(std::string_view dictionary, const std::string & key)
+{
+   std::vector<unsigned long> result;
+   size_t position = Parser::findToken(dictionary, key);
+   if((int) position == -1)
+      return result;
+   size_t startOfArray = dictionary.find_first_not_of(Parser::WHITESPACES, position + key.size());
+   if((int) startOfArray == -1 || dictionary[startOfArray] != '[')
+      return result;
+   size_t endOfArray = dictionary.find(']', startOfArray);
+   if((int) endOfArray == -1)
+      return result;
+   std::string_view array = dictionary.substr(startOfArray + 1, endOfArray - startOfArray - 1);
+   std::string word;
+   position = 0;
+   while(Parser::getNextWord(word, array, position))
+      result.push_back(Utils::stringToInt(word));
+   return result;
+}
+
+//reads big-endian field of cross-reference stream entry
+static unsigned long readXRefField(const std::string & data, size_t offset, unsigned long width)
+{
+   unsigned long value = 0;
+   for(unsigned long i = 0; i < width; ++i)
+      value = (value << 8) | static_cast<unsigned char>(data[offset + i]);
+   return value;
+}
+
 Document * Parser::parseDocument(const char * fileName)
 {
    _document = new Document(fileName);
@@ -112,28 +162,16 @@ void Parser::_createDocument(const char * docName)
 void Parser::_clearParser()
 {
    _root = 0;
-   _fileContent.clear();
-   _fileContent.shrink_to_fit();
+   _fileContent = std::string_view();
+   _file.reset();
    _objects.clear();
 }
 
 
 void Parser::_getFileContent(const char * fileName)
 {
-   ifstream pdfFile;
-   pdfFile.open (fileName, ios::binary );
-   if (pdfFile.fail())
-   {
-      stringstream errorMessage("File ");
-      errorMessage << fileName << " is absent" << "\0";
-      throw Exception(errorMessage);
-   }
-   // get length of file:
-   pdfFile.seekg (0, ios::end);
-   int length = pdfFile.tellg();
-   pdfFile.seekg (0, ios::beg);
-   _fileContent.resize(length);
-   pdfFile.read(&_fileContent[0], length);
+   _file = std::make_shared<MappedFile>(fileName);
+   _fileContent = _file->view();
 
    // check version
    const char *header = "%PDF-1.";
@@ -160,7 +198,6 @@ void Parser::_getFileContent(const char * fileName)
    {
       throw Exception("Unrecognized header of PDF file");
    }
-   pdfFile.close();
 }
 
 
@@ -192,7 +229,7 @@ void Parser::_createObjectTree(const char * fileName)
       _document->_allObjects.push_back(currentObject);
       //key - object number :  value - positions in object content of this reference
       const std::map<unsigned int, Object::ReferencePositionsInContent> & refs = 
-         _getReferences(currentObject->getObjectContent());      
+         _getReferences(currentObject->getObjectContentView());      
       std::map<unsigned int, Object::ReferencePositionsInContent>::const_iterator refsIterator = refs.begin();
       for(; refsIterator !=  refs.end(); ++refsIterator)
       {        
@@ -204,7 +241,7 @@ void Parser::_createObjectTree(const char * fileName)
 
 }
 
-const std::map<unsigned int, Object::ReferencePositionsInContent> & Parser::_getReferences(const std::string & objectContent)
+const std::map<unsigned int, Object::ReferencePositionsInContent> & Parser::_getReferences(std::string_view objectContent)
 {
    unsigned int currentPosition(0), startOfNextSearch(0);
    static std::map<unsigned int, std::vector<unsigned int> >  searchResult;
@@ -263,7 +300,7 @@ const std::map<unsigned int, Object::ReferencePositionsInContent> & Parser::_get
             ++startOfNextSearch;
             continue;
          }
-         unsigned int objectNumber = Utils::stringToInt(objectContent.substr(numberSearchCounter + 1, currentPosition - numberSearchCounter));
+         unsigned int objectNumber = Utils::stringToInt(std::string(objectContent.substr(numberSearchCounter + 1, currentPosition - numberSearchCounter)));
 
          searchResult[objectNumber].push_back(numberSearchCounter + 1);
 
@@ -277,7 +314,7 @@ const std::map<unsigned int, Object::ReferencePositionsInContent> & Parser::_get
    return searchResult;
 }
 
-unsigned int Parser::_skipNumber(const std::string & str, unsigned int currentPosition)
+unsigned int Parser::_skipNumber(std::string_view str, unsigned int currentPosition)
 {
    unsigned int numberSearchCounter = currentPosition;    
    while(((int)NUMBERS.find(str[numberSearchCounter]) != -1) && --numberSearchCounter)
@@ -287,81 +324,306 @@ unsigned int Parser::_skipNumber(const std::string & str, unsigned int currentPo
 }
 void Parser::_readXRefAndCreateObjects()
 {      
+   //entries of all xref sections, the newest section goes first
+   std::vector<XRefEntry> entries;
+   //cross-reference streams are not a part of the document
+   std::set<unsigned long> xrefStreamPositions;
+   //protects against /Prev loops
+   std::set<unsigned int> readSections;
    unsigned int currentPostion = _getStartOfXrefWithRoot();
-   do
+   bool hasPrevious = true;
+   while(hasPrevious)
    {
-      const std::string & currentToken = _getNextToken(currentPostion);
-      if(currentToken != "xref")
-      {
+      if(!readSections.insert(currentPostion).second)
          throw Exception("Wrong xref in some document");
+      unsigned int position = currentPostion;
+      if(_getNextToken(position) != "xref")
+      {
+         xrefStreamPositions.insert(currentPostion);
+         hasPrevious = _readXRefStream(currentPostion, entries, currentPostion);
+         continue;
       }
-      unsigned int endOfLine = _getEndOfLineFromContent(currentPostion );
-      if(_countTokens(currentPostion, endOfLine) != 2)
+      std::vector<XRefEntry> tableEntries;
+      _readXRefTable(currentPostion, tableEntries);
+
+      //hybrid-reference file keeps its compressed objects in an additional xref stream,
+      //its entries go first as the table marks these objects as free
+      unsigned long xrefStream = 0;
+      if(getIntegerValue(_getTrailer(currentPostion), "/XRefStm", xrefStream) && !xrefStreamPositions.count(xrefStream))
       {
-         throw Exception("Wrong xref in some document");
+         unsigned int ignoredPrevious;
+         xrefStreamPositions.insert(xrefStream);
+         _readXRefStream(xrefStream, entries, ignoredPrevious);
+      }
+      entries.insert(entries.end(), tableEntries.begin(), tableEntries.end());
+      hasPrevious = _readTrailerAndRterievePrev(currentPostion, currentPostion);
+   }
 
+   //objects are created as views into the file, nothing is copied here.
+   //Compressed objects are collected by number, object which is overwritten or
+   //freed by a newer section is skipped.
+   //key - object number : value - object stream number and index of object in it
+   std::map<unsigned int, std::pair<unsigned int, unsigned int> > compressedObjects;
+   std::set<unsigned int> freeObjects;
+   for(size_t i = 0; i < entries.size(); ++i)
+   {
+      const XRefEntry & entry = entries[i];
+      if(entry.type == XRefEntry::Free)
+      {
+         freeObjects.insert(entry.objectNumber);
+         continue;
+      }
+      if(freeObjects.count(entry.objectNumber))
+         continue;
+      if(entry.type == XRefEntry::Compressed)
+      {
+         if(!_objects.count(entry.objectNumber) && !compressedObjects.count(entry.objectNumber))
+            compressedObjects[entry.objectNumber] = std::make_pair(entry.position, entry.index);
+         continue;
       }
-      //now we are reading the xref
-      while(1)
+      if(xrefStreamPositions.count(entry.position))
+         continue;
+      unsigned int objectNumber;
+      try
       {
-         Utils::stringToInt(_getNextToken(currentPostion));
-         unsigned int objectCount = Utils::stringToInt(_getNextToken(currentPostion));
-         for(unsigned int i(0); i < objectCount; i++)
+         std::pair<unsigned int, unsigned int> streamBounds;
+         bool hasObjectStream;
+         unsigned int generationNumber;
+         std::string_view content = _getObjectContent(entry.position, objectNumber, generationNumber, streamBounds, hasObjectStream);
+         if(!_objects.count(objectNumber) && !compressedObjects.count(objectNumber))
          {
-            unsigned long  first;
+            Object * newObject = new Object(objectNumber, generationNumber, content, _file, streamBounds, hasObjectStream);
+            _objects[objectNumber] = newObject;
+         }
+      }
+      catch(std::exception &)
+      {
+      }
+   }
+   if(!compressedObjects.empty())
+      _createCompressedObjects(compressedObjects);
+}
 
-            if(_countTokens(currentPostion, _getEndOfLineFromContent(currentPostion)) == 3)
-            {
-               first  = Utils::stringToInt(_getNextToken(currentPostion));
-               Utils::stringToInt(_getNextToken(currentPostion));
-               const string & use         = _getNextToken(currentPostion);
-               if(!use.compare("n"))
-               {
-                  unsigned int objectNumber;
+void Parser::_readXRefTable(unsigned int & currentPostion, std::vector<XRefEntry> & entries)
+{
+   const std::string & currentToken = _getNextToken(currentPostion);
+   if(currentToken != "xref")
+   {
+      throw Exception("Wrong xref in some document");
+   }
+   unsigned int endOfLine = _getEndOfLineFromContent(currentPostion );
+   if(_countTokens(currentPostion, endOfLine) != 2)
+   {
+      throw Exception("Wrong xref in some document");
 
-                  try               
-                  {
-                     std::pair<unsigned int, unsigned int> streamBounds;
-                     bool hasObjectStream;
-                     unsigned int generationNumber;
-                     const std::string content = _getObjectContent(first, objectNumber, generationNumber, streamBounds, hasObjectStream);
-                     if(!_objects.count(objectNumber))
-                     {
-                        Object * newObject = new Object(objectNumber, generationNumber, content, _document->_documentName ,streamBounds, hasObjectStream);
-                        _objects[objectNumber] = newObject;
-                     }
-                  }
-                  catch(std::exception &)
-                  {
-                  }
+   }
+   //now we are reading the xref
+   while(1)
+   {
+      unsigned int firstObjectNumber = Utils::stringToInt(_getNextToken(currentPostion));
+      unsigned int objectCount = Utils::stringToInt(_getNextToken(currentPostion));
+      for(unsigned int i(0); i < objectCount; i++)
+      {
+         unsigned long  first;
 
-               }
+         if(_countTokens(currentPostion, _getEndOfLineFromContent(currentPostion)) == 3)
+         {
+            first  = Utils::stringToInt(_getNextToken(currentPostion));
+            Utils::stringToInt(_getNextToken(currentPostion));
+            const string & use         = _getNextToken(currentPostion);
+            if(!use.compare("n"))
+            {
+               XRefEntry entry = {XRefEntry::InUse, firstObjectNumber + i, first, 0};
+               entries.push_back(entry);
             }
-            else
+            else if(!use.compare("f"))
             {
-               ;
+               XRefEntry entry = {XRefEntry::Free, firstObjectNumber + i, 0, 0};
+               entries.push_back(entry);
             }
-            ++currentPostion;
+         }
+         else
+         {
+            ;
+         }
+         ++currentPostion;
+
 
+      }
+      unsigned int previosPostion = currentPostion;
+      const std::string & isTrailer = _getNextToken(currentPostion);
 
+      std::string trailer("trailer");
+      if(isTrailer == trailer)
+      {
+         currentPostion -= trailer.size();
+         break;
+      }
+      else
+         currentPostion = previosPostion;
+
+   }
+}
+
+//reads PDF 1.5 cross-reference stream, returns true if it has previous section
+bool Parser::_readXRefStream(unsigned int position, std::vector<XRefEntry> & entries, unsigned int & previosXref)
+{
+   unsigned int objectNumber;
+   unsigned int generationNumber;
+   std::pair<unsigned int, unsigned int> streamBounds;
+   bool hasObjectStream;
+   std::string_view content = _getObjectContent(position, objectNumber, generationNumber, streamBounds, hasObjectStream);
+   if(!hasObjectStream || (int)Parser::findToken(content, "/XRef") == -1)
+   {
+      throw Exception("Wrong xref in some document");
+   }
+   std::string_view dictionary = content.substr(0, content.rfind("stream"));
+
+   std::vector<unsigned long> widths = getIntegerArray(dictionary, "/W");
+   unsigned long size = 0;
+   if(widths.size() != 3 || !getIntegerValue(dictionary, "/Size", size))
+   {
+      throw Exception("Wrong xref stream in some document");
+   }
+   const unsigned long entrySize = widths[0] + widths[1] + widths[2];
+   if(entrySize == 0 || widths[0] > 4 || widths[1] > 8 || widths[2] > 8)
+   {
+      throw Exception("Wrong xref stream in some document");
+   }
+   std::vector<unsigned long> index = getIntegerArray(dictionary, "/Index");
+   if(index.empty())
+   {
+      index.push_back(0);
+      index.push_back(size);
+   }
+
+   Object xrefStream(objectNumber, generationNumber, content, _file, streamBounds, hasObjectStream);
+   std::string data;
+   Filter(&xrefStream).getDecodedStream(data);
+
+   size_t offset = 0;
+   for(size_t i = 0; i + 1 < index.size(); i += 2)
+   {
+      for(unsigned long n = 0; n < index[i + 1]; ++n, offset += entrySize)
+      {
+         if(offset + entrySize > data.size())
+         {
+            throw Exception("Wrong xref stream in some document");
+         }
+         //type 1 is the default if the first field is absent
+         unsigned long type = widths[0] ? readXRefField(data, offset, widths[0]) : 1;
+         unsigned long second = readXRefField(data, offset + widths[0], widths[1]);
+         unsigned long third = readXRefField(data, offset + widths[0] + widths[1], widths[2]);
+         if(type == 0)
+         {
+            XRefEntry entry = {XRefEntry::Free, static_cast<unsigned int>(index[i] + n), 0, 0};
+            entries.push_back(entry);
+         }
+         else if(type == 1)
+         {
+            XRefEntry entry = {XRefEntry::InUse, static_cast<unsigned int>(index[i] + n), second, 0};
+            entries.push_back(entry);
          }
-         unsigned int previosPostion = currentPostion;
-         const std::string & isTrailer = _getNextToken(currentPostion);
+         else if(type == 2)
+         {
+            XRefEntry entry = {XRefEntry::Compressed, static_cast<unsigned int>(index[i] + n), second, static_cast<unsigned int>(third)};
+            entries.push_back(entry);
+         }
+      }
+   }
 
-         std::string trailer("trailer");
-         if(isTrailer == trailer)
+   unsigned long previous = 0;
+   if(!getIntegerValue(dictionary, "/Prev", previous))
+      return false;
+   previosXref = previous;
+   return true;
+}
+
+//extracts objects stored in object streams (/Type /ObjStm)
+void Parser::_createCompressedObjects(const std::map<unsigned int, std::pair<unsigned int, unsigned int> > & compressedObjects)
+{
+   //key - number of object stream : value - decoded stream and offsets of its objects
+   std::map<unsigned int, std::pair<std::string, std::vector<unsigned long> > > objectStreams;
+
+   std::map<unsigned int, std::pair<unsigned int, unsigned int> >::const_iterator it = compressedObjects.begin();
+   for(; it != compressedObjects.end(); ++it)
+   {
+      unsigned int streamNumber = it->second.first;
+      std::map<unsigned int, std::pair<std::string, std::vector<unsigned long> > >::iterator objectStream = objectStreams.find(streamNumber);
+      if(objectStream == objectStreams.end())
+      {
+         if(!_objects.count(streamNumber) || !_objects[streamNumber]->hasStream())
          {
-            currentPostion -= trailer.size();
-            break;
+            std::stringstream errorMessage;
+            errorMessage << "Object stream " << streamNumber << " is absent";
+            throw Exception(errorMessage);
          }
-         else
-            currentPostion = previosPostion;
+         Object * streamObject = _objects[streamNumber];
+         std::pair<std::string, std::vector<unsigned long> > & decoded = objectStreams[streamNumber];
+         Filter(streamObject).getDecodedStream(decoded.first);
+
+         std::string_view dictionary = streamObject->getObjectContentView();
+         unsigned long numberOfObjects = 0;
+         unsigned long first = 0;
+         if(!getIntegerValue(dictionary, "/N", numberOfObjects) || !getIntegerValue(dictionary, "/First", first))
+         {
+            throw Exception("Wrong object stream in some document");
+         }
+         //header of object stream is the list of pairs "<object number> <offset>"
+         size_t position = 0;
+         std::string word;
+         for(unsigned long i = 0; i < numberOfObjects; ++i)
+         {
+            if(!getNextWord(word, decoded.first, position) || !getNextWord(word, decoded.first, position))
+            {
+               throw Exception("Wrong object stream in some document");
+            }
+            decoded.second.push_back(first + Utils::stringToInt(word));
+         }
+         objectStream = objectStreams.find(streamNumber);
+      }
 
+      const std::string & data = objectStream->second.first;
+      const std::vector<unsigned long> & offsets = objectStream->second.second;
+      unsigned int index = it->second.second;
+      if(index >= offsets.size() || offsets[index] > data.size())
+      {
+         throw Exception("Wrong object stream in some document");
       }
+      size_t endOfObject = (index + 1 < offsets.size()) ? std::min<size_t>(offsets[index + 1], data.size()) : data.size();
+      if(endOfObject < offsets[index])
+      {
+         throw Exception("Wrong object stream in some document");
+      }
+      Object * newObject = new Object(it->first, 0, data.substr(offsets[index], endOfObject - offsets[index]));
+      _objects[it->first] = newObject;
    }
-   while(_readTrailerAndRterievePrev(currentPostion, currentPostion));
 
+   //object streams are not a part of the document
+   std::map<unsigned int, std::pair<std::string, std::vector<unsigned long> > >::const_iterator streamIt = objectStreams.begin();
+   for(; streamIt != objectStreams.end(); ++streamIt)
+   {
+      delete _objects[streamIt->first];
+      _objects.erase(streamIt->first);
+   }
+}
 
+//returns dictionary of the trailer which follows startOfXref,
+//for cross-reference stream it is dictionary of the stream
+std::string_view Parser::_getTrailer(unsigned int startOfXref)
+{
+   size_t startOfTrailer = Parser::findToken(_fileContent, "trailer", startOfXref);
+   if((int) startOfTrailer != -1)
+   {
+      size_t endOfTrailer = _fileContent.find("startxref", startOfTrailer);
+      return _fileContent.substr(startOfTrailer, endOfTrailer - startOfTrailer);
+   }
+   size_t startOfStream = _fileContent.find("stream", startOfXref);
+   if((int) startOfStream == -1 || _fileContent.find("/XRef", startOfXref) > startOfStream)
+   {
+      throw Exception("Cannot find trailer!");
+   }
+   return _fileContent.substr(startOfXref, startOfStream - startOfXref);
 }
 
 unsigned int Parser::_getStartOfXrefWithRoot()
@@ -371,7 +633,7 @@ unsigned int Parser::_getStartOfXrefWithRoot()
 
    unsigned int rightBoundOfStartOfXref = _fileContent.find_first_not_of(NUMBERS, leftBoundOfStartOfXref + 1);
 
-   std::string  startOfXref = _fileContent.substr(leftBoundOfStartOfXref, rightBoundOfStartOfXref - leftBoundOfStartOfXref);
+   std::string  startOfXref(_fileContent.substr(leftBoundOfStartOfXref, rightBoundOfStartOfXref - leftBoundOfStartOfXref));
    int integerStartOfXref = Utils::stringToInt(startOfXref);
    return integerStartOfXref;
 }
@@ -452,7 +714,7 @@ unsigned int Parser::_skipWhiteSpacesFromContent(unsigned int fromPosition)
    return position;
 }
 
-const std::string & Parser::_getObjectContent(unsigned int objectPosition, unsigned int & objectNumber, unsigned int & generationNumber, std::pair<unsigned int, unsigned int> & streamBounds, bool & hasObjectStream)
+std::string_view Parser::_getObjectContent(unsigned int objectPosition, unsigned int & objectNumber, unsigned int & generationNumber, std::pair<unsigned int, unsigned int> & streamBounds, bool & hasObjectStream)
 {
    hasObjectStream = false;
    unsigned int currentPosition = objectPosition;
@@ -472,8 +734,6 @@ const std::string & Parser::_getObjectContent(unsigned int objectPosition, unsig
       throw Exception(strOut.str());
    }
 
-   static std::string objectContent;
-
    size_t contentStart = _fileContent.find_first_not_of(Parser::WHITESPACES,currentPosition);
    if((int) contentStart == -1 )
    {
@@ -547,33 +807,25 @@ const std::string & Parser::_getObjectContent(unsigned int objectPosition, unsig
    }
    unsigned int contentSize = endOfContent - currentPosition;
 
-   objectContent.resize(contentSize);
-   memcpy(&objectContent[0], &_fileContent[currentPosition], contentSize);
-   return objectContent;
+   return _fileContent.substr(currentPosition, contentSize);
 
 }
 
 unsigned int Parser::_readTrailerAndReturnRoot()
 {
-
-   unsigned int startOfTrailer = Parser::findToken(_fileContent,"trailer", _getStartOfXrefWithRoot());
+   const std::string_view trailer = _getTrailer(_getStartOfXrefWithRoot());
    std::string rootStr("/Root");
-   unsigned int startOfRoot = Parser::findToken(_fileContent,rootStr.data(), startOfTrailer);
-   if((int) startOfRoot == -1)
+   unsigned long root = 0;
+   if(!getIntegerValue(trailer, rootStr, root))
    {
       throw Exception("Cannot find Root object !");
    }
    std::string encryptStr("/Encrypt");
-   if((int) Parser::findToken(_fileContent,encryptStr,startOfTrailer) != -1 )
+   if((int) Parser::findToken(trailer,encryptStr) != -1 )
    {
       throw Exception("Encrypted PDF is not supported!");
    }
-   startOfRoot += rootStr.size()+1; //"/Root + ' ' 
-   unsigned int endOfRoot = startOfRoot;
-   while((int)NUMBERS.find(_fileContent[endOfRoot++]) != -1)
-   {}
-   --endOfRoot;
-   return Utils::stringToInt(_fileContent.substr(startOfRoot, endOfRoot - startOfRoot));   
+   return root;
 }
 
 unsigned int Parser::_readTrailerAndRterievePrev(const unsigned int startPositionForSearch, unsigned int & previosXref)
@@ -596,14 +848,14 @@ unsigned int Parser::_readTrailerAndRterievePrev(const unsigned int startPositio
    while((int)NUMBERS.find(_fileContent[endOfPrev++]) != -1)
    {}
    --endOfPrev;
-   previosXref = Utils::stringToInt(_fileContent.substr(startOfPrev, endOfPrev - startOfPrev));   
+   previosXref = Utils::stringToInt(std::string(_fileContent.substr(startOfPrev, endOfPrev - startOfPrev)));   
    return true;
 }
 
 //Method finds the token from current position from string
 // It uses PDF whitespaces and delimeters to recognize
 // Returned string without begin/end spaces
-std::string Parser::getNextToken(const std::string &str, unsigned int  &position)
+std::string Parser::getNextToken(std::string_view str, unsigned int  &position)
 {
    if( position >= str.size() )
    {
@@ -623,7 +875,7 @@ std::string Parser::getNextToken(const std::string &str, unsigned int  &position
    }
    position = end_pos;
 
-   std::string out = str.substr(beg_pos,end_pos - beg_pos);
+   std::string out(str.substr(beg_pos,end_pos - beg_pos));
    Parser::trim(out);
    return out;
 }
@@ -632,7 +884,7 @@ std::string Parser::getNextToken(const std::string &str, unsigned int  &position
 * method finds and returns next word from the string
 * For example: " 1 0 R \n" will return "1" , then "0" then "R"
 */
-bool Parser::getNextWord(std::string &out, const std::string &str, size_t &nextPosition, size_t  *found)
+bool Parser::getNextWord(std::string &out, std::string_view str, size_t &nextPosition, size_t  *found)
 {
    if( found )
    {
@@ -661,7 +913,7 @@ bool Parser::getNextWord(std::string &out, const std::string &str, size_t &nextP
       end_pos = str.size();
    }
    nextPosition = end_pos;
-   out = str.substr(beg_pos,end_pos - beg_pos);
+   out.assign(str.data() + beg_pos, end_pos - beg_pos);
    Parser::trim(out);
    if( out.empty() )
    {
@@ -710,7 +962,7 @@ std::string Parser::findTokenStr(const std::string &content, const std::string &
 // contains token but not euqal to it
 // Example: content "/Transparency/ ..." pattern "/Trans
 //          will return npos.
-size_t Parser::findToken(const std::string &content, const std::string &keyword,size_t start)
+size_t Parser::findToken(std::string_view content, std::string_view keyword,size_t start)
 {
    size_t cur_pos  = start;
    // lets find pattern first
@@ -749,7 +1001,7 @@ size_t Parser::findToken(const std::string &content, const std::string &keyword,
 // /H /P /P 12 0 R
 // the tag /P can be a name (and a value also), while 12 cannot
 // start defines the position of token content
-bool Parser::tokenIsAName(const std::string &content, size_t start )
+bool Parser::tokenIsAName(std::string_view content, size_t start )
 {
    std::string openBraces = "<[({";
    bool found = false;
@@ -796,7 +1048,7 @@ bool Parser::tokenIsAName(const std::string &content, size_t start )
 // For example, the string contains /H /P /P 12 0 R.
 // If search for /P then it will return position of /P 12 0 R, not value of 
 // /H /P
-size_t Parser::findTokenName(const std::string &content, const std::string &keyword,size_t start)
+size_t Parser::findTokenName(std::string_view content, std::string_view keyword,size_t start)
 {
    size_t cur_pos  = start;
    // lets find pattern first
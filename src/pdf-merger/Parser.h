@@ -33,8 +33,12 @@
 #include "Object.h"
 #include "Document.h"
 #include "Page.h"
+#include "MappedFile.h"
 
+#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -44,10 +48,15 @@ namespace merge_lib
 
    //This class parsed the pdf document and creates
    //an Document object
+   //The document is parsed over a mapping of the file: the xref table is read first,
+   //then objects are created as views into the mapping. Object content is copied
+   //only when the merger modifies it.
+   //Both classic xref tables and PDF 1.5 cross-reference streams are read,
+   //objects stored in object streams are decoded into separate objects.
    class Parser
    {
    public:   
-      Parser(): _root(0), _fileContent(), _objects(), _document(0)  {};
+      Parser(): _root(0), _file(), _fileContent(), _objects(), _document(0)  {};
       Document * parseDocument(const char * fileName);
 
       static const std::string WHITESPACES;
@@ -55,19 +64,31 @@ namespace merge_lib
       static const std::string NUMBERS;
       static const std::string WHITESPACES_AND_DELIMETERS;
 
-      static bool getNextWord(std::string & out, const std::string &in, size_t &nextPosition,size_t *found = NULL);
-      static std::string getNextToken( const std::string &in, unsigned &position);
+      static bool getNextWord(std::string & out, std::string_view in, size_t &nextPosition,size_t *found = NULL);
+      static std::string getNextToken(std::string_view in, unsigned &position);
       static void trim(std::string &str);
       static std::string findTokenStr(const std::string &content, const std::string &pattern, size_t start,size_t &foundStart, size_t &foundEnd); 
 
-      static size_t findToken(const std::string &content, const std::string &keyword,size_t start = 0);
-      static size_t findTokenName(const std::string &content, const std::string &keyword,size_t start = 0);
+      static size_t findToken(std::string_view content, std::string_view keyword,size_t start = 0);
+      static size_t findTokenName(std::string_view content, std::string_view keyword,size_t start = 0);
       static unsigned int findEndOfElementContent(const std::string &content, unsigned int startOfPageElement);
-      static bool tokenIsAName(const std::string &content, size_t start );
+      static bool tokenIsAName(std::string_view content, size_t start );
    protected:
-      const std::string &                           _getObjectContent(unsigned int objectPosition, unsigned int & objectNumber, unsigned int & generationNumber, std::pair<unsigned int, unsigned int> &, bool &);
+      std::string_view                              _getObjectContent(unsigned int objectPosition, unsigned int & objectNumber, unsigned int & generationNumber, std::pair<unsigned int, unsigned int> &, bool &);
       virtual unsigned int                          _readTrailerAndReturnRoot();
    private:
+      //one entry of classic xref table or cross-reference stream
+      struct XRefEntry
+      {
+         enum Type {Free, InUse, Compressed};
+         Type          type;
+         unsigned int  objectNumber;
+         //offset of object in file or number of object stream for compressed object
+         unsigned long position;
+         //index of compressed object in its object stream
+         unsigned int  index;
+      };
+
       //methods
       virtual void                                  _getFileContent(const char * fileName);
       bool                                          _getNextObject(Object * object);
@@ -76,14 +97,18 @@ namespace merge_lib
       void                                          _retrieveAllPages(Object * objectWithKids);
       void                                          _fillOutObjects();
       virtual void                                  _readXRefAndCreateObjects();
+      void                                          _readXRefTable(unsigned int & currentPostion, std::vector<XRefEntry> & entries);
+      bool                                          _readXRefStream(unsigned int position, std::vector<XRefEntry> & entries, unsigned int & previosXref);
+      void                                          _createCompressedObjects(const std::map<unsigned int, std::pair<unsigned int, unsigned int> > & compressedObjects);
+      std::string_view                              _getTrailer(unsigned int startOfXref);
       unsigned int                                  _getEndOfLineFromContent(unsigned int fromPosition);
       const std::pair<unsigned int, unsigned int> & _getLineBounds(const std::string & str, unsigned int fromPosition);
       const std::string &                           _getNextToken(unsigned int & fromPosition);
       unsigned int                                  _countTokens(unsigned int leftBound, unsigned int rightBount);
       unsigned int                                  _skipWhiteSpaces(const std::string & str);
       unsigned int                                  _skipWhiteSpacesFromContent(unsigned int fromPosition);
-      const std::map<unsigned int, Object::ReferencePositionsInContent> & _getReferences(const std::string & objectContent);
-      unsigned int                                  _skipNumber(const std::string & str, unsigned int currentPosition);      
+      const std::map<unsigned int, Object::ReferencePositionsInContent> & _getReferences(std::string_view objectContent);
+      unsigned int                                  _skipNumber(std::string_view str, unsigned int currentPosition);      
       unsigned int                                  _skipWhiteSpaces(const std::string & str, unsigned int fromPosition);
       void                                          _createDocument(const char * docName);      
       virtual unsigned int                          _getStartOfXrefWithRoot();
@@ -95,7 +120,9 @@ namespace merge_lib
 
       //members
       Object *                         _root;
-      std::string                      _fileContent;
+      std::shared_ptr<MappedFile>      _file;
+      //view of _file which is parsed now
+      std::string_view                 _fileContent;
       std::map<unsigned int, Object *> _objects;
       Document *                       _document;
       
@@ -42,6 +42,8 @@ GraphicsPDFItem::GraphicsPDFItem(PDFRenderer *renderer, int pageNumber, QGraphic
     , mIsCacheAllowed(true)
 {
     setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    // the renderer only needs the tiles of the exposed area
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
     mRenderer->attach();
     connect(mRenderer, SIGNAL(signalUpdateParent()), this, SLOT(OnRequireUpdate()));
 }
@@ -74,12 +76,20 @@ void GraphicsPDFItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
 
     if (option)
     {
-        mRenderer->render(painter, mPageNumber, mIsCacheAllowed, option->exposedRect);
+        mRenderer->render(painter, mPageNumber, mIsCacheAllowed, option->exposedRect, renderPriority(widget));
     } else
         qWarning("GraphicsPDFItem::paint: option is null, ignoring painting");
 
 }
 
+PDFRenderer::RenderPriority GraphicsPDFItem::renderPriority(const QWidget *widget) const
+{
+    Q_UNUSED(widget)
+
+    // thumbnails, imports and exports do not allow the cache, they are rendered in place
+    return PDFRenderer::BoardPriority;
+}
+
 void GraphicsPDFItem::OnRequireUpdate()
 {
     updateChild();
@@ -55,6 +55,8 @@ class GraphicsPDFItem : public QObject, public QGraphicsItem
         QSizeF pageSize() const { return mRenderer->pointSizeF(mPageNumber); }
         virtual void updateChild() = 0;
     protected:
+        virtual PDFRenderer::RenderPriority renderPriority(const QWidget *widget) const;
+
         PDFRenderer *mRenderer;
         int mPageNumber;
         bool mIsCacheAllowed;
@@ -45,6 +45,14 @@ class PDFRenderer : public QObject
     Q_OBJECT
 
     public:
+        //! Urgency of a rendering request, lower values are served first.
+        enum RenderPriority
+        {
+            BoardPriority,
+            DisplayPriority,
+            PrefetchPriority
+        };
+
         static PDFRenderer* rendererForUuid(const QUuid &uuid, const QString &filename, bool importingFile = false);
         virtual ~PDFRenderer();
 
@@ -68,7 +76,7 @@ class PDFRenderer : public QObject
 
         void setDPI(int desiredDPI) { this->dpiForRendering = desiredDPI; }
 
-        virtual void render(QPainter *p, int pageNumber, bool const cacheAllowed, const QRectF &bounds = QRectF()) = 0;
+        virtual void render(QPainter *p, int pageNumber, bool const cacheAllowed, const QRectF &bounds = QRectF(), RenderPriority priority = BoardPriority) = 0;
 
     private:
         QAtomicInt mRefCount;
@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "XPDFRenderScheduler.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QThread>
+
+#include <poppler/GlobalParams.h>
+#include <poppler/PDFDoc.h>
+#include <poppler/SplashOutputDev.h>
+#include <poppler/cpp/poppler-version.h>
+#include <splash/SplashBitmap.h>
+
+#include "XPDFRenderer.h"
+
+#include "core/UBSettings.h"
+#include "core/UBSetting.h"
+
+namespace
+{
+    SplashColor paperColor = {0xFF, 0xFF, 0xFF}; // white
+
+    // limits the work left behind when the view moves faster than the tiles are rendered
+    const int maxQueuedJobs = 64;
+
+    // documents kept open by each worker
+    const int maxWorkerDocuments = 4;
+}
+
+class XPDFRenderScheduler::Worker : public QThread
+{
+public:
+    explicit Worker(XPDFRenderScheduler* scheduler)
+        : mScheduler(scheduler)
+    {
+    }
+
+    ~Worker()
+    {
+        qDeleteAll(mDocuments);
+    }
+
+    // must be called with the scheduler mutex held and no job of the renderer running
+    void removeDocuments(quint64 rendererId)
+    {
+        for (auto it = mDocuments.begin(); it != mDocuments.end();)
+        {
+            if ((*it)->rendererId == rendererId)
+            {
+                delete *it;
+                it = mDocuments.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+protected:
+    void run() override
+    {
+        Job job;
+
+        while (mScheduler->takeJob(job))
+        {
+            Document* document = this->document(job);
+            QImage tile;
+
+            if (document)
+            {
+                int rotation = 0; // in degrees
+                bool useMediaBox = false;
+                bool crop = true;
+                bool printing = false;
+
+                document->document->displayPageSlice(document->splash, job.key.pageNumber, job.dpi, job.dpi,
+                                                     rotation, useMediaBox, crop, printing,
+                                                     job.slice.x(), job.slice.y(), job.slice.width(), job.slice.height());
+
+                SplashBitmap* bitmap = document->splash->getBitmap();
+
+                // The bitmap is owned by the splash device, the conversion creates an independent copy.
+                tile = QImage(bitmap->getDataPtr(), bitmap->getWidth(), bitmap->getHeight(), bitmap->getRowSize(), QImage::Format_RGB888)
+                        .convertToFormat(QImage::Format_RGB32);
+            }
+
+            mScheduler->finishJob(job, tile);
+        }
+    }
+
+private:
+    struct Document
+    {
+        quint64 rendererId;
+        PDFDoc* document;
+        SplashOutputDev* splash;
+
+        ~Document()
+        {
+            delete splash;
+            delete document;
+        }
+    };
+
+    Document* document(const Job& job)
+    {
+        {
+            QMutexLocker lock(&mScheduler->mMutex);
+
+            for (int i = 0; i < mDocuments.size(); ++i)
+            {
+                if (mDocuments.at(i)->rendererId == job.key.rendererId)
+                {
+                    mDocuments.move(i, 0);
+                    return mDocuments.first();
+                }
+            }
+        }
+
+        // opening the document takes time, the renderer cannot be removed while its job is running
+        PDFDoc* pdfDocument = openDocument(job.fileName);
+
+        if (!pdfDocument->isOk())
+        {
+            qWarning() << "XPDFRenderScheduler: cannot open" << job.fileName;
+            delete pdfDocument;
+            return nullptr;
+        }
+
+        Document* document = new Document{job.key.rendererId, pdfDocument, new SplashOutputDev(splashModeRGB8, 1, false, paperColor)};
+        document->splash->startDoc(pdfDocument);
+
+        QMutexLocker lock(&mScheduler->mMutex);
+        mDocuments.prepend(document);
+
+        while (mDocuments.size() > maxWorkerDocuments)
+        {
+            delete mDocuments.takeLast();
+        }
+
+        return document;
+    }
+
+    XPDFRenderScheduler* mScheduler;
+    QList<Document*> mDocuments; // most recently used first, guarded by the scheduler mutex
+};
+
+XPDFRenderScheduler::XPDFRenderScheduler()
+{
+    mTileCacheLimit = UBSettings::settings()->pdfTileCacheMemoryLimit->get().toLongLong() * 1024 * 1024;
+
+    // leave one core to the GUI thread
+    const int workerCount = qBound(1, QThread::idealThreadCount() - 1, 8);
+
+    for (int i = 0; i < workerCount; ++i)
+    {
+        Worker* worker = new Worker(this);
+        worker->start(QThread::LowPriority);
+        mWorkers << worker;
+    }
+}
+
+XPDFRenderScheduler::~XPDFRenderScheduler()
+{
+    {
+        QMutexLocker lock(&mMutex);
+        mStopping = true;
+        mJobAvailable.wakeAll();
+    }
+
+    for (Worker* worker : std::as_const(mWorkers))
+    {
+        worker->wait();
+        delete worker;
+    }
+}
+
+XPDFRenderScheduler& XPDFRenderScheduler::scheduler()
+{
+    static XPDFRenderScheduler scheduler;
+    return scheduler;
+}
+
+PDFDoc* XPDFRenderScheduler::openDocument(const QString& fileName)
+{
+#if POPPLER_VERSION_MAJOR > 22 || (POPPLER_VERSION_MAJOR == 22 && POPPLER_VERSION_MINOR >= 3)
+    return new PDFDoc(std::make_unique<GooString>(fileName.toLocal8Bit()));
+#else
+    return new PDFDoc(new GooString(fileName.toLocal8Bit()), 0, 0, 0); // the filename GString is deleted on PDFDoc desctruction
+#endif
+}
+
+void XPDFRenderScheduler::addRenderer(quint64 rendererId, XPDFRenderer* renderer)
+{
+    QMutexLocker lock(&mMutex);
+    mRenderers.insert(rendererId, renderer);
+}
+
+/**
+ * @brief Forget a renderer.
+ *
+ * Queued jobs are discarded and running jobs are awaited, so that the documents opened
+ * by the workers for this renderer can be closed before the renderer is deleted.
+ */
+void XPDFRenderScheduler::removeRenderer(quint64 rendererId)
+{
+    QMutexLocker lock(&mMutex);
+
+    mRenderers.remove(rendererId);
+
+    for (auto& jobs : mJobs)
+    {
+        for (auto it = jobs.begin(); it != jobs.end();)
+        {
+            if (it->key.rendererId == rendererId)
+            {
+                mScheduledTiles.remove(it->key);
+                it = jobs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    while (mRunningJobs.contains(rendererId))
+    {
+        mJobFinished.wait(&mMutex);
+    }
+
+    for (Worker* worker : std::as_const(mWorkers))
+    {
+        worker->removeDocuments(rendererId);
+    }
+
+    for (auto it = mLru.begin(); it != mLru.end();)
+    {
+        if (it->key.rendererId == rendererId)
+        {
+            mTileCacheSize -= it->tile.sizeInBytes();
+            mTiles.remove(it->key);
+            it = mLru.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Queue the rendering of a tile.
+ *
+ * A tile already scheduled at a lower priority is promoted. When a view changes its zoom level,
+ * the jobs queued for the previous level of the page are obsolete and discarded.
+ *
+ * @return true if a new job was queued.
+ */
+bool XPDFRenderScheduler::schedule(const Job& job)
+{
+    QMutexLocker lock(&mMutex);
+
+    if (!mRenderers.contains(job.key.rendererId))
+    {
+        return false;
+    }
+
+    if (mScheduledTiles.contains(job.key))
+    {
+        for (int priority = job.priority + 1; priority <= PDFRenderer::PrefetchPriority; ++priority)
+        {
+            for (int i = 0; i < mJobs[priority].size(); ++i)
+            {
+                if (mJobs[priority].at(i).key == job.key)
+                {
+                    Job promoted = mJobs[priority].takeAt(i);
+                    promoted.priority = job.priority;
+                    mJobs[job.priority].prepend(promoted);
+                    return false;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    QList<Job>& jobs = mJobs[job.priority];
+
+    if (job.priority == PDFRenderer::BoardPriority || job.priority == PDFRenderer::DisplayPriority)
+    {
+        for (auto it = jobs.begin(); it != jobs.end();)
+        {
+            if (it->key.rendererId == job.key.rendererId && it->key.pageNumber == job.key.pageNumber && it->key.level != job.key.level)
+            {
+                mScheduledTiles.remove(it->key);
+                it = jobs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // the most recently requested tiles are rendered first
+    jobs.prepend(job);
+    mScheduledTiles.insert(job.key);
+
+    while (jobs.size() > maxQueuedJobs)
+    {
+        mScheduledTiles.remove(jobs.takeLast().key);
+    }
+
+    mJobAvailable.wakeOne();
+    return true;
+}
+
+QImage XPDFRenderScheduler::tile(const PdfTileKey& key)
+{
+    QMutexLocker lock(&mMutex);
+    auto it = mTiles.find(key);
+
+    if (it == mTiles.end())
+    {
+        return QImage();
+    }
+
+    mLru.splice(mLru.begin(), mLru, it.value());
+    return it.value()->tile;
+}
+
+bool XPDFRenderScheduler::takeJob(Job& job)
+{
+    QMutexLocker lock(&mMutex);
+
+    forever
+    {
+        if (mStopping)
+        {
+            return false;
+        }
+
+        for (auto& jobs : mJobs)
+        {
+            if (!jobs.isEmpty())
+            {
+                job = jobs.takeFirst();
+                ++mRunningJobs[job.key.rendererId];
+                return true;
+            }
+        }
+
+        mJobAvailable.wait(&mMutex);
+    }
+}
+
+void XPDFRenderScheduler::finishJob(const Job& job, const QImage& tile)
+{
+    const quint64 rendererId = job.key.rendererId;
+
+    {
+        QMutexLocker lock(&mMutex);
+
+        mScheduledTiles.remove(job.key);
+
+        if (!tile.isNull() && mRenderers.contains(rendererId))
+        {
+            auto it = mTiles.find(job.key);
+
+            if (it != mTiles.end())
+            {
+                mTileCacheSize -= it.value()->tile.sizeInBytes();
+                mLru.erase(it.value());
+                mTiles.erase(it);
+            }
+
+            mLru.push_front({job.key, tile});
+            mTiles.insert(job.key, mLru.begin());
+            mTileCacheSize += tile.sizeInBytes();
+            evictTiles();
+        }
+
+        if (--mRunningJobs[rendererId] == 0)
+        {
+            mRunningJobs.remove(rendererId);
+        }
+
+        mJobFinished.wakeAll();
+    }
+
+    QMetaObject::invokeMethod(qApp, [rendererId]() {
+        XPDFRenderScheduler::scheduler().notifyRenderer(rendererId);
+    }, Qt::QueuedConnection);
+}
+
+void XPDFRenderScheduler::notifyRenderer(quint64 rendererId)
+{
+    XPDFRenderer* renderer = nullptr;
+
+    {
+        QMutexLocker lock(&mMutex);
+        renderer = mRenderers.value(rendererId);
+    }
+
+    if (renderer)
+    {
+        emit renderer->signalUpdateParent();
+    }
+}
+
+void XPDFRenderScheduler::evictTiles()
+{
+    // keep at least the tile just inserted
+    while (mTileCacheSize > mTileCacheLimit && mLru.size() > 1)
+    {
+        const TileEntry& last = mLru.back();
+        mTileCacheSize -= last.tile.sizeInBytes();
+        mTiles.remove(last.key);
+        mLru.pop_back();
+    }
+}
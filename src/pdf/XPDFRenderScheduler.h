@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2015-2025 Département de l'Instruction Publique (DIP-SEM)
+ *
+ * This file is part of OpenBoard.
+ *
+ * OpenBoard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License,
+ * with a specific linking exception for the OpenSSL project's
+ * "OpenSSL" library (or with modified versions of it that use the
+ * same license as the "OpenSSL" library).
+ *
+ * OpenBoard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenBoard. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QRect>
+#include <QSet>
+#include <QString>
+#include <QWaitCondition>
+
+#include <list>
+
+#include "PDFRenderer.h"
+
+class PDFDoc;
+class XPDFRenderer;
+
+//! Identifies a rendered tile of a page at a zoom level.
+struct PdfTileKey
+{
+    quint64 rendererId;
+    int pageNumber;
+    int level;
+    int column;
+    int row;
+
+    bool operator==(const PdfTileKey& other) const
+    {
+        return rendererId == other.rendererId && pageNumber == other.pageNumber && level == other.level
+                && column == other.column && row == other.row;
+    }
+};
+
+inline uint qHash(const PdfTileKey& key, uint seed = 0)
+{
+    uint hash = qHash(key.rendererId, seed);
+    hash ^= qHash(key.pageNumber, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.level, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.column, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= qHash(key.row, seed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+/**
+ * @brief The XPDFRenderScheduler class renders the PDF tiles of all XPDFRenderer instances.
+ *
+ * Jobs are processed by a bounded pool of worker threads, most urgent priority first and
+ * most recent request first within a priority. Each worker opens its own PDFDoc and keeps
+ * one SplashOutputDev per document, so that pages of the same document can be rendered in
+ * parallel and the fonts are only loaded once per worker.
+ *
+ * The rendered tiles are kept in a least recently used cache shared by all renderers.
+ */
+class XPDFRenderScheduler
+{
+public:
+    struct Job
+    {
+        PdfTileKey key;
+        QString fileName;
+        double dpi;
+        QRect slice;
+        PDFRenderer::RenderPriority priority;
+    };
+
+    static XPDFRenderScheduler& scheduler();
+    static PDFDoc* openDocument(const QString& fileName);
+
+    void addRenderer(quint64 rendererId, XPDFRenderer* renderer);
+    void removeRenderer(quint64 rendererId);
+
+    bool schedule(const Job& job);
+    QImage tile(const PdfTileKey& key);
+
+private:
+    class Worker;
+
+    XPDFRenderScheduler();
+    ~XPDFRenderScheduler();
+
+    bool takeJob(Job& job);
+    void finishJob(const Job& job, const QImage& tile);
+    void notifyRenderer(quint64 rendererId);
+    void evictTiles();
+
+    struct TileEntry
+    {
+        PdfTileKey key;
+        QImage tile;
+    };
+
+    QMutex mMutex;
+    QWaitCondition mJobAvailable;
+    QWaitCondition mJobFinished;
+    bool mStopping{false};
+
+    QList<Job> mJobs[PDFRenderer::PrefetchPriority + 1];
+    QSet<PdfTileKey> mScheduledTiles;
+    QHash<quint64, int> mRunningJobs;
+    QHash<quint64, QPointer<XPDFRenderer>> mRenderers;
+    QList<Worker*> mWorkers;
+
+    std::list<TileEntry> mLru;
+    QHash<PdfTileKey, std::list<TileEntry>::iterator> mTiles;
+    qint64 mTileCacheSize{0};
+    qint64 mTileCacheLimit{0};
+};
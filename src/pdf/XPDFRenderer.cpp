@@ -31,6 +31,8 @@
 
 #include <QtGui>
 
+#include <cmath>
+
 #include <frameworks/UBPlatformUtils.h>
 #include <poppler/cpp/poppler-version.h>
 
@@ -39,6 +41,7 @@
 
 
 QAtomicInt XPDFRenderer::sInstancesCount = 0;
+QAtomicInteger<quint64> XPDFRenderer::sNextRendererId = 0;
 
 namespace constants{
     SplashColor paperColor = {0xFF, 0xFF, 0xFF}; // white
@@ -48,6 +51,8 @@ XPDFRenderer::XPDFRenderer(const QString &filename, bool importingFile)
     : mpSplashBitmapUncached(nullptr)
     , mSplashUncached(nullptr)
     , mDocument(nullptr)
+    , mFileName(filename)
+    , mRendererId(++sNextRendererId)
 {
     Q_UNUSED(importingFile);
     if (!globalParams)
@@ -61,18 +66,12 @@ XPDFRenderer::XPDFRenderer(const QString &filename, bool importingFile)
 #endif
         globalParams->setupBaseFonts(QFile::encodeName(UBPlatformUtils::applicationResourcesDirectory() + "/" + "fonts").data());
     }
-#if POPPLER_VERSION_MAJOR > 22 || (POPPLER_VERSION_MAJOR == 22 && POPPLER_VERSION_MINOR >= 3)
-    mDocument = new PDFDoc(std::make_unique<GooString>(filename.toLocal8Bit()));
-#else
-    mDocument = new PDFDoc(new GooString(filename.toLocal8Bit()), 0, 0, 0); // the filename GString is deleted on PDFDoc desctruction
-#endif
+    mDocument = XPDFRenderScheduler::openDocument(filename);
 
     if (isValid())
     {
-        initPDFZoomData();
-
         sInstancesCount.ref();
-        connect(&m_cacheThread, SIGNAL(finished()), this, SLOT(OnThreadFinished()));
+        XPDFRenderScheduler::scheduler().addRenderer(mRendererId, this);
     }
     else
     {
@@ -82,24 +81,8 @@ XPDFRenderer::XPDFRenderer(const QString &filename, bool importingFile)
 
 XPDFRenderer::~XPDFRenderer()
 {
-    disconnect(&m_cacheThread, SIGNAL(finished()), this, SLOT(OnThreadFinished()));
-    m_cacheThread.cancelPending();
-    m_cacheThread.wait(XPDFThreadMaxTimeoutOnExit::timeout_ms);
-    if (m_cacheThread.isRunning())
-    {
-        // Kill the thread, which might still run for minutes if the user choose a heavy pdf highly zoomed.
-        // Since there is no data written, but only processing, this is safe on a modern OS.
-        m_cacheThread.terminate();
-    }
-
-    foreach (QVector<PdfZoomCacheData> v, m_perPagepdfZoomCache)
-    {
-        for(int i = 0; i < v.size(); i++)
-        {
-            PdfZoomCacheData &cacheData = v[i];
-            cacheData.cleanup();
-        }
-    }
+    // also closes the copies of the document opened by the scheduler workers
+    XPDFRenderScheduler::scheduler().removeRenderer(mRendererId);
 
     if(mSplashUncached)
         delete mSplashUncached;
@@ -121,20 +104,6 @@ XPDFRenderer::~XPDFRenderer()
     }
 }
 
-void XPDFRenderer::initPDFZoomData()
-{
-    for (int i=1; i <= mDocument->getNumPages(); i++)
-    {
-        m_perPagepdfZoomCache.insert(i, QVector<PdfZoomCacheData>());
-
-        for (int j = 0; j < XPDFRendererZoomFactor::zoomFactorIterations; j++ )
-        {
-            double const zoomValue = XPDFRendererZoomFactor::zoomFactorStart+XPDFRendererZoomFactor::zoomFactorStepSquare*static_cast<double>(j*j);
-            m_perPagepdfZoomCache[i].push_back(zoomValue);
-        }
-    }
-}
-
 bool XPDFRenderer::isValid() const
 {
     if (mDocument)
@@ -264,180 +233,205 @@ QImage* XPDFRenderer::createPDFImageUncached(int pageNumber, qreal xscale, qreal
     return new QImage(mpSplashBitmapUncached->getDataPtr(), mpSplashBitmapUncached->getWidth(), mpSplashBitmapUncached->getHeight(), mpSplashBitmapUncached->getWidth() * 3, QImage::Format_RGB888);
 }
 
-void XPDFRenderer::OnThreadFinished()
+void XPDFRenderer::render(QPainter *p, int pageNumber, bool const cacheAllowed, const QRectF &bounds, RenderPriority priority)
 {
-    emit signalUpdateParent();
-    if (m_cacheThread.isJobPending())
-        m_cacheThread.start();
-}
-
-void XPDFRenderer::render(QPainter *p, int pageNumber, bool const cacheAllowed, const QRectF &bounds)
-{
-    //qDebug() << "render enter";
-    Q_UNUSED(bounds);
     if (isValid())
     {
-        if (m_perPagepdfZoomCache.contains(pageNumber) && m_perPagepdfZoomCache[pageNumber].size() > 0 && cacheAllowed)
+        if (cacheAllowed)
         {
+            renderTiles(p, pageNumber, bounds, priority);
+        } else {
             qreal xscale = p->worldTransform().m11();
             qreal yscale = p->worldTransform().m22();
-            Q_ASSERT(qFuzzyCompare(xscale, yscale)); // Zoom equal in all axes expected.
-            Q_ASSERT(xscale > 0.0); // Potential Div0 later if this assert fail.
 
-            qreal zoomRequested = xscale;
-            int zoomIndex = 0;
+            QImage *pdfImage = createPDFImageUncached(pageNumber, xscale, yscale, bounds);
+            QTransform savedTransform = p->worldTransform();
+            p->resetTransform();
+            p->drawImage(QPointF(savedTransform.dx() + mSliceX, savedTransform.dy() + mSliceY), *pdfImage);
+            p->setWorldTransform(savedTransform);
+            delete pdfImage;
+        }
+    }
+}
+
+/**
+ * Draw the tiles covering the exposed part of the page at the zoom level matching the painter.
+ * Missing tiles are queued on the render scheduler and replaced by tiles of another zoom level, if available.
+ * For the board, the ring of tiles around the exposed area is prefetched to keep panning smooth.
+ */
+void XPDFRenderer::renderTiles(QPainter *p, int pageNumber, const QRectF &bounds, RenderPriority priority)
+{
+    qreal scale = p->worldTransform().m11();
+    Q_ASSERT(qFuzzyCompare(scale, p->worldTransform().m22())); // Zoom equal in all axes expected.
+    Q_ASSERT(scale > 0.0);
 
-            // Choose a zoom which is superior or equivalent than the user choice (= no loss, upscaling).
-            bool foundIndex = false;
-            for (; zoomIndex < m_perPagepdfZoomCache[pageNumber].size() && !foundIndex;)
-            {
-                if (zoomRequested <= (m_perPagepdfZoomCache[pageNumber][zoomIndex].ratio+0.1)) {
-                    foundIndex = true;
-                } else {
-                    zoomIndex++;
-                }
-            }
+    const int level = tileLevel(scale);
+    const qreal ratio = tileRatio(level);
+
+    const QRectF pageRect(QPointF(0, 0), pageSizeF(pageNumber));
+    const QRectF exposedRect = bounds.isNull() ? pageRect : bounds & pageRect;
 
-            if (!foundIndex) // Use the previous one.
-                zoomIndex--;
+    if (exposedRect.isEmpty())
+    {
+        return;
+    }
 
-            QImage pdfImage = createPDFImageCached(pageNumber, m_perPagepdfZoomCache[pageNumber][zoomIndex]);
-            qreal ratioExpected = m_perPagepdfZoomCache[pageNumber][zoomIndex].ratio;
-            qreal ratioObtained = ratioExpected;
-            int const initialZoomIndex = zoomIndex;
+    const QRect pixelRect = QRectF(exposedRect.topLeft() * ratio, exposedRect.size() * ratio).toAlignedRect();
+    const int tileSize = XPDFRendererTiles::tileSize;
+    const int firstRow = pixelRect.top() / tileSize;
+    const int lastRow = pixelRect.bottom() / tileSize;
+    const int firstColumn = pixelRect.left() / tileSize;
+    const int lastColumn = pixelRect.right() / tileSize;
+    XPDFRenderScheduler& scheduler = XPDFRenderScheduler::scheduler();
 
-            if (pdfImage == QImage() && m_perPagepdfZoomCache[pageNumber][zoomIndex].hasToBeProcessed)
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            const QRect tilePixels = tilePixelRect(pageNumber, level, column, row);
+
+            if (tilePixels.isEmpty())
             {
-                // Try to temporarily fallback on a valid image, for a fuzzy or downsampled preview.
-                // The actual result will be updated after the processing.
-                bool isCurrent = true;
-                while (zoomIndex < m_perPagepdfZoomCache[pageNumber].size()-1 && (m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedImage == QImage() || (m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedPageNumber != pageNumber && !isCurrent)))
-                {
-                    zoomIndex = zoomIndex+1;
-                    isCurrent = false;
-                }
-                while (zoomIndex > 0 && (m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedImage == QImage() || m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedPageNumber != pageNumber))
-                    zoomIndex = zoomIndex-1;
-                ratioObtained = m_perPagepdfZoomCache[pageNumber][zoomIndex].ratio;
+                continue;
             }
 
-            if (m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedImage == QImage() || m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedPageNumber != pageNumber)
+            const QRectF tileRect(QPointF(tilePixels.topLeft()) / ratio, QSizeF(tilePixels.size()) / ratio);
+            const QImage tile = scheduler.tile({mRendererId, pageNumber, level, column, row});
+
+            if (!tile.isNull())
             {
-                // No alternate image found. Build an alternate image in order to display some progress.
-                // Also make sure we fallback to the initial ratio request.
-                zoomIndex = initialZoomIndex;
-                qreal ratioDiff = m_perPagepdfZoomCache[pageNumber][zoomIndex].ratio;
-                pdfImage = QImage(bounds.width()*ratioDiff, bounds.height()*ratioDiff, QImage::Format_RGB888);
-                pdfImage.fill("white");
-
-                QPainter painter(&pdfImage);
-                QString const text = tr("Processing...");
-                QFont font = painter.font();
-                if (font.pixelSize() != -1)
-                    font.setPixelSize(ratioDiff*font.pixelSize());
-                else
-                    font.setPointSizeF(ratioDiff*font.pointSizeF());
-                painter.setFont(font);
-                QFontMetrics textMetric(font, &pdfImage);
-                QSize textSize = textMetric.size(0, text);
-                painter.drawText((bounds.width()*ratioDiff-textSize.width())/2, (bounds.height()*ratioDiff-textSize.height())/2, text);
-            } else {
-                pdfImage = m_perPagepdfZoomCache[pageNumber][zoomIndex].cachedImage;
+                p->drawImage(tileRect, tile);
+                continue;
             }
 
-            QTransform savedTransform = p->worldTransform();
+            // the item is refreshed by signalUpdateParent when the tile is available
+            scheduleTile(pageNumber, level, column, row, priority);
 
-            double const ratioDifferenceBetweenWorldAndImage = 1.0/m_perPagepdfZoomCache[pageNumber][zoomIndex].ratio;
-            // The 'pdfImage' is maybe rendered with a different quality than requested. We adjust the 'transform' to zoom it
-            // in or out of the required ratio.
-            QTransform newTransform = savedTransform.scale(ratioDifferenceBetweenWorldAndImage, ratioDifferenceBetweenWorldAndImage);
-            p->setWorldTransform(newTransform);
-            /* qDebug() << "drawImage size=" << p->viewport() << "bounds" << bounds <<
-                        "pdfImage" << pdfImage.size() << "savedTransform" << savedTransform.m11() <<
-                        "ratioDiff" << ratioDifferenceBetweenWorldAndImage << "zoomRequested" << zoomRequested <<
-                        "zoomIndex" << zoomIndex; */
-            p->drawImage(QPointF( mSliceX,  mSliceY), pdfImage);
+            if (!renderFallbackTiles(p, pageNumber, level, tileRect))
+            {
+                p->fillRect(tileRect, Qt::white);
+            }
+        }
+    }
 
-            p->setWorldTransform(savedTransform);
-        } else {
-            qreal xscale = p->worldTransform().m11();
-            qreal yscale = p->worldTransform().m22();
+    if (priority == BoardPriority)
+    {
+        for (int row = firstRow - 1; row <= lastRow + 1; ++row)
+        {
+            for (int column = firstColumn - 1; column <= lastColumn + 1; ++column)
+            {
+                const bool inside = row >= firstRow && row <= lastRow && column >= firstColumn && column <= lastColumn;
 
-            QImage *pdfImage = createPDFImageUncached(pageNumber, xscale, yscale, bounds);
-            QTransform savedTransform = p->worldTransform();
-            p->resetTransform();
-            //qDebug() << "drawImage size=" << p->viewport() << "bounds" << bounds << "pdfImage" << pdfImage->size() << "savedTransform" << savedTransform.m11();
-            p->drawImage(QPointF(savedTransform.dx() + mSliceX, savedTransform.dy() + mSliceY), *pdfImage);
-            p->setWorldTransform(savedTransform);
-            delete pdfImage;
+                if (!inside && row >= 0 && column >= 0
+                        && scheduler.tile({mRendererId, pageNumber, level, column, row}).isNull())
+                {
+                    scheduleTile(pageNumber, level, column, row, PrefetchPriority);
+                }
+            }
         }
     }
-    //qDebug() << "render leave";
 }
 
-QImage& XPDFRenderer::createPDFImageCached(int pageNumber, PdfZoomCacheData &cacheData)
+bool XPDFRenderer::scheduleTile(int pageNumber, int level, int column, int row, RenderPriority priority)
 {
-    if (isValid())
+    XPDFRenderScheduler::Job job;
+    job.key = {mRendererId, pageNumber, level, column, row};
+    job.fileName = mFileName;
+    job.dpi = dpiForRendering * tileRatio(level);
+    job.slice = tilePixelRect(pageNumber, level, column, row);
+    job.priority = priority;
+
+    if (job.slice.isEmpty())
     {
-        if (cacheData.requireUpdateImage(pageNumber) && !cacheData.hasToBeProcessed)
-        {
-            mSliceX = 0.;
-            mSliceY = 0.;
-
-            CacheThread::JobData jobData;
-            jobData.cacheData = &cacheData;
-            jobData.document = mDocument;
-            jobData.dpiForRendering = this->dpiForRendering;
-            jobData.pageNumber = pageNumber;
-            jobData.cacheData->hasToBeProcessed = true;
-            // Make sure we reset that image, because the data uses 'splash' buffer, which will be deallocated and
-            // reallocated when the job is started.
-            jobData.cacheData->cachedImage = QImage();
-            m_cacheThread.pushJob(jobData);
-
-            // Start the job multithreaded. The item will be refreshed when the signal 'finished' is emitted.
-            m_cacheThread.start();
-        }
-    } else {
-        cacheData.cachedImage = QImage();
+        return false;
     }
 
-    return cacheData.cachedImage;
+    return XPDFRenderScheduler::scheduler().schedule(job);
 }
 
-void XPDFRenderer::CacheThread::run()
+/**
+ * Draw the area of a missing tile with the tiles of another zoom level. Lower resolutions are preferred,
+ * as they are cheap to cover the area with. A level is only used if all its tiles for the area are available.
+ */
+bool XPDFRenderer::renderFallbackTiles(QPainter *p, int pageNumber, int level, const QRectF &tileRect)
 {
-    m_jobMutex.lock();
+    QList<int> fallbackLevels;
+
+    for (int fallbackLevel = level - 1; fallbackLevel >= XPDFRendererTiles::minLevel; --fallbackLevel)
+    {
+        fallbackLevels << fallbackLevel;
+    }
+
+    for (int fallbackLevel = level + 1; fallbackLevel <= qMin(level + 2, XPDFRendererTiles::maxLevel); ++fallbackLevel)
+    {
+        fallbackLevels << fallbackLevel;
+    }
+
+    const int tileSize = XPDFRendererTiles::tileSize;
+
+    for (int fallbackLevel : fallbackLevels)
+    {
+        const qreal ratio = tileRatio(fallbackLevel);
+        const QRect pixelRect = QRectF(tileRect.topLeft() * ratio, tileRect.size() * ratio).toAlignedRect();
+        QList<std::pair<QRectF, QImage>> tiles;
+        bool complete = true;
+
+        for (int row = pixelRect.top() / tileSize; complete && row <= pixelRect.bottom() / tileSize; ++row)
+        {
+            for (int column = pixelRect.left() / tileSize; complete && column <= pixelRect.right() / tileSize; ++column)
+            {
+                const QRect tilePixels = tilePixelRect(pageNumber, fallbackLevel, column, row);
+
+                if (tilePixels.isEmpty())
+                {
+                    continue;
+                }
+
+                const QImage tile = XPDFRenderScheduler::scheduler().tile({mRendererId, pageNumber, fallbackLevel, column, row});
+                complete = !tile.isNull();
+                tiles << std::make_pair(QRectF(QPointF(tilePixels.topLeft()) / ratio, QSizeF(tilePixels.size()) / ratio), tile);
+            }
+        }
 
-    CacheThread::JobData jobData = m_nextJob.first();
-    m_nextJob.pop_front();
-    /* qDebug() << "XPDFRenderer::CacheThread starting page" << jobData.pageNumber
-             << "ratio" << jobData.cacheData->ratio; */
+        if (complete && !tiles.isEmpty())
+        {
+            p->save();
+            p->setClipRect(tileRect, Qt::IntersectClip);
 
-    jobData.cacheData->prepareNewSplash(jobData.pageNumber, constants::paperColor);
-    jobData.cacheData->splash->startDoc(jobData.document);
+            for (const auto& tile : std::as_const(tiles))
+            {
+                p->drawImage(tile.first, tile.second);
+            }
 
-    m_jobMutex.unlock();
+            p->restore();
+            return true;
+        }
+    }
 
-    int rotation = 0; // in degrees (get it from the worldTransform if we want to support rotation)
-    bool useMediaBox = false;
-    bool crop = true;
-    bool printing = false;
+    return false;
+}
 
-    jobData.document->displayPage(jobData.cacheData->splash, jobData.pageNumber, jobData.dpiForRendering * jobData.cacheData->ratio,
-                                  jobData.dpiForRendering * jobData.cacheData->ratio,
-                           rotation, useMediaBox, crop, printing);
+QRect XPDFRenderer::tilePixelRect(int pageNumber, int level, int column, int row) const
+{
+    const int tileSize = XPDFRendererTiles::tileSize;
+    return QRect(column * tileSize, row * tileSize, tileSize, tileSize) & QRect(QPoint(0, 0), pagePixelSize(pageNumber, level));
+}
 
-    m_jobMutex.lock();
-    jobData.cacheData->splashBitmap = jobData.cacheData->splash->getBitmap();
-    // Note this uses the 'cacheData.splash->getBitmap()->getDataPtr()' as data buffer.
-    jobData.cacheData->cachedImage = QImage(jobData.cacheData->splashBitmap->getDataPtr(), jobData.cacheData->splashBitmap->getWidth(), jobData.cacheData->splashBitmap->getHeight(),
-                           jobData.cacheData->splashBitmap->getWidth() * 3 /* bytesPerLine, 24 bits for RGB888, = 3 bytes */,
-                           QImage::Format_RGB888);
+QSize XPDFRenderer::pagePixelSize(int pageNumber, int level) const
+{
+    const QSizeF size = pageSizeF(pageNumber) * tileRatio(level);
+    return QSize(qCeil(size.width()), qCeil(size.height()));
+}
 
-    /* qDebug() << "XPDFRenderer::CacheThread completed page" << jobData.pageNumber
-             << "ratio" << jobData.cacheData->ratio << "final size is" << jobData.cacheData->cachedImage.size(); */
+qreal XPDFRenderer::tileRatio(int level)
+{
+    return std::pow(2., level / 2.);
+}
 
-    jobData.cacheData->hasToBeProcessed = false;
-    m_jobMutex.unlock();
+int XPDFRenderer::tileLevel(qreal scale)
+{
+    // Choose a zoom which is superior or equivalent than the user choice (= no loss, upscaling).
+    // The tolerance avoids switching to the next level because of rounding errors.
+    const int level = qCeil(2. * std::log2(scale) - 0.05);
+    return qBound(XPDFRendererTiles::minLevel, level, XPDFRendererTiles::maxLevel);
 }
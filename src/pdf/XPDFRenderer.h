@@ -34,6 +34,7 @@
 #include <QThread>
 #include <QMutexLocker>
 #include "PDFRenderer.h"
+#include "XPDFRenderScheduler.h"
 #include <splash/SplashBitmap.h>
 
 #include "globals/UBGlobals.h"
@@ -46,16 +47,12 @@
 class PDFDoc;
 
 
-namespace XPDFRendererZoomFactor
+namespace XPDFRendererTiles
 {
-    const double zoomFactorStart = .25;
-    const double zoomFactorStepSquare = .25;
-    const double zoomFactorIterations = 7;
-}
-
-namespace XPDFThreadMaxTimeoutOnExit
-{
-    const double timeout_ms = 3000;
+    const int tileSize = 512; // pixels
+    // zoom levels advance in steps of sqrt(2), level 0 is the nominal resolution
+    const int minLevel = -4;
+    const int maxLevel = 8;
 }
 
 class XPDFRenderer : public PDFRenderer
@@ -66,14 +63,13 @@ class XPDFRenderer : public PDFRenderer
         XPDFRenderer(const QString &filename, bool importingFile = false);
         virtual ~XPDFRenderer();
 
-        void initPDFZoomData();
         virtual bool isValid() const override;
         virtual int pageCount() const override;
         virtual QSizeF pageSizeF(int pageNumber) const override;
         virtual int pageRotation(int pageNumber) const override;
         virtual QSizeF pointSizeF(int pageNumber) const override;
         virtual QString title() const override;
-        virtual void render(QPainter *p, int pageNumber, const bool cacheAllowed, const QRectF &bounds = QRectF()) override;
+        virtual void render(QPainter *p, int pageNumber, const bool cacheAllowed, const QRectF &bounds = QRectF(), RenderPriority priority = BoardPriority) override;
 
     signals:
         void signalUpdateParent();
@@ -81,76 +77,15 @@ class XPDFRenderer : public PDFRenderer
     private:
         void init();
 
-        struct PdfZoomCacheData {
-            PdfZoomCacheData() : splashBitmap(nullptr), cachedPageNumber(-1), splash(nullptr), ratio(1.0), hasToBeProcessed(false) {};
-            PdfZoomCacheData(double const a_ratio) : splashBitmap(nullptr), cachedPageNumber(-1), splash(nullptr), ratio(a_ratio), hasToBeProcessed(false) {};
-            ~PdfZoomCacheData() {};
-            SplashBitmap* splashBitmap;
-            //! Note: The 'cachedImage' uses a buffer from 'splash'. Make sure it is invalidated BEFORE 'splash' deallocation.
-            QImage cachedImage;
-            int cachedPageNumber;
-            SplashOutputDev* splash;
-            double ratio;
-            bool hasToBeProcessed;
-            QList<QObject *> updateListAfterProcessing;
-
-            bool requireUpdateImage(int const pageNumber) const {
-                return (pageNumber != cachedPageNumber) || (splash == nullptr);
-            }
-
-            void prepareNewSplash(int const pageNumber, SplashColor &paperColor)
-            {
-                if(splash != nullptr)
-                {
-                    cachedImage = QImage();
-                    delete splash;
-                }
-                splash = new SplashOutputDev(splashModeRGB8, 1, false, paperColor);
-                cachedPageNumber = pageNumber;
-            }
-
-            void cleanup()
-            {
-                if(splash != nullptr){
-                    cachedImage = QImage();
-                    delete splash;
-                    splash = nullptr;
-                }
-            }
-        };
-
-        //! Spawned when a pdf processing is required, when no matching image is found in cache.
-        class CacheThread : public QThread
-        {
-        public:
-            struct JobData {
-                PdfZoomCacheData* cacheData;
-                PDFDoc *document;
-                int pageNumber;
-                double dpiForRendering;
-            };
-
-            CacheThread() {}
-            ~CacheThread() {}
-            void pushJob(JobData &jobData) {               
-                QMutexLocker lock(&m_jobMutex);
-                m_nextJob.push_back(jobData);
-            }
-
-            virtual void run() override;
-            bool isJobPending() { QMutexLocker lock(&m_jobMutex); return m_nextJob.size() > 0; }
-            void cancelPending() { QMutexLocker lock(&m_jobMutex); m_nextJob.clear(); }
-        private:
-            QList<JobData> m_nextJob;
-            QMutex m_jobMutex;
-        };
-
-        CacheThread m_cacheThread;
-
-        QImage &createPDFImageCached(int pageNumber, PdfZoomCacheData &cacheData);
-        QImage* createPDFImageUncached(int pageNumber, qreal xscale, qreal yscale, const QRectF &bounds);
+        void renderTiles(QPainter *p, int pageNumber, const QRectF &bounds, RenderPriority priority);
+        bool scheduleTile(int pageNumber, int level, int column, int row, RenderPriority priority);
+        bool renderFallbackTiles(QPainter *p, int pageNumber, int level, const QRectF &tileRect);
+        QRect tilePixelRect(int pageNumber, int level, int column, int row) const;
+        QSize pagePixelSize(int pageNumber, int level) const;
+        static qreal tileRatio(int level);
+        static int tileLevel(qreal scale);
 
-        QMap<int, QVector<PdfZoomCacheData>> m_perPagepdfZoomCache;
+        QImage* createPDFImageUncached(int pageNumber, qreal xscale, qreal yscale, const QRectF &bounds);
 
         // Used when no cache allowed (e.g. rendering to a file).
         SplashBitmap* mpSplashBitmapUncached;
@@ -158,12 +93,12 @@ class XPDFRenderer : public PDFRenderer
         SplashOutputDev* mSplashUncached;
 
         PDFDoc *mDocument;
+        QString mFileName;
+        quint64 mRendererId;
         static QAtomicInt sInstancesCount;
+        static QAtomicInteger<quint64> sNextRendererId;
         qreal mSliceX;
         qreal mSliceY;
-
-private slots:
-        void OnThreadFinished();
 };
 
 #endif // XPDFRENDERER_H
@@ -1,8 +1,10 @@
 HEADERS      += src/pdf/GraphicsPDFItem.h \
                 src/pdf/PDFRenderer.h \
-                src/pdf/XPDFRenderer.h
+                src/pdf/XPDFRenderer.h \
+                src/pdf/XPDFRenderScheduler.h
                 
 SOURCES      += src/pdf/GraphicsPDFItem.cpp \
                 src/pdf/PDFRenderer.cpp \
-                src/pdf/XPDFRenderer.cpp
+                src/pdf/XPDFRenderer.cpp \
+                src/pdf/XPDFRenderScheduler.cpp
                           
@@ -31,6 +31,7 @@
 #define UBABSTRACTVIDEOENCODER_H_
 
 #include <QtCore>
+#include <QRegion>
 
 class UBAbstractVideoEncoder : public QObject
 {
@@ -52,6 +53,13 @@ class UBAbstractVideoEncoder : public QObject
 
         virtual void newPixmap(const QImage& pImage, long timestamp) = 0;
 
+        // the image only differs from the previous one in changedRegion
+        virtual void newPartialPixmap(const QImage& pImage, long timestamp, const QRegion& changedRegion)
+        {
+            Q_UNUSED(changedRegion);
+            newPixmap(pImage, timestamp);
+        }
+
         virtual void newChapter(const QString& pLabel, long timestamp);
 
         void setFramesPerSecond(int pFps)
@@ -82,6 +82,7 @@ UBPodcastController::UBPodcastController(QObject* pParent)
     , mVideoEncoder(0)
     , mInitialized(false)
     , mEmptyChapter(true)
+    , mDamageRegionEncoding(false)
     , mVideoFramesPerSecondAtStart(10)
     , mVideoFrameSizeAtStart(1024, 768)
     , mVideoBitsPerSecondAtStart(1700000)
@@ -379,6 +380,7 @@ void UBPodcastController::start()
             mVideoEncoder->setVideoFileName(videoFileName);
 
             mLatestCapture = QImage(mVideoFrameSizeAtStart, QImage::Format_RGB32); //0xffRRGGBB
+            mDamageRegionEncoding = UBSettings::settings()->podcastDamageRegionEncoding->get().toBool();
 
             mRecordStartTime = QTime::currentTime();
 
@@ -582,6 +584,7 @@ void UBPodcastController::processScenePaintEvent()
         return;
 
     QRectF repaintRect;
+    QRegion changedRegion;
 
     if (!mInitialized)
     {
@@ -597,9 +600,17 @@ void UBPodcastController::processScenePaintEvent()
     }
     else
     {
+        // the changed areas are tracked separately in video coordinates, so that the encoder
+        // only has to convert those, even if the repainted rect covers more
+        QTransform sceneToVideo = bv->viewportTransform() * mViewToVideoTransform;
+
         while(mSceneRepaintRectQueue.size() > 0)
         {
-            repaintRect = repaintRect.united(mSceneRepaintRectQueue.dequeue());
+            QRectF rect = mSceneRepaintRectQueue.dequeue();
+            repaintRect = repaintRect.united(rect);
+
+            if (!rect.isEmpty())
+                changedRegion += sceneToVideo.mapRect(rect.adjusted(-1, -1, 1, 1)).toAlignedRect();
         }
     }
 
@@ -630,7 +641,7 @@ void UBPodcastController::processScenePaintEvent()
 
         scene->setRenderingContext(UBGraphicsScene::Screen);
 
-        sendLatestPixmapToEncoder();
+        sendLatestPixmapToEncoder(changedRegion);
     }
 }
 
@@ -778,10 +789,19 @@ void UBPodcastController::encodingFinished(bool ok)
 }
 
 
-void UBPodcastController::sendLatestPixmapToEncoder()
+/**
+ * Send the capture to the encoder. If the changed region is known and damage region encoding is enabled,
+ * the encoder only converts that region and skips the frame if the pixels did not actually change.
+ */
+void UBPodcastController::sendLatestPixmapToEncoder(const QRegion& changedRegion)
 {
     if (mVideoEncoder)
-        mVideoEncoder->newPixmap(mLatestCapture, elapsedRecordingMs());
+    {
+        if (mDamageRegionEncoding && !changedRegion.isEmpty())
+            mVideoEncoder->newPartialPixmap(mLatestCapture, elapsedRecordingMs(), changedRegion);
+        else
+            mVideoEncoder->newPixmap(mLatestCapture, elapsedRecordingMs());
+    }
 
     mEmptyChapter = false;
 }
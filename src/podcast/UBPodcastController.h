@@ -128,7 +128,7 @@ class UBPodcastController : public QObject
 
         void setRecordingState(RecordingState pRecordingState);
 
-        void sendLatestPixmapToEncoder();
+        void sendLatestPixmapToEncoder(const QRegion& changedRegion = QRegion());
 
         long elapsedRecordingMs();
 
@@ -144,6 +144,7 @@ class UBPodcastController : public QObject
         bool mEmptyChapter;
 
         QImage mLatestCapture;
+        bool mDamageRegionEncoding;
 
         int mVideoFramesPerSecondAtStart;
         QSize mVideoFrameSizeAtStart;
@@ -550,70 +550,24 @@ bool UBFFmpegVideoEncoder::init()
 
 /**
  * This function should be called every time a new "screenshot" is ready.
- * The image is converted to the right format and sent to the encoder.
+ * The image is shared with the worker thread, which converts it to the right format
+ * and sends it to the encoder. If the worker falls behind, the image is dropped.
  */
 void UBFFmpegVideoEncoder::newPixmap(const QImage &pImage, long timestamp)
 {
-    if (!mVideoWorker->isRunning()) {
-        qDebug() << "Encoder worker thread not running. Queuing frame.";
-        mPendingFrames.enqueue({pImage, timestamp});
-    }
-
-    else {
-        // First send any queued frames, then the latest one
-        while (!mPendingFrames.isEmpty()) {
-            AVFrame* avFrame = convertImageFrame(mPendingFrames.dequeue());
-            if (avFrame)
-                mVideoWorker->queueVideoFrame(avFrame);
-        }
-
-        // note: if converting the frame turns out to be too slow to do here, it
-        // can always be done from the worker thread (in that case,
-        // the worker's queue would contain ImageFrames rather than AVFrames)
-
-        AVFrame* avFrame = convertImageFrame({pImage, timestamp});
-        if (avFrame)
-            mVideoWorker->queueVideoFrame(avFrame);
-
-        // signal the worker that frames are available
-        mVideoWorker->mWaitCondition.wakeAll();
-    }
+    if (mVideoWorker->queueImageFrame({pImage, timestamp, QRegion()}))
+        mVideoWorker->wakeUp();
 }
 
 /**
- * Convert a frame consisting of a QImage and timestamp to an AVFrame
- * with the right pixel format and PTS
+ * Same as newPixmap, for an image which only changed in the given region since the previous
+ * one. Only the changed region is converted, and the frame is not encoded if its pixels are
+ * identical to the previous frame: the next frame's PTS then extends the duration of the previous one.
  */
-AVFrame* UBFFmpegVideoEncoder::convertImageFrame(ImageFrame frame)
+void UBFFmpegVideoEncoder::newPartialPixmap(const QImage &pImage, long timestamp, const QRegion &changedRegion)
 {
-    AVFrame* avFrame = av_frame_alloc();
-
-    avFrame->format = mVideoCodecContext->pix_fmt;
-    avFrame->width = mVideoCodecContext->width;
-    avFrame->height = mVideoCodecContext->height;
-    avFrame->pts = mVideoTimebase * frame.timestamp / 1000;
-
-    const uchar * rgbImage = frame.image.bits();
-
-    const int in_linesize[1] = { static_cast<int>(frame.image.bytesPerLine()) };
-
-    // Allocate the output image
-    if (av_image_alloc(avFrame->data, avFrame->linesize, mVideoCodecContext->width,
-                       mVideoCodecContext->height, mVideoCodecContext->pix_fmt, 32) < 0)
-    {
-        qWarning() << "Couldn't allocate image";
-        return nullptr;
-    }
-
-    sws_scale(mSwsContext,
-              (const uint8_t* const*)&rgbImage,
-              in_linesize,
-              0,
-              mVideoCodecContext->height,
-              avFrame->data,
-              avFrame->linesize);
-
-    return avFrame;
+    if (mVideoWorker->queueImageFrame({pImage, timestamp, changedRegion}))
+        mVideoWorker->wakeUp();
 }
 
 void UBFFmpegVideoEncoder::onAudioAvailable(QByteArray data)
@@ -731,7 +685,7 @@ void UBFFmpegVideoEncoder::processAudio(QByteArray &data)
     }
 
     if (framesAdded)
-        mVideoWorker->mWaitCondition.wakeAll();
+        mVideoWorker->wakeUp();
 }
 
 void UBFFmpegVideoEncoder::finishEncoding()
@@ -774,15 +728,23 @@ void UBFFmpegVideoEncoder::finishEncoding()
 
 UBFFmpegVideoEncoderWorker::UBFFmpegVideoEncoderWorker(UBFFmpegVideoEncoder* controller)
     : mController(controller)
+    , mVideoFrame(nullptr)
+    , mDroppedFullImage(false)
+    , mVideoFrameComplete(false)
 {
     mStopRequested = false;
     mIsRunning = false;
+    mImageRingRead = 0;
+    mImageRingWrite = 0;
+    mDroppedImages = 0;
     mVideoPacket = av_packet_alloc();
     mAudioPacket = av_packet_alloc();
 }
 
 UBFFmpegVideoEncoderWorker::~UBFFmpegVideoEncoderWorker()
 {
+    releaseVideoFrame();
+
     if (mVideoPacket)
         av_packet_free(&mVideoPacket);
 
@@ -794,16 +756,78 @@ void UBFFmpegVideoEncoderWorker::stopEncoding()
 {
     qDebug() << "Video worker: stop requested";
     mStopRequested = true;
+    wakeUp();
+}
+
+/**
+ * Wake the worker up after queueing frames or requesting the stop. The mutex is taken, so that
+ * the wake-up cannot happen between the worker checking for pending frames and waiting.
+ */
+void UBFFmpegVideoEncoderWorker::wakeUp()
+{
+    mFrameQueueMutex.lock();
     mWaitCondition.wakeAll();
+    mFrameQueueMutex.unlock();
 }
 
-void UBFFmpegVideoEncoderWorker::queueVideoFrame(AVFrame* frame)
+/// Whether frames wait to be encoded, to be called with mFrameQueueMutex locked
+bool UBFFmpegVideoEncoderWorker::hasPendingFrames() const
 {
-    if (frame) {
-        mFrameQueueMutex.lock();
-        mImageQueue.enqueue(frame);
-        mFrameQueueMutex.unlock();
+    return mImageRingRead.load(std::memory_order_relaxed) != mImageRingWrite.load(std::memory_order_acquire)
+        || !mAudioQueue.isEmpty();
+}
+
+/**
+ * Hand a captured image over to the worker. Called from the GUI thread only.
+ *
+ * @return false if the image was dropped because the worker is lagging behind
+ */
+bool UBFFmpegVideoEncoderWorker::queueImageFrame(const UBFFmpegVideoEncoder::ImageFrame& frame)
+{
+    const unsigned int write = mImageRingWrite.load(std::memory_order_relaxed);
+
+    if (write - mImageRingRead.load(std::memory_order_acquire) == sImageRingSize) {
+        // the next queued image must also bring the changes of this one
+        if (frame.changedRegion.isEmpty())
+            mDroppedFullImage = true;
+        else
+            mDroppedRegion += frame.changedRegion;
+
+        ++mDroppedImages;
+        return false;
     }
+
+    UBFFmpegVideoEncoder::ImageFrame& queued = mImageRing[write % sImageRingSize];
+    queued = frame;
+
+    if (mDroppedFullImage)
+        queued.changedRegion = QRegion();
+    else if (!queued.changedRegion.isEmpty())
+        queued.changedRegion += mDroppedRegion;
+
+    mDroppedFullImage = false;
+    mDroppedRegion = QRegion();
+
+    mImageRingWrite.store(write + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool UBFFmpegVideoEncoderWorker::takeImageFrame(UBFFmpegVideoEncoder::ImageFrame& frame)
+{
+    const unsigned int read = mImageRingRead.load(std::memory_order_relaxed);
+
+    if (read == mImageRingWrite.load(std::memory_order_acquire))
+        return false;
+
+    // leave the slot empty, so that the GUI thread doesn't have to copy the capture
+    // the next time it paints into it
+    UBFFmpegVideoEncoder::ImageFrame& slot = mImageRing[read % sImageRingSize];
+    frame = slot;
+    slot.image = QImage();
+    mImageRingRead.store(read + 1, std::memory_order_release);
+
+    return true;
 }
 
 void UBFFmpegVideoEncoderWorker::queueAudioFrame(AVFrame* frame)
@@ -825,28 +849,192 @@ void UBFFmpegVideoEncoderWorker::runEncoding()
 
     while (!mStopRequested) {
         mFrameQueueMutex.lock();
-        mWaitCondition.wait(&mFrameQueueMutex);
 
-        while (!mImageQueue.isEmpty()) {
-            writeLatestVideoFrame();
+        while (!hasPendingFrames() && !mStopRequested)
+            mWaitCondition.wait(&mFrameQueueMutex);
+
+        mFrameQueueMutex.unlock();
+
+        encodePendingFrames();
+    }
+
+    // frames captured just before the stop request
+    encodePendingFrames();
+
+    if (mDroppedImages > 0)
+        qWarning() << "Video worker: dropped" << mDroppedImages << "frames while encoding";
+
+    emit encodingFinished();
+}
+
+void UBFFmpegVideoEncoderWorker::encodePendingFrames()
+{
+    UBFFmpegVideoEncoder::ImageFrame frame;
+
+    while (takeImageFrame(frame)) {
+        if (convertImageFrame(frame))
+            writeFrame(mVideoFrame, mVideoPacket, mController->mVideoStream, mController->mVideoCodecContext, mController->mOutputFormatContext);
+    }
+
+    mFrameQueueMutex.lock();
+
+    while (!mAudioQueue.isEmpty()) {
+        writeLatestAudioFrame();
+    }
+
+    mFrameQueueMutex.unlock();
+}
+
+/**
+ * Convert a frame consisting of a QImage and timestamp into mVideoFrame,
+ * with the right pixel format and PTS.
+ *
+ * @return false if there is nothing to encode, because of an error or because
+ * the pixels of a partial frame did not change
+ */
+bool UBFFmpegVideoEncoderWorker::convertImageFrame(const UBFFmpegVideoEncoder::ImageFrame& frame)
+{
+    AVCodecContext* c = mController->mVideoCodecContext;
+
+    if (!mVideoFrame) {
+        mVideoFrame = av_frame_alloc();
+        mVideoFrame->format = c->pix_fmt;
+        mVideoFrame->width = c->width;
+        mVideoFrame->height = c->height;
+
+#if LIBAVFORMAT_VERSION_MICRO < 100
+        int ret = av_image_alloc(mVideoFrame->data, mVideoFrame->linesize, c->width, c->height, c->pix_fmt, 32);
+#else
+        int ret = av_frame_get_buffer(mVideoFrame, 32);
+#endif
+        if (ret < 0) {
+            qWarning() << "Couldn't allocate image: " << avErrorToQString(ret);
+            av_frame_free(&mVideoFrame);
+            return false;
         }
+    }
+
+#if LIBAVFORMAT_VERSION_MICRO >= 100
+    // the encoder may still hold a reference to the previous frame, in which case a new buffer is used
+    int ret = av_frame_make_writable(mVideoFrame);
+    if (ret < 0) {
+        qWarning() << "Couldn't make image writable: " << avErrorToQString(ret);
+        return false;
+    }
+#endif
+
+    mVideoFrame->pts = mController->mVideoTimebase * frame.timestamp / 1000;
+
+    const QRect frameRect(0, 0, c->width, c->height);
+    const QRegion changedRegion = frame.changedRegion & frameRect;
+    qint64 changedArea = 0;
+
+    for (const QRect& rect : changedRegion)
+        changedArea += qint64(rect.width()) * rect.height();
+
+    // a large change is converted at once by swscale, which is faster
+    const bool partial = mVideoFrameComplete && !frame.changedRegion.isEmpty()
+            && changedArea < qint64(c->width) * c->height / 2
+            && c->pix_fmt == AV_PIX_FMT_YUV420P
+            && (frame.image.format() == QImage::Format_RGB32 || frame.image.format() == QImage::Format_ARGB32);
 
-        while (!mAudioQueue.isEmpty()) {
-            writeLatestAudioFrame();
+    if (partial) {
+        bool changed = false;
+
+        for (const QRect& rect : changedRegion)
+            changed |= convertImageRect(frame.image, rect);
+
+        return changed;
+    }
+
+    // constBits() avoids detaching the image from the capture of the GUI thread
+    const uchar * rgbImage = frame.image.constBits();
+
+    const int in_linesize[1] = { static_cast<int>(frame.image.bytesPerLine()) };
+
+    sws_scale(mController->mSwsContext,
+              (const uint8_t* const*)&rgbImage,
+              in_linesize,
+              0,
+              c->height,
+              mVideoFrame->data,
+              mVideoFrame->linesize);
+
+    mVideoFrameComplete = true;
+
+    return true;
+}
+
+/**
+ * Convert a rectangle of an RGB32 image into the YUV420P planes of mVideoFrame, using the
+ * same BT.601 limited range coefficients as swscale. The rectangle is extended to even
+ * coordinates, since each chroma sample covers 2x2 pixels.
+ *
+ * @return true if any of the converted samples differs from the one already in the frame
+ */
+bool UBFFmpegVideoEncoderWorker::convertImageRect(const QImage& image, const QRect& rect)
+{
+    const QRect bounds = QRect(QPoint(rect.left() & ~1, rect.top() & ~1),
+                               QPoint(rect.right() | 1, rect.bottom() | 1)) & image.rect();
+
+    uint8_t* const* planes = mVideoFrame->data;
+    const int* linesize = mVideoFrame->linesize;
+    bool changed = false;
+
+    auto store = [&changed](uint8_t& sample, int value) {
+        if (sample != value) {
+            sample = value;
+            changed = true;
         }
+    };
+
+    for (int y = bounds.top(); y <= bounds.bottom(); y += 2) {
+        const int y1 = qMin(y + 1, bounds.bottom());
+        const QRgb* line0 = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        const QRgb* line1 = reinterpret_cast<const QRgb*>(image.constScanLine(y1));
+        uint8_t* luma0 = planes[0] + y * linesize[0];
+        uint8_t* luma1 = planes[0] + y1 * linesize[0];
+        uint8_t* cb = planes[1] + (y / 2) * linesize[1];
+        uint8_t* cr = planes[2] + (y / 2) * linesize[2];
+
+        for (int x = bounds.left(); x <= bounds.right(); x += 2) {
+            const int x1 = qMin(x + 1, bounds.right());
+            const QRgb pixels[4] = { line0[x], line0[x1], line1[x], line1[x1] };
+            uint8_t* luma[4] = { luma0 + x, luma0 + x1, luma1 + x, luma1 + x1 };
+            int r = 0, g = 0, b = 0;
+
+            for (int i = 0; i < 4; ++i) {
+                const int pr = qRed(pixels[i]);
+                const int pg = qGreen(pixels[i]);
+                const int pb = qBlue(pixels[i]);
+
+                store(*luma[i], ((66 * pr + 129 * pg + 25 * pb + 128) >> 8) + 16);
+
+                r += pr;
+                g += pg;
+                b += pb;
+            }
 
-        mFrameQueueMutex.unlock();
+            r = (r + 2) >> 2;
+            g = (g + 2) >> 2;
+            b = (b + 2) >> 2;
+
+            store(cb[x / 2], ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            store(cr[x / 2], ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
     }
 
-    emit encodingFinished();
+    return changed;
 }
 
-void UBFFmpegVideoEncoderWorker::writeLatestVideoFrame()
+void UBFFmpegVideoEncoderWorker::releaseVideoFrame()
 {
-    AVFrame* frame = mImageQueue.dequeue();
-    writeFrame(frame, mVideoPacket, mController->mVideoStream, mController->mVideoCodecContext, mController->mOutputFormatContext);
-    av_freep(&frame->data[0]);
-    av_frame_free(&frame);
+    if (mVideoFrame) {
+#if LIBAVFORMAT_VERSION_MICRO < 100
+        av_freep(&mVideoFrame->data[0]);
+#endif
+        av_frame_free(&mVideoFrame);
+    }
 }
 
 void UBFFmpegVideoEncoderWorker::writeLatestAudioFrame()
@@ -67,6 +67,8 @@ class UBPodcastController;
  * images.
  *
  * A worker thread is used to encode and write the audio and video on-the-fly.
+ * Captured images are handed over to the worker as they are (QImage is implicitly
+ * shared), so that the colour conversion and scaling do not load the GUI thread.
  */
 
 class UBFFmpegVideoEncoder : public UBAbstractVideoEncoder
@@ -84,6 +86,7 @@ public:
     bool stop();
 
     void newPixmap(const QImage& pImage, long timestamp);
+    void newPartialPixmap(const QImage& pImage, long timestamp, const QRegion& changedRegion);
 
     QString videoFileExtension() const { return "mp4"; }
 
@@ -103,9 +106,9 @@ private:
     {
         QImage image;
         long timestamp; // unit: ms
+        QRegion changedRegion; // empty if the whole image must be converted
     };
 
-    AVFrame* convertImageFrame(ImageFrame frame);
     AVFrame* convertAudio(QByteArray data);
     void processAudio(QByteArray& data);
     bool init();
@@ -124,7 +127,7 @@ private:
     // Video
     // ------------------------------------------
     AVCodecContext* mVideoCodecContext;
-    QQueue<ImageFrame> mPendingFrames;
+    /// Only used by the worker thread once the encoding is started
     struct SwsContext * mSwsContext;
 
     int mVideoTimebase;
@@ -158,8 +161,9 @@ public:
 
     bool isRunning() { return mIsRunning; }
 
-    void queueVideoFrame(AVFrame* frame);
+    bool queueImageFrame(const UBFFmpegVideoEncoder::ImageFrame& frame);
     void queueAudioFrame(AVFrame* frame);
+    void wakeUp();
 
 public slots:
     void runEncoding();
@@ -170,7 +174,12 @@ signals:
     void error(QString message);
 
 private:
-    void writeLatestVideoFrame();
+    bool takeImageFrame(UBFFmpegVideoEncoder::ImageFrame& frame);
+    bool hasPendingFrames() const;
+    void encodePendingFrames();
+    bool convertImageFrame(const UBFFmpegVideoEncoder::ImageFrame& frame);
+    bool convertImageRect(const QImage& image, const QRect& rect);
+    void releaseVideoFrame();
     void writeLatestAudioFrame();
 
     UBFFmpegVideoEncoder* mController;
@@ -180,7 +189,23 @@ private:
     std::atomic<bool> mStopRequested;
     std::atomic<bool> mIsRunning;
 
-    QQueue<AVFrame*> mImageQueue;
+    /// Captured images waiting for the worker. The ring has a single producer (the GUI thread)
+    /// and a single consumer (the worker); when it is full, new images are dropped.
+    static const unsigned int sImageRingSize = 8;
+    UBFFmpegVideoEncoder::ImageFrame mImageRing[sImageRingSize];
+    std::atomic<unsigned int> mImageRingRead;
+    std::atomic<unsigned int> mImageRingWrite;
+    std::atomic<int> mDroppedImages;
+
+    /// Changes of the dropped images, carried into the next queued image (GUI thread only)
+    QRegion mDroppedRegion;
+    bool mDroppedFullImage;
+
+    /// Converted image, reused for every video frame
+    AVFrame* mVideoFrame;
+    /// Whether mVideoFrame holds a complete image, which partial frames can be applied to
+    bool mVideoFrameComplete;
+
     QQueue<AVFrame*> mAudioQueue;
 
     QMutex mFrameQueueMutex;
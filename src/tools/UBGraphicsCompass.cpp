@@ -354,7 +354,7 @@ void UBGraphicsCompass::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
             if (scene()->isSnapping())
             {
-                qreal step = UBSettings::settings()->rotationAngleStep->get().toReal();
+                qreal step = UBSettings::settings()->rotationAngleStep->value();
                 newAngle = qRound(newAngle / step) * step;
             }
 
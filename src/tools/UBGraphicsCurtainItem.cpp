@@ -89,7 +89,7 @@ QVariant UBGraphicsCurtainItem::itemChange(GraphicsItemChange change, const QVar
 void UBGraphicsCurtainItem::setUuid(const QUuid &pUuid)
 {
     UBItem::setUuid(pUuid);
-    setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid)); //store item uuid inside the QGraphicsItem to fast operations with Items on the scene
+    UBCoreGraphicsScene::setItemUuid(this, pUuid);
 }
 
 void UBGraphicsCurtainItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -242,7 +242,7 @@ void UBGraphicsProtractor::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
         if (scene()->isSnapping())
         {
-            qreal step = UBSettings::settings()->rotationAngleStep->get().toReal();
+            qreal step = UBSettings::settings()->rotationAngleStep->value();
             mStartAngle = qRound(mStartAngle / step) * step;
         }
 
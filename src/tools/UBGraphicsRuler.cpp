@@ -457,7 +457,7 @@ void UBGraphicsRuler::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
             if (scene()->isSnapping())
             {
-                qreal step = UBSettings::settings()->rotationAngleStep->get().toReal();
+                qreal step = UBSettings::settings()->rotationAngleStep->value();
                 newAngle = qRound(newAngle / step) * step;
             }
 
@@ -884,7 +884,7 @@ void UBGraphicsTriangle::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
             if (scene()->isSnapping())
             {
-                qreal step = UBSettings::settings()->rotationAngleStep->get().toReal();
+                qreal step = UBSettings::settings()->rotationAngleStep->value();
                 newAngle = qRound(newAngle / step) * step;
             }
 